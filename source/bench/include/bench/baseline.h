@@ -0,0 +1,153 @@
+#ifndef _BENCH_BASELINE_H_
+#define _BENCH_BASELINE_H_
+
+/*!
+ * @file baseline.h
+ * @brief Reading a saved benchmark run back, and comparing a new run against it.
+ *
+ * A baseline is the JSON written by `write_json`. A measurement regresses when its median
+ * is slower than the baseline's by more than the threshold, and the difference is also
+ * larger than the noise of both runs, estimated from their MADs. Without the second
+ * condition, a noisy operation would fail the gate on a busy machine.
+ */
+
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <istream>
+#include <iterator>
+#include <map>
+#include <ostream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "harness.h"
+
+namespace bench {
+
+    /*!
+     * Reads the JSON written by `write_json`: an array of flat objects whose values are
+     * strings or numbers. Unknown keys are ignored, so baselines from older versions still load.
+     * @return false if the input is not such an array.
+     */
+    inline bool read_json( std::istream & is, std::vector< result > & results ) {
+        std::string text{ std::istreambuf_iterator< char >( is ), std::istreambuf_iterator< char >() };
+        size_t pos = text.find( '[' );
+        if ( pos == std::string::npos )
+            return false;
+        auto skip = [&]() { while ( pos < text.size() and std::isspace( static_cast< unsigned char >( text[pos] ) ) ) ++pos; };
+        auto read_string = [&]( std::string & out ) {
+            skip();
+            if ( pos >= text.size() or text[pos] != '"' )
+                return false;
+            size_t end = text.find( '"', ++pos );
+            if ( end == std::string::npos )
+                return false;
+            out = text.substr( pos, end - pos );
+            pos = end + 1;
+            return true;
+        };
+        ++pos;
+        for ( ;; ) {
+            skip();
+            if ( pos < text.size() and text[pos] == ']' )
+                return true;
+            if ( pos >= text.size() or text[pos] != '{' )
+                return false;
+            ++pos;
+            result r{};
+            r.events_per_op.fill( -1 );
+            for ( ;; ) {
+                std::string key, str;
+                skip();
+                if ( text[pos] == '}' ) { ++pos; break; }
+                if ( not read_string( key ) )
+                    return false;
+                skip();
+                if ( pos >= text.size() or text[pos++] != ':' )
+                    return false;
+                skip();
+                double num{0};
+                if ( text[pos] == '"' ) {
+                    if ( not read_string( str ) )
+                        return false;
+                }
+                else {
+                    char * end{ nullptr };
+                    num = std::strtod( text.c_str() + pos, &end );
+                    if ( end == text.c_str() + pos )
+                        return false;
+                    pos = static_cast< size_t >( end - text.c_str() );
+                }
+                if ( key == "lib" ) r.lib = str;
+                else if ( key == "op" ) r.op = str;
+                else if ( key == "n" ) r.n = static_cast< size_t >( num );
+                else if ( key == "ops" ) r.ops = static_cast< size_t >( num );
+                else if ( key == "reps" ) r.reps = static_cast< size_t >( num );
+                else if ( key == "outliers" ) r.outliers = static_cast< size_t >( num );
+                else if ( key == "ns_per_op" ) r.ns_per_op = num;
+                else if ( key == "mad_ns" ) r.mad_ns = num;
+                else if ( key == "allocs_per_op" ) r.allocs_per_op = num;
+                else if ( key == "bytes_per_op" ) r.bytes_per_op = num;
+                for ( int i{0}; i < n_counters; ++i )
+                    if ( key == std::string{ to_string( static_cast< counter >( i ) ) } + "_per_op" )
+                        r.events_per_op[i] = num;
+                skip();
+                if ( pos < text.size() and text[pos] == ',' )
+                    ++pos;
+            }
+            results.push_back( r );
+            skip();
+            if ( pos < text.size() and text[pos] == ',' )
+                ++pos;
+        }
+    }
+
+    /// How a measurement compares with its baseline.
+    struct comparison {
+        result base;      //!< The baseline measurement.
+        result current;   //!< The new measurement.
+        double ratio;     //!< Current median over baseline median.
+        double z;         //!< Difference of the medians, in units of their combined noise.
+        bool regressed;   //!< Slower by more than the threshold, and by more than the noise.
+    };
+
+    /*!
+     * Compares every measurement of `current` that has a baseline with the same lib, op and n.
+     * @param threshold Relative slowdown tolerated, e.g. 0.10 for 10%.
+     * @param min_z How many noise units the slowdown must also exceed to count.
+     */
+    inline std::vector< comparison > compare( const std::vector< result > & baseline, const std::vector< result > & current,
+                                              double threshold, double min_z = 3 ) {
+        std::map< std::tuple< std::string, std::string, size_t >, result > base;
+        for ( const auto & r : baseline )
+            base[ std::make_tuple( r.lib, r.op, r.n ) ] = r;
+        std::vector< comparison > out;
+        for ( const auto & r : current ) {
+            auto it = base.find( std::make_tuple( r.lib, r.op, r.n ) );
+            if ( it == base.end() or it->second.ns_per_op <= 0 )
+                continue;
+            comparison c;
+            c.base = it->second;
+            c.current = r;
+            c.ratio = r.ns_per_op / c.base.ns_per_op;
+            // 1.4826 MAD estimates the standard deviation of normally distributed times.
+            double noise = 1.4826 * std::sqrt( r.mad_ns * r.mad_ns + c.base.mad_ns * c.base.mad_ns );
+            double diff = r.ns_per_op - c.base.ns_per_op;
+            c.z = noise > 0 ? diff / noise : ( diff > 0 ? HUGE_VAL : 0 );
+            c.regressed = c.ratio > 1 + threshold and c.z > min_z;
+            out.push_back( c );
+        }
+        return out;
+    }
+
+    /// Writes one line per comparison, marking the regressions.
+    inline void write_comparison( std::ostream & os, const std::vector< comparison > & cmp ) {
+        for ( const auto & c : cmp )
+            os << ( c.regressed ? "REGRESSED " : "ok        " ) << c.current.lib << ' ' << c.current.op
+               << " n=" << c.current.n << ": " << c.base.ns_per_op << " -> " << c.current.ns_per_op
+               << " ns/op (x" << c.ratio << ", z = " << c.z << ")\n";
+    }
+}
+#endif
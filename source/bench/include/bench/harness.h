@@ -0,0 +1,191 @@
+#ifndef _BENCH_HARNESS_H_
+#define _BENCH_HARNESS_H_
+
+/*!
+ * @file harness.h
+ * @brief Small microbenchmark harness: timing, allocation counting and reporting.
+ *
+ * The allocation counters are bumped by the replacement `operator new` that
+ * the benchmark driver defines, so every allocation made by the code under
+ * measurement is seen, no matter which container made it. Hardware events
+ * (cycles, cache and TLB misses, ...) are counted too, when asked for and
+ * available; see perf_counters.h.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "perf_counters.h"
+
+namespace bench {
+
+    /// Global allocation counters, updated by the driver's `operator new`/`operator delete`.
+    struct alloc_counters {
+        static std::atomic< size_t > allocs; //!< Calls to operator new.
+        static std::atomic< size_t > frees;  //!< Calls to operator delete with a non null pointer.
+        static std::atomic< size_t > bytes;  //!< Bytes requested from operator new.
+    };
+
+    /// One measurement: a single operation on a single container at a single size.
+    struct result {
+        std::string lib;      //!< Which container: "sc", "std" or "vector".
+        std::string op;       //!< Which operation.
+        size_t n;             //!< Number of elements in the fixture.
+        size_t ops;           //!< How many unit operations one run performs.
+        size_t reps;          //!< How many runs were timed.
+        double ns_per_op;     //!< Median time of a run, divided by `ops`.
+        double mad_ns;        //!< Median absolute deviation of the run times, divided by `ops`.
+        size_t outliers;      //!< Runs rejected as outliers, not counted in `reps`.
+        double allocs_per_op; //!< Allocations of a run, divided by `ops`.
+        double bytes_per_op;  //!< Bytes allocated in a run, divided by `ops`.
+        counts events_per_op; //!< Median count of each hardware event in a run, divided by `ops`; -1 if not counted.
+
+        /// Tells whether any hardware event was counted.
+        bool has_events( void ) const {
+            for ( double e : events_per_op )
+                if ( e >= 0 )
+                    return true;
+            return false;
+        }
+    };
+
+    /// Median of `v`, which is reordered.
+    inline double median( std::vector< double > & v ) {
+        std::sort( v.begin(), v.end() );
+        size_t m = v.size() / 2;
+        return v.size() % 2 ? v[m] : ( v[m - 1] + v[m] ) / 2;
+    }
+
+    /// Median absolute deviation of `v` around `med`.
+    inline double mad( const std::vector< double > & v, double med ) {
+        std::vector< double > dev;
+        for ( double x : v )
+            dev.push_back( x < med ? med - x : x - med );
+        return dev.empty() ? 0 : median( dev );
+    }
+
+    /*!
+     * Times `run` a few times and reports the median.
+     * `setup` is called before every run to rebuild the fixture, and is not timed.
+     * Runs slower than the median by more than 5 MADs, usually preempted ones, are rejected
+     * before the median and MAD are computed again.
+     *
+     * @param ops Number of unit operations a single run performs, used to normalize the result.
+     * @param min_ns Keeps repeating the run until this much time has been measured, ...
+     * @param max_reps ... or this many runs have been timed.
+     * @param warmup_ns Runs that long, untimed, before measuring, to warm caches, the branch
+     *        predictors and the allocator, and to let the CPU frequency settle.
+     * @param events If not null, counts hardware events around every timed run.
+     */
+    inline result measure( const std::function< void() > & setup, const std::function< void() > & run,
+                           size_t ops, double min_ns, size_t max_reps, double warmup_ns = 0,
+                           perf_counters * events = nullptr )
+    {
+        using clock = std::chrono::steady_clock;
+        auto warm_end = clock::now() + std::chrono::duration_cast< clock::duration >(
+                                           std::chrono::duration< double, std::nano >( warmup_ns ) );
+        for ( size_t i{0}; i < max_reps and clock::now() < warm_end; ++i ) {
+            setup();
+            run();
+        }
+        std::vector< double > samples;
+        std::vector< double > event_samples[ n_counters ];
+        double total{0};
+        size_t allocs{0}, bytes{0};
+        while ( samples.size() < max_reps and ( samples.empty() or total < min_ns ) ) {
+            setup();
+            size_t a0 = alloc_counters::allocs.load( std::memory_order_relaxed );
+            size_t b0 = alloc_counters::bytes.load( std::memory_order_relaxed );
+            if ( events != nullptr )
+                events->start();
+            auto t0 = clock::now();
+            run();
+            auto t1 = clock::now();
+            if ( events != nullptr ) {
+                counts c = events->stop();
+                for ( int i{0}; i < n_counters; ++i )
+                    if ( c[i] >= 0 )
+                        event_samples[i].push_back( c[i] );
+            }
+            allocs = alloc_counters::allocs.load( std::memory_order_relaxed ) - a0;
+            bytes = alloc_counters::bytes.load( std::memory_order_relaxed ) - b0;
+            double ns = std::chrono::duration< double, std::nano >( t1 - t0 ).count();
+            samples.push_back( ns );
+            total += ns;
+        }
+        double med = median( samples );
+        double dev = mad( samples, med );
+        size_t n_samples = samples.size();
+        samples.erase( std::remove_if( samples.begin(), samples.end(),
+                                       [=]( double x ) { return x > med + 5 * dev; } ), samples.end() );
+        result r;
+        r.n = 0;
+        r.ops = std::max< size_t >( ops, 1 );
+        r.reps = samples.size();
+        r.outliers = n_samples - samples.size();
+        med = median( samples );
+        r.ns_per_op = med / r.ops;
+        r.mad_ns = mad( samples, med ) / r.ops;
+        r.allocs_per_op = static_cast< double >( allocs ) / r.ops;
+        r.bytes_per_op = static_cast< double >( bytes ) / r.ops;
+        for ( int i{0}; i < n_counters; ++i )
+            r.events_per_op[i] = event_samples[i].empty() ? -1 : median( event_samples[i] ) / r.ops;
+        return r;
+    }
+
+    /// Writes results as CSV, one line per measurement.
+    /// The hardware event columns are only written if some event was counted; those not counted are left empty.
+    inline void write_csv( std::ostream & os, const std::vector< result > & results ) {
+        bool events = std::any_of( results.begin(), results.end(), []( const result & r ) { return r.has_events(); } );
+        os << "lib,op,n,ops,reps,outliers,ns_per_op,mad_ns,allocs_per_op,bytes_per_op";
+        for ( int i{0}; events and i < n_counters; ++i )
+            os << ',' << to_string( static_cast< counter >( i ) ) << "_per_op";
+        os << '\n';
+        for ( const auto & r : results ) {
+            os << r.lib << ',' << r.op << ',' << r.n << ',' << r.ops << ',' << r.reps << ',' << r.outliers << ','
+               << r.ns_per_op << ',' << r.mad_ns << ',' << r.allocs_per_op << ',' << r.bytes_per_op;
+            for ( int i{0}; events and i < n_counters; ++i ) {
+                os << ',';
+                if ( r.events_per_op[i] >= 0 )
+                    os << r.events_per_op[i];
+            }
+            os << '\n';
+        }
+    }
+
+    /// Writes results as a JSON array of objects.
+    inline void write_json( std::ostream & os, const std::vector< result > & results ) {
+        os << "[\n";
+        for ( size_t i{0}; i < results.size(); ++i ) {
+            const auto & r = results[i];
+            os << "  { \"lib\": \"" << r.lib << "\", \"op\": \"" << r.op << "\", \"n\": " << r.n
+               << ", \"ops\": " << r.ops << ", \"reps\": " << r.reps << ", \"outliers\": " << r.outliers
+               << ", \"ns_per_op\": " << r.ns_per_op << ", \"mad_ns\": " << r.mad_ns
+               << ", \"allocs_per_op\": " << r.allocs_per_op
+               << ", \"bytes_per_op\": " << r.bytes_per_op;
+            for ( int e{0}; e < n_counters; ++e )
+                if ( r.events_per_op[e] >= 0 )
+                    os << ", \"" << to_string( static_cast< counter >( e ) ) << "_per_op\": " << r.events_per_op[e];
+            os << " }" << ( i + 1 < results.size() ? "," : "" ) << '\n';
+        }
+        os << "]\n";
+    }
+
+    /// Keeps the optimizer from discarding a value that is computed only to be measured.
+    template < typename T >
+    inline void do_not_optimize( const T & value ) {
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile( "" : : "r,m"( value ) : "memory" );
+#else
+        static volatile const T * sink;
+        sink = &value;
+#endif
+    }
+}
+#endif
@@ -0,0 +1,130 @@
+#ifndef _BENCH_PERF_COUNTERS_H_
+#define _BENCH_PERF_COUNTERS_H_
+
+/*!
+ * @file perf_counters.h
+ * @brief Hardware performance counters around the timed runs, through `perf_event_open`.
+ *
+ * Every event is opened on its own, so a machine that lacks one of them (a VM without a
+ * PMU, an older CPU, a restrictive `perf_event_paranoid`) still gets the others. When none
+ * can be opened, or off Linux, `available()` is false and the harness only times the runs.
+ * Counts are scaled by the time each event was actually scheduled, in case the kernel had
+ * to multiplex more events than the CPU has counters.
+ */
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__linux__)
+#   include <linux/perf_event.h>
+#   include <sys/ioctl.h>
+#   include <sys/syscall.h>
+#   include <unistd.h>
+#endif
+
+namespace bench {
+
+    /// Events counted around each timed run.
+    enum class counter : int {
+        CYCLES, INSTRUCTIONS, L1D_MISSES, LLC_MISSES, DTLB_MISSES, BRANCH_MISSES,
+        COUNT_ //!< Number of events, not an event.
+    };
+    constexpr int n_counters = static_cast< int >( counter::COUNT_ );
+
+    /// Name of an event, as used in the CSV and JSON columns.
+    inline const char * to_string( counter c ) {
+        static const char * const names[] = {
+            "cycles", "instructions", "l1d_misses", "llc_misses", "dtlb_misses", "branch_misses" };
+        return names[ static_cast< int >( c ) ];
+    }
+
+    /// Counts of every event; -1 for the events that could not be counted.
+    using counts = std::array< double, n_counters >;
+
+    /// The counters of the calling thread, user space only.
+    class perf_counters {
+        public:
+            perf_counters() {
+                m_fd.fill( -1 );
+#if defined(__linux__)
+                const std::uint32_t hw = PERF_TYPE_HARDWARE, cache = PERF_TYPE_HW_CACHE;
+                const std::uint64_t read_miss = ( PERF_COUNT_HW_CACHE_OP_READ << 8 ) | ( PERF_COUNT_HW_CACHE_RESULT_MISS << 16 );
+                open( counter::CYCLES, hw, PERF_COUNT_HW_CPU_CYCLES );
+                open( counter::INSTRUCTIONS, hw, PERF_COUNT_HW_INSTRUCTIONS );
+                open( counter::L1D_MISSES, cache, PERF_COUNT_HW_CACHE_L1D | read_miss );
+                open( counter::LLC_MISSES, hw, PERF_COUNT_HW_CACHE_MISSES );
+                open( counter::DTLB_MISSES, cache, PERF_COUNT_HW_CACHE_DTLB | read_miss );
+                open( counter::BRANCH_MISSES, hw, PERF_COUNT_HW_BRANCH_MISSES );
+#endif
+            }
+            ~perf_counters() {
+#if defined(__linux__)
+                for ( int fd : m_fd )
+                    if ( fd >= 0 )
+                        close( fd );
+#endif
+            }
+            perf_counters( const perf_counters & ) = delete;
+            perf_counters & operator=( const perf_counters & ) = delete;
+
+            /// Tells whether at least one event is counted.
+            bool available( void ) const {
+                for ( int fd : m_fd )
+                    if ( fd >= 0 )
+                        return true;
+                return false;
+            }
+            /// Tells whether a given event is counted.
+            bool has( counter c ) const { return m_fd[ static_cast< int >( c ) ] >= 0; }
+
+            /// Zeroes and starts every counter.
+            void start( void ) {
+#if defined(__linux__)
+                for ( int fd : m_fd )
+                    if ( fd >= 0 )
+                        ioctl( fd, PERF_EVENT_IOC_RESET, 0 );
+                for ( int fd : m_fd )
+                    if ( fd >= 0 )
+                        ioctl( fd, PERF_EVENT_IOC_ENABLE, 0 );
+#endif
+            }
+            /// Stops every counter and returns what they counted since `start()`.
+            counts stop( void ) {
+                counts out;
+                out.fill( -1 );
+#if defined(__linux__)
+                for ( int fd : m_fd )
+                    if ( fd >= 0 )
+                        ioctl( fd, PERF_EVENT_IOC_DISABLE, 0 );
+                for ( int i{0}; i < n_counters; ++i ) {
+                    std::uint64_t v[3]; // Value, time enabled, time running.
+                    if ( m_fd[i] < 0 or read( m_fd[i], v, sizeof( v ) ) != static_cast< ssize_t >( sizeof( v ) ) )
+                        continue;
+                    out[i] = v[2] == 0 ? 0 : static_cast< double >( v[0] ) * v[1] / v[2];
+                }
+#endif
+                return out;
+            }
+
+        private:
+            std::array< int, n_counters > m_fd;
+
+#if defined(__linux__)
+            void open( counter c, std::uint32_t type, std::uint64_t config ) {
+                perf_event_attr attr;
+                std::memset( &attr, 0, sizeof( attr ) );
+                attr.size = sizeof( attr );
+                attr.type = type;
+                attr.config = config;
+                attr.disabled = 1;
+                attr.exclude_kernel = 1;
+                attr.exclude_hv = 1;
+                attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+                long fd = syscall( SYS_perf_event_open, &attr, 0, -1, -1, 0 );
+                m_fd[ static_cast< int >( c ) ] = static_cast< int >( fd );
+            }
+#endif
+    };
+}
+#endif
@@ -0,0 +1,496 @@
+/*!
+ * @file main.cpp
+ * @brief Microbenchmarks comparing `sc::list`, `sc::small_list` and `sc::persistent_list` against
+ *        `std::list` and `std::vector`.
+ *
+ * Each operation is written once, as a template over the container type, the
+ * same way the unit tests switch between `sc` and `std` through `which_lib`.
+ * The operations a container does not offer as a member (e.g. `push_front` on
+ * a vector) go through `adapter<C>`, which maps them to the closest idiom.
+ *
+ * `sc::persistent_list` cannot change its elements in place, so it only runs
+ * `push_front`, `pop_front`, `traverse` and `copy`; for it, `copy` is a snapshot.
+ *
+ * Usage: list_bench [--lib=sc,small,persistent,std,vector] [--op=push_back,sort,...]
+ *                   [--sizes=10,1000 | --max-size=N] [--budget-ms=N]
+ *                   [--min-time-ms=N] [--max-reps=N] [--warmup-ms=N] [--pin=cpu]
+ *                   [--counters] [--format=csv|json] [--out=file]
+ *                   [--save-baseline=file] [--baseline=file [--threshold=percent]]
+ *
+ * With --save-baseline, the results are also saved as JSON, to be compared against by later
+ * runs given --baseline. Those exit with status 2 when any measurement regressed by more
+ * than the threshold (10% by default) and by more than its noise.
+ *
+ * Times are normalized per element touched by the operation: per push, pop,
+ * insert or erase, and per element of the container for the bulk operations.
+ * With --counters, so are the hardware events counted around each run (cycles,
+ * instructions, L1d, LLC and dTLB misses, branch misses), when the machine lets
+ * them be counted.
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <list>
+#include <new>
+#include <numeric>
+#include <optional>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#if defined(__linux__)
+#   include <sched.h>   // sched_setaffinity
+#endif
+
+#include "bench/baseline.h"
+#include "bench/harness.h"
+#include "../include/list.h"
+#include "../include/small_list.h"
+#include "../include/persistent_list.h"
+
+//=== Allocation accounting.
+std::atomic< size_t > bench::alloc_counters::allocs{0};
+std::atomic< size_t > bench::alloc_counters::frees{0};
+std::atomic< size_t > bench::alloc_counters::bytes{0};
+
+// Every replaceable form of new and delete goes through these two, so that each
+// pointer is freed by the same malloc family that allocated it.
+namespace {
+    void * counted_alloc( size_t size, size_t align ) noexcept {
+        bench::alloc_counters::allocs.fetch_add( 1, std::memory_order_relaxed );
+        bench::alloc_counters::bytes.fetch_add( size, std::memory_order_relaxed );
+        if ( size == 0 )
+            size = 1;
+        if ( align <= alignof( std::max_align_t ) )
+            return std::malloc( size );
+        return std::aligned_alloc( align, ( size + align - 1 ) / align * align ); // Size must be a multiple of align.
+    }
+    void counted_free( void * p ) noexcept {
+        if ( p != nullptr )
+            bench::alloc_counters::frees.fetch_add( 1, std::memory_order_relaxed );
+        std::free( p );
+    }
+    void * counted_new( size_t size, size_t align ) {
+        if ( void * p = counted_alloc( size, align ) )
+            return p;
+        throw std::bad_alloc{};
+    }
+} // namespace
+
+void * operator new( size_t size ) { return counted_new( size, 0 ); }
+void * operator new[]( size_t size ) { return counted_new( size, 0 ); }
+void * operator new( size_t size, std::align_val_t al ) { return counted_new( size, static_cast< size_t >( al ) ); }
+void * operator new[]( size_t size, std::align_val_t al ) { return counted_new( size, static_cast< size_t >( al ) ); }
+void * operator new( size_t size, const std::nothrow_t & ) noexcept { return counted_alloc( size, 0 ); }
+void * operator new[]( size_t size, const std::nothrow_t & ) noexcept { return counted_alloc( size, 0 ); }
+void * operator new( size_t size, std::align_val_t al, const std::nothrow_t & ) noexcept { return counted_alloc( size, static_cast< size_t >( al ) ); }
+void * operator new[]( size_t size, std::align_val_t al, const std::nothrow_t & ) noexcept { return counted_alloc( size, static_cast< size_t >( al ) ); }
+
+void operator delete( void * p ) noexcept { counted_free( p ); }
+void operator delete[]( void * p ) noexcept { counted_free( p ); }
+void operator delete( void * p, size_t ) noexcept { counted_free( p ); }
+void operator delete[]( void * p, size_t ) noexcept { counted_free( p ); }
+void operator delete( void * p, std::align_val_t ) noexcept { counted_free( p ); }
+void operator delete[]( void * p, std::align_val_t ) noexcept { counted_free( p ); }
+void operator delete( void * p, size_t, std::align_val_t ) noexcept { counted_free( p ); }
+void operator delete[]( void * p, size_t, std::align_val_t ) noexcept { counted_free( p ); }
+void operator delete( void * p, const std::nothrow_t & ) noexcept { counted_free( p ); }
+void operator delete[]( void * p, const std::nothrow_t & ) noexcept { counted_free( p ); }
+void operator delete( void * p, std::align_val_t, const std::nothrow_t & ) noexcept { counted_free( p ); }
+void operator delete[]( void * p, std::align_val_t, const std::nothrow_t & ) noexcept { counted_free( p ); }
+
+namespace {
+
+    //=== Containers under measurement.
+
+    /// Whether C has the search and reduction members of `sc::list` (`contains`, `count`, `accumulate`).
+    template < typename C, typename = void >
+    struct has_scans : std::false_type {};
+    template < typename C >
+    struct has_scans< C, std::void_t< decltype( std::declval< const C & >().accumulate( 0L ) ) > > : std::true_type {};
+
+    /// Operations shared by `sc::list`, `sc::small_list` and `std::list`.
+    template < typename C >
+    struct adapter {
+        static void push_front( C & c, int v ) { c.push_front( v ); }
+        static void pop_front( C & c ) { c.pop_front(); }
+        static void sort( C & c ) { c.sort(); }
+        static void merge( C & c, C & other ) { c.merge( other ); }
+        static void splice( C & c, typename C::const_iterator pos, C & other ) { c.splice( pos, other ); }
+        static void reverse( C & c ) { c.reverse(); }
+        static void unique( C & c ) { c.unique(); }
+        static bool find( const C & c, int v ) {
+            if constexpr ( has_scans< C >::value ) return c.contains( v );
+            else return std::find( c.begin(), c.end(), v ) != c.end();
+        }
+        static size_t count( const C & c, int v ) {
+            if constexpr ( has_scans< C >::value ) return c.count( v );
+            else return static_cast< size_t >( std::count( c.begin(), c.end(), v ) );
+        }
+        static long accumulate( const C & c ) {
+            if constexpr ( has_scans< C >::value ) return c.accumulate( 0L );
+            else return std::accumulate( c.begin(), c.end(), 0L );
+        }
+    };
+
+    /// The vector counterpart of each list operation.
+    template <>
+    struct adapter< std::vector< int > > {
+        using C = std::vector< int >;
+        static void push_front( C & c, int v ) { c.insert( c.begin(), v ); }
+        static void pop_front( C & c ) { c.erase( c.begin() ); }
+        static void sort( C & c ) { std::stable_sort( c.begin(), c.end() ); }
+        static void merge( C & c, C & other ) {
+            auto mid = c.insert( c.end(), other.begin(), other.end() );
+            std::inplace_merge( c.begin(), mid, c.end() );
+            other.clear();
+        }
+        static void splice( C & c, C::const_iterator pos, C & other ) {
+            c.insert( pos, other.begin(), other.end() );
+            other.clear();
+        }
+        static void reverse( C & c ) { std::reverse( c.begin(), c.end() ); }
+        static void unique( C & c ) { c.erase( std::unique( c.begin(), c.end() ), c.end() ); }
+        static bool find( const C & c, int v ) { return std::find( c.begin(), c.end(), v ) != c.end(); }
+        static size_t count( const C & c, int v ) { return static_cast< size_t >( std::count( c.begin(), c.end(), v ) ); }
+        static long accumulate( const C & c ) { return std::accumulate( c.begin(), c.end(), 0L ); }
+    };
+
+    /// Persistent lists are immutable, so they only run the operations in `persistent_ops`.
+    template < typename C > struct is_persistent : std::false_type {};
+    template < typename T, typename A > struct is_persistent< sc::persistent_list< T, A > > : std::true_type {};
+
+    const std::vector< std::string > all_libs{ "sc", "small", "persistent", "std", "vector" };
+    const std::vector< std::string > all_ops{
+        "push_back", "push_front", "pop_back", "pop_front", "insert_middle", "erase_middle",
+        "traverse", "copy", "copy_assign", "assign", "clear", "sort", "merge", "splice", "reverse", "unique",
+        "find", "count", "accumulate" };
+    const std::vector< std::string > persistent_ops{ "push_front", "pop_front", "traverse", "copy" };
+
+    /// Command line options.
+    struct options {
+        std::vector< std::string > libs{ all_libs };
+        std::vector< std::string > ops{ all_ops };
+        std::vector< size_t > sizes{ 10, 100, 1000, 10000, 100000, 1000000, 10000000 };
+        double budget_ms{ 1000 };  //!< Skips the larger sizes of an operation expected to take longer than this.
+        double min_time_ms{ 50 };  //!< Repeats a measurement until this much time was spent on it.
+        size_t max_reps{ 15 };
+        double warmup_ms{ 10 };    //!< Runs each measurement, untimed, for this long first.
+        int pin{ -1 };             //!< CPU to run on, or -1 to let the scheduler choose.
+        bool counters{ false };    //!< Whether to count hardware events too.
+        std::string format{ "csv" };
+        std::string out;
+        std::string save_baseline; //!< Where to save the results as a baseline.
+        std::string baseline;      //!< Baseline to compare the results against.
+        double threshold{ 10 };    //!< Slowdown tolerated against the baseline, in percent.
+    };
+
+    /// How many operations `insert_middle` and `erase_middle` perform on a fixture of `n` elements.
+    size_t middle_ops( size_t n ) { return std::min< size_t >( std::max< size_t >( n / 2, 1 ), 1000 ); }
+
+    /// Hardware event counters, opened once by `main()` if asked for and available.
+    bench::perf_counters * events{ nullptr };
+
+    /// Measures the operations every container type offers, or returns nothing for the others.
+    template < typename C >
+    std::optional< bench::result > run_shared_op( const std::string & op, size_t n, const std::vector< int > & data,
+                                                  const options & opt )
+    {
+        using A = adapter< C >;
+        const double min_ns = opt.min_time_ms * 1e6;
+        const double warmup_ns = opt.warmup_ms * 1e6;
+        auto first = data.begin();
+        auto last = data.begin() + static_cast< std::ptrdiff_t >( n );
+        C c;
+        auto fill = [&]() { c = C( first, last ); };
+        auto nothing = [](){};
+
+        if ( op == "push_front" )
+            return bench::measure( [&]{ c = C{}; },
+                                   [&]{ for ( auto it = first; it != last; ++it ) A::push_front( c, *it ); },
+                                   n, min_ns, opt.max_reps, warmup_ns, events );
+        if ( op == "pop_front" )
+            return bench::measure( fill, [&]{ for ( size_t i{0}; i < n; ++i ) A::pop_front( c ); },
+                                   n, min_ns, opt.max_reps, warmup_ns, events );
+        if ( op == "traverse" ) {
+            fill();
+            return bench::measure( nothing, [&]{
+                                       long sum{0};
+                                       for ( auto it = c.begin(); it != c.end(); ++it ) sum += *it;
+                                       bench::do_not_optimize( sum ); },
+                                   n, min_ns, opt.max_reps, warmup_ns, events );
+        }
+        if ( op == "copy" ) {
+            fill();
+            std::optional< C > copy; // Keeps the copy alive, so its destruction is not measured.
+            return bench::measure( [&]{ copy.reset(); }, [&]{ copy.emplace( c ); },
+                                   n, min_ns, opt.max_reps, warmup_ns, events );
+        }
+        return std::nullopt;
+    }
+
+    /*!
+     * Measures a single operation on container type C.
+     * @param data At least `n` random values, used to fill the fixtures.
+     */
+    template < typename C >
+    bench::result run_op( const std::string & op, size_t n, const std::vector< int > & data, const options & opt )
+    {
+        if ( auto r = run_shared_op< C >( op, n, data, opt ) )
+            return *r;
+        using A = adapter< C >;
+        const double min_ns = opt.min_time_ms * 1e6;
+        const double warmup_ns = opt.warmup_ms * 1e6;
+        auto first = data.begin();
+        auto last = data.begin() + static_cast< std::ptrdiff_t >( n );
+        C c, other;
+        typename C::iterator mid;
+        typename C::const_iterator where;
+        auto fill = [&]() { c = C( first, last ); };
+        auto fill_mid = [&]() { fill(); mid = std::next( c.begin(), static_cast< std::ptrdiff_t >( n / 2 ) ); };
+
+        if ( op == "push_back" )
+            return bench::measure( [&]{ c = C{}; },
+                                   [&]{ for ( auto it = first; it != last; ++it ) c.push_back( *it ); },
+                                   n, min_ns, opt.max_reps, warmup_ns, events );
+        if ( op == "pop_back" )
+            return bench::measure( fill, [&]{ for ( size_t i{0}; i < n; ++i ) c.pop_back(); },
+                                   n, min_ns, opt.max_reps, warmup_ns, events );
+        if ( op == "insert_middle" ) {
+            size_t k = middle_ops( n );
+            return bench::measure( fill_mid, [&]{ for ( size_t i{0}; i < k; ++i ) mid = c.insert( mid, data[i] ); },
+                                   k, min_ns, opt.max_reps, warmup_ns, events );
+        }
+        if ( op == "erase_middle" ) {
+            size_t k = middle_ops( n );
+            return bench::measure( fill_mid, [&]{ for ( size_t i{0}; i < k; ++i ) mid = c.erase( mid ); },
+                                   k, min_ns, opt.max_reps, warmup_ns, events );
+        }
+        if ( op == "copy_assign" ) {
+            other = C( first, last );
+            return bench::measure( fill, [&]{ c = other; }, n, min_ns, opt.max_reps, warmup_ns, events );
+        }
+        if ( op == "assign" )
+            return bench::measure( [&]{ c = C{}; }, [&]{ c.assign( first, last ); },
+                                   n, min_ns, opt.max_reps, warmup_ns, events );
+        if ( op == "clear" )
+            return bench::measure( fill, [&]{ c.clear(); }, n, min_ns, opt.max_reps, warmup_ns, events );
+        if ( op == "sort" )
+            return bench::measure( fill, [&]{ A::sort( c ); }, n, min_ns, opt.max_reps, warmup_ns, events );
+        if ( op == "merge" ) {
+            std::vector< int > evens, odds;
+            for ( size_t i{0}; i < n; ++i )
+                ( i % 2 ? odds : evens ).push_back( static_cast< int >( i ) );
+            return bench::measure( [&]{ c = C( evens.begin(), evens.end() ); other = C( odds.begin(), odds.end() ); },
+                                   [&]{ A::merge( c, other ); },
+                                   n, min_ns, opt.max_reps, warmup_ns, events );
+        }
+        if ( op == "splice" ) {
+            auto half = first + static_cast< std::ptrdiff_t >( n / 2 );
+            return bench::measure( [&]{
+                                       c = C( first, half );
+                                       other = C( half, last );
+                                       where = std::next( c.cbegin(), static_cast< std::ptrdiff_t >( n / 4 ) ); },
+                                   [&]{ A::splice( c, where, other ); },
+                                   n - n / 2, min_ns, opt.max_reps, warmup_ns, events );
+        }
+        if ( op == "reverse" )
+            return bench::measure( fill, [&]{ A::reverse( c ); }, n, min_ns, opt.max_reps, warmup_ns, events );
+        if ( op == "unique" ) {
+            std::vector< int > runs( n ); // Every value repeated twice in a row.
+            for ( size_t i{0}; i < n; ++i )
+                runs[i] = data[ i / 2 ];
+            return bench::measure( [&]{ c = C( runs.begin(), runs.end() ); }, [&]{ A::unique( c ); },
+                                   n, min_ns, opt.max_reps, warmup_ns, events );
+        }
+        // The scans look for a value that is not there (the data is non-negative), so they walk the whole list.
+        if ( op == "find" ) {
+            fill();
+            return bench::measure( []{}, [&]{ bench::do_not_optimize( A::find( c, -1 ) ); },
+                                   n, min_ns, opt.max_reps, warmup_ns, events );
+        }
+        if ( op == "count" ) {
+            fill();
+            return bench::measure( []{}, [&]{ bench::do_not_optimize( A::count( c, -1 ) ); },
+                                   n, min_ns, opt.max_reps, warmup_ns, events );
+        }
+        if ( op == "accumulate" ) {
+            fill();
+            return bench::measure( []{}, [&]{ bench::do_not_optimize( A::accumulate( c ) ); },
+                                   n, min_ns, opt.max_reps, warmup_ns, events );
+        }
+        std::cerr << "list_bench: unknown operation \"" << op << "\"\n";
+        std::exit( 1 );
+    }
+
+    /// Runs every selected operation of container type C, at every selected size.
+    template < typename C >
+    void run_lib( const std::string & lib, const options & opt, const std::vector< int > & data,
+                  std::vector< bench::result > & results )
+    {
+        for ( const auto & op : opt.ops ) {
+            if ( is_persistent< C >::value and
+                 std::find( persistent_ops.begin(), persistent_ops.end(), op ) == persistent_ops.end() )
+                continue;
+            double last_ns{0};
+            size_t last_n{0};
+            for ( size_t n : opt.sizes ) {
+                // Estimate, assuming linear growth, whether this size would blow the budget.
+                if ( last_n != 0 and last_ns * n / last_n > opt.budget_ms * 1e6 ) {
+                    std::cerr << "list_bench: skipping " << lib << " " << op << " from n = " << n << " on\n";
+                    break;
+                }
+                bench::result r;
+                if constexpr ( is_persistent< C >::value )
+                    r = *run_shared_op< C >( op, n, data, opt );
+                else
+                    r = run_op< C >( op, n, data, opt );
+                r.lib = lib;
+                r.op = op;
+                r.n = n;
+                results.push_back( r );
+                last_ns = r.ns_per_op * r.ops;
+                last_n = n;
+            }
+        }
+    }
+
+    /// Keeps this process on one CPU, so migrations do not add noise to the measurements.
+    void pin_to_cpu( int cpu ) {
+#if defined(__linux__)
+        cpu_set_t set;
+        CPU_ZERO( &set );
+        CPU_SET( cpu, &set );
+        if ( sched_setaffinity( 0, sizeof( set ), &set ) != 0 )
+            std::cerr << "list_bench: cannot pin to CPU " << cpu << ", running unpinned\n";
+#else
+        std::cerr << "list_bench: pinning is not supported on this platform, running unpinned\n";
+        (void) cpu;
+#endif
+    }
+
+    std::vector< std::string > split( const std::string & s ) {
+        std::vector< std::string > parts;
+        std::istringstream iss{ s };
+        for ( std::string part; std::getline( iss, part, ',' ); )
+            if ( not part.empty() )
+                parts.push_back( part );
+        return parts;
+    }
+
+    void usage( void ) {
+        std::cerr << "Usage: list_bench [--lib=sc,small,persistent,std,vector] [--op=name,...] [--sizes=n,... | --max-size=n]\n"
+                     "                  [--budget-ms=n] [--min-time-ms=n] [--max-reps=n] [--warmup-ms=n] [--pin=cpu]\n"
+                     "                  [--counters] [--format=csv|json] [--out=file]\n"
+                     "                  [--save-baseline=file] [--baseline=file [--threshold=percent]]\n";
+        std::exit( 1 );
+    }
+
+    options parse_options( int argc, char * argv[] ) {
+        options opt;
+        for ( int i{1}; i < argc; ++i ) {
+            std::string arg{ argv[i] };
+            if ( arg == "--counters" ) {
+                opt.counters = true;
+                continue;
+            }
+            auto eq = arg.find( '=' );
+            if ( arg.compare( 0, 2, "--" ) != 0 or eq == std::string::npos )
+                usage();
+            std::string key = arg.substr( 2, eq - 2 ), value = arg.substr( eq + 1 );
+            if ( key == "lib" ) opt.libs = split( value );
+            else if ( key == "op" ) opt.ops = split( value );
+            else if ( key == "sizes" ) {
+                opt.sizes.clear();
+                for ( const auto & s : split( value ) )
+                    opt.sizes.push_back( std::stoul( s ) );
+            }
+            else if ( key == "max-size" ) {
+                size_t max = std::stoul( value );
+                opt.sizes.erase( std::remove_if( opt.sizes.begin(), opt.sizes.end(),
+                                 [max]( size_t n ) { return n > max; } ), opt.sizes.end() );
+            }
+            else if ( key == "budget-ms" ) opt.budget_ms = std::stod( value );
+            else if ( key == "min-time-ms" ) opt.min_time_ms = std::stod( value );
+            else if ( key == "max-reps" ) opt.max_reps = std::max< size_t >( std::stoul( value ), 1 );
+            else if ( key == "warmup-ms" ) opt.warmup_ms = std::stod( value );
+            else if ( key == "pin" ) opt.pin = std::stoi( value );
+            else if ( key == "save-baseline" ) opt.save_baseline = value;
+            else if ( key == "baseline" ) opt.baseline = value;
+            else if ( key == "threshold" ) opt.threshold = std::stod( value );
+            else if ( key == "format" and ( value == "csv" or value == "json" ) ) opt.format = value;
+            else if ( key == "out" ) opt.out = value;
+            else usage();
+        }
+        return opt;
+    }
+}
+
+int main( int argc, char * argv[] )
+{
+    options opt = parse_options( argc, argv );
+    if ( opt.pin >= 0 )
+        pin_to_cpu( opt.pin );
+    bench::perf_counters counters;
+    if ( opt.counters and counters.available() )
+        events = &counters;
+    else if ( opt.counters )
+        std::cerr << "list_bench: hardware counters are not available here, timing only\n";
+
+    size_t max_n{0};
+    for ( size_t n : opt.sizes )
+        max_n = std::max( max_n, n );
+    std::vector< int > data( max_n );
+    std::mt19937 gen{ 2021 };
+    std::uniform_int_distribution< int > dist{ 0, 1 << 30 };
+    for ( auto & v : data )
+        v = dist( gen );
+
+    std::vector< bench::result > results;
+    for ( const auto & lib : opt.libs ) {
+        if ( lib == "sc" ) run_lib< sc::list< int > >( lib, opt, data, results );
+        else if ( lib == "small" ) run_lib< sc::small_list< int, 8 > >( lib, opt, data, results );
+        else if ( lib == "persistent" ) run_lib< sc::persistent_list< int > >( lib, opt, data, results );
+        else if ( lib == "std" ) run_lib< std::list< int > >( lib, opt, data, results );
+        else if ( lib == "vector" ) run_lib< std::vector< int > >( lib, opt, data, results );
+        else usage();
+    }
+
+    std::ofstream ofs;
+    if ( not opt.out.empty() )
+        ofs.open( opt.out );
+    std::ostream & os = opt.out.empty() ? std::cout : ofs;
+    if ( opt.format == "json" )
+        bench::write_json( os, results );
+    else
+        bench::write_csv( os, results );
+
+    if ( not opt.save_baseline.empty() ) {
+        std::ofstream baseline{ opt.save_baseline };
+        bench::write_json( baseline, results );
+        if ( not baseline ) {
+            std::cerr << "list_bench: cannot write the baseline " << opt.save_baseline << "\n";
+            return 1;
+        }
+    }
+    if ( not opt.baseline.empty() ) {
+        std::ifstream ifs{ opt.baseline };
+        std::vector< bench::result > baseline;
+        if ( not ifs or not bench::read_json( ifs, baseline ) ) {
+            std::cerr << "list_bench: cannot read the baseline " << opt.baseline << "\n";
+            return 1;
+        }
+        auto cmp = bench::compare( baseline, results, opt.threshold / 100 );
+        bench::write_comparison( std::cerr, cmp );
+        size_t n_regressed = std::count_if( cmp.begin(), cmp.end(), []( const bench::comparison & c ) { return c.regressed; } );
+        std::cerr << "list_bench: " << n_regressed << " of " << cmp.size() << " measurements regressed by more than "
+                  << opt.threshold << "%\n";
+        if ( n_regressed != 0 )
+            return 2;
+    }
+    return 0;
+}
@@ -0,0 +1,177 @@
+/*!
+ * @file mt_churn.cpp
+ * @brief Multi-threaded churn: lists built on one thread and destroyed on another.
+ *
+ * Each of `--threads` threads builds `--lists` lists of `--nodes` elements and hands every
+ * one to the next thread in a ring, which destroys it. So every node is freed on another
+ * thread than the one that allocated it, as in a producer/consumer pipeline. The run is
+ * repeated for each node allocation policy in `--alloc`:
+ *
+ * - `heap`: `sc::heap_nodes`, the global allocator.
+ * - `cache`: `sc::node_cache`, per-thread pools with batched remote frees.
+ *
+ * For every policy and thread count, a line reports the wall clock time, the nodes built
+ * and destroyed per second across all threads, and the wall clock time per node.
+ *
+ * Usage: list_mt_bench [--alloc=heap,cache] [--threads=1,2,4,8,16,32] [--nodes=N]
+ *                      [--lists=N] [--format=csv|json] [--out=file]
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../include/list.h"
+
+namespace {
+
+    /// Command line options.
+    struct options {
+        std::vector< std::string > allocs{ "heap", "cache" };
+        std::vector< size_t > threads{ 1, 2, 4, 8, 16, 32 };
+        size_t nodes{ 1000 };  //!< Elements per list.
+        size_t lists{ 2000 };  //!< Lists built by each thread.
+        std::string format{ "csv" };
+        std::string out;
+    };
+
+    /// Lists handed to a thread, waiting to be destroyed by it.
+    template < typename L >
+    struct inbox {
+        std::mutex lock;
+        std::vector< L * > lists;
+    };
+
+    /// Runs the ring with `n_threads` threads and returns its wall clock time, in seconds.
+    template < typename Alloc >
+    double run_ring( size_t n_threads, const options & opt ) {
+        using L = sc::list< int, sc::no_stats, Alloc >;
+        std::vector< inbox< L > > inboxes( n_threads );
+        std::atomic< size_t > destroyed{0};
+        const size_t total = n_threads * opt.lists;
+
+        auto drain = [&]( size_t t ) {
+            std::vector< L * > got;
+            {
+                std::lock_guard< std::mutex > guard{ inboxes[t].lock };
+                got.swap( inboxes[t].lists );
+            }
+            for ( L * l : got )
+                delete l;
+            destroyed.fetch_add( got.size(), std::memory_order_relaxed );
+        };
+        auto work = [&]( size_t t ) {
+            auto & next = inboxes[ ( t + 1 ) % n_threads ];
+            for ( size_t i{0}; i < opt.lists; ++i ) {
+                L * l = new L;
+                for ( size_t k{0}; k < opt.nodes; ++k )
+                    l->push_back( static_cast< int >( k ) );
+                {
+                    std::lock_guard< std::mutex > guard{ next.lock };
+                    next.lists.push_back( l );
+                }
+                drain( t );
+            }
+            while ( destroyed.load( std::memory_order_relaxed ) < total ) {
+                drain( t );
+                std::this_thread::yield();
+            }
+        };
+
+        auto start = std::chrono::steady_clock::now();
+        std::vector< std::thread > pool;
+        for ( size_t t{0}; t < n_threads; ++t )
+            pool.emplace_back( work, t );
+        for ( auto & th : pool )
+            th.join();
+        return std::chrono::duration< double >( std::chrono::steady_clock::now() - start ).count();
+    }
+
+    std::vector< std::string > split( const std::string & s ) {
+        std::vector< std::string > out;
+        std::istringstream iss{ s };
+        for ( std::string item; std::getline( iss, item, ',' ); )
+            if ( not item.empty() )
+                out.push_back( item );
+        return out;
+    }
+
+    bool parse( int argc, char * argv[], options & opt )
+    {
+        for ( int i{1}; i < argc; ++i )
+        {
+            std::string arg{ argv[i] };
+            auto value = [&]( const char * name ) -> const char * {
+                size_t len = std::strlen( name );
+                return arg.compare( 0, len, name ) == 0 ? arg.c_str() + len : nullptr;
+            };
+            if ( auto v = value( "--alloc=" ) )        opt.allocs = split( v );
+            else if ( auto v = value( "--threads=" ) ) {
+                opt.threads.clear();
+                for ( const auto & t : split( v ) )
+                    opt.threads.push_back( std::max< size_t >( std::strtoull( t.c_str(), nullptr, 10 ), 1 ) );
+            }
+            else if ( auto v = value( "--nodes=" ) )   opt.nodes = std::strtoull( v, nullptr, 10 );
+            else if ( auto v = value( "--lists=" ) )   opt.lists = std::max< size_t >( std::strtoull( v, nullptr, 10 ), 1 );
+            else if ( auto v = value( "--format=" ) )  opt.format = v;
+            else if ( auto v = value( "--out=" ) )     opt.out = v;
+            else return false;
+        }
+        if ( opt.format != "csv" and opt.format != "json" )
+            return false;
+        for ( const auto & a : opt.allocs )
+            if ( a != "heap" and a != "cache" )
+                return false;
+        return true;
+    }
+}
+
+int main( int argc, char * argv[] )
+{
+    options opt;
+    if ( not parse( argc, argv, opt ) )
+    {
+        std::cerr << "Usage: " << argv[0] << " [--alloc=heap,cache] [--threads=1,2,4,8,16,32] [--nodes=N]"
+                  << " [--lists=N] [--format=csv|json] [--out=file]\n";
+        return EXIT_FAILURE;
+    }
+
+    std::ofstream ofs;
+    if ( not opt.out.empty() )
+        ofs.open( opt.out );
+    std::ostream & os = opt.out.empty() ? std::cout : ofs;
+    if ( opt.format == "csv" )
+        os << "alloc,threads,nodes,lists,seconds,nodes_per_sec,ns_per_node\n";
+    else
+        os << "[\n";
+    bool first{ true };
+    for ( const auto & alloc : opt.allocs )
+        for ( size_t t : opt.threads )
+        {
+            double secs = alloc == "heap" ? run_ring< sc::heap_nodes >( t, opt ) : run_ring< sc::node_cache >( t, opt );
+            double nodes = static_cast< double >( t * opt.lists * opt.nodes );
+            double rate = nodes / secs;
+            if ( opt.format == "csv" )
+                os << alloc << ',' << t << ',' << opt.nodes << ',' << opt.lists << ',' << secs << ','
+                   << rate << ',' << 1e9 / rate << '\n';
+            else
+            {
+                os << ( first ? "" : ",\n" ) << "  {\"alloc\": \"" << alloc << "\", \"threads\": " << t
+                   << ", \"nodes\": " << opt.nodes << ", \"lists\": " << opt.lists << ", \"seconds\": " << secs
+                   << ", \"nodes_per_sec\": " << rate << ", \"ns_per_node\": " << 1e9 / rate << "}";
+                first = false;
+            }
+            os.flush();
+        }
+    if ( opt.format == "json" )
+        os << "\n]\n";
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,213 @@
+/*!
+ * @file queue_bench.cpp
+ * @brief Throughput and latency of the list queues against a mutex guarded `sc::list`.
+ *
+ * `--producers` threads push `--items` timestamps each, and one consumer takes them in
+ * batches until it has all of them, through each queue in `--queue`:
+ *
+ * - `mutex`: an `sc::list` under a `std::mutex`; producers `push_back()` and the consumer
+ *   copies everything pending out with `front()` and `pop_front()`, holding the lock.
+ * - `mpsc`: `sc::mpsc_list_queue`; the consumer calls `pop_all()`.
+ * - `spsc`: `sc::spsc_list_queue`, only measured with a single producer.
+ *
+ * For every queue and producer count, a line reports the wall clock time, the items passed
+ * per second, and the median, 99th and 99.9th percentile time an item spent in the queue.
+ *
+ * Usage: list_queue_bench [--queue=mutex,mpsc,spsc] [--producers=1,2,4] [--items=N]
+ *                         [--format=csv|json] [--out=file]
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../include/list.h"
+#include "../include/list_queue.h"
+
+namespace {
+
+    /// Command line options.
+    struct options {
+        std::vector< std::string > queues{ "mutex", "mpsc", "spsc" };
+        std::vector< size_t > producers{ 1, 2, 4 };
+        size_t items{ 1000000 }; //!< Items pushed by each producer.
+        std::string format{ "csv" };
+        std::string out;
+    };
+
+    /// What a run measured.
+    struct result {
+        double seconds;
+        uint64_t p50, p99, p999; //!< Time in the queue, in nanoseconds.
+    };
+
+    uint64_t now_ns( void ) {
+        return static_cast< uint64_t >( std::chrono::duration_cast< std::chrono::nanoseconds >(
+                    std::chrono::steady_clock::now().time_since_epoch() ).count() );
+    }
+
+    /// The setup the queues replace.
+    struct mutex_queue {
+        std::mutex lock;
+        sc::list< uint64_t > items;
+
+        void push( uint64_t v ) {
+            std::lock_guard< std::mutex > guard{ lock };
+            items.push_back( v );
+        }
+        size_t pop_all( std::vector< uint64_t > & into ) {
+            std::lock_guard< std::mutex > guard{ lock };
+            size_t count{0};
+            for ( ; not items.empty(); ++count ) {
+                into.push_back( items.front() );
+                items.pop_front();
+            }
+            return count;
+        }
+    };
+    /// Adapts a list queue to the same interface; the batch list is reused between pops.
+    template < typename Q >
+    struct batch_queue {
+        Q q;
+        sc::list< uint64_t > batch;
+
+        void push( uint64_t v ) { q.push( v ); }
+        size_t pop_all( std::vector< uint64_t > & into ) {
+            size_t count = q.pop_all( batch );
+            into.insert( into.end(), batch.cbegin(), batch.cend() );
+            batch.clear();
+            return count;
+        }
+    };
+
+    template < typename Q >
+    result run( size_t n_producers, size_t items ) {
+        Q q;
+        const size_t total = n_producers * items;
+        std::vector< uint64_t > latencies;
+        latencies.reserve( total );
+
+        auto start = std::chrono::steady_clock::now();
+        std::vector< std::thread > producers;
+        for ( size_t t{0}; t < n_producers; ++t )
+            producers.emplace_back( [&q, items] {
+                for ( size_t i{0}; i < items; ++i )
+                    q.push( now_ns() );
+            } );
+        std::vector< uint64_t > stamps;
+        for ( size_t got{0}; got < total; ) {
+            stamps.clear();
+            size_t n = q.pop_all( stamps );
+            if ( n == 0 ) {
+                std::this_thread::yield();
+                continue;
+            }
+            uint64_t t = now_ns();
+            for ( uint64_t s : stamps )
+                latencies.push_back( t - s );
+            got += n;
+        }
+        double secs = std::chrono::duration< double >( std::chrono::steady_clock::now() - start ).count();
+        for ( auto & th : producers )
+            th.join();
+
+        auto pct = [&latencies]( double p ) {
+            auto it = latencies.begin() + static_cast< std::ptrdiff_t >( p * ( latencies.size() - 1 ) );
+            std::nth_element( latencies.begin(), it, latencies.end() );
+            return *it;
+        };
+        return result{ secs, pct( 0.5 ), pct( 0.99 ), pct( 0.999 ) };
+    }
+
+    std::vector< std::string > split( const std::string & s ) {
+        std::vector< std::string > out;
+        std::istringstream iss{ s };
+        for ( std::string item; std::getline( iss, item, ',' ); )
+            if ( not item.empty() )
+                out.push_back( item );
+        return out;
+    }
+
+    bool parse( int argc, char * argv[], options & opt )
+    {
+        for ( int i{1}; i < argc; ++i )
+        {
+            std::string arg{ argv[i] };
+            auto value = [&]( const char * name ) -> const char * {
+                size_t len = std::strlen( name );
+                return arg.compare( 0, len, name ) == 0 ? arg.c_str() + len : nullptr;
+            };
+            if ( auto v = value( "--queue=" ) )          opt.queues = split( v );
+            else if ( auto v = value( "--producers=" ) ) {
+                opt.producers.clear();
+                for ( const auto & p : split( v ) )
+                    opt.producers.push_back( std::max< size_t >( std::strtoull( p.c_str(), nullptr, 10 ), 1 ) );
+            }
+            else if ( auto v = value( "--items=" ) )     opt.items = std::max< size_t >( std::strtoull( v, nullptr, 10 ), 1 );
+            else if ( auto v = value( "--format=" ) )    opt.format = v;
+            else if ( auto v = value( "--out=" ) )       opt.out = v;
+            else return false;
+        }
+        if ( opt.format != "csv" and opt.format != "json" )
+            return false;
+        for ( const auto & q : opt.queues )
+            if ( q != "mutex" and q != "mpsc" and q != "spsc" )
+                return false;
+        return true;
+    }
+}
+
+int main( int argc, char * argv[] )
+{
+    options opt;
+    if ( not parse( argc, argv, opt ) )
+    {
+        std::cerr << "Usage: " << argv[0] << " [--queue=mutex,mpsc,spsc] [--producers=1,2,4] [--items=N]"
+                  << " [--format=csv|json] [--out=file]\n";
+        return EXIT_FAILURE;
+    }
+
+    std::ofstream ofs;
+    if ( not opt.out.empty() )
+        ofs.open( opt.out );
+    std::ostream & os = opt.out.empty() ? std::cout : ofs;
+    if ( opt.format == "csv" )
+        os << "queue,producers,items,seconds,items_per_sec,p50_ns,p99_ns,p999_ns\n";
+    else
+        os << "[\n";
+    bool first{ true };
+    for ( const auto & queue : opt.queues )
+        for ( size_t p : opt.producers )
+        {
+            if ( queue == "spsc" and p != 1 )
+                continue;
+            result r = queue == "mutex" ? run< mutex_queue >( p, opt.items )
+                     : queue == "mpsc"  ? run< batch_queue< sc::mpsc_list_queue< uint64_t > > >( p, opt.items )
+                     :                    run< batch_queue< sc::spsc_list_queue< uint64_t > > >( p, opt.items );
+            double rate = static_cast< double >( p * opt.items ) / r.seconds;
+            if ( opt.format == "csv" )
+                os << queue << ',' << p << ',' << opt.items << ',' << r.seconds << ',' << rate << ','
+                   << r.p50 << ',' << r.p99 << ',' << r.p999 << '\n';
+            else
+            {
+                os << ( first ? "" : ",\n" ) << "  {\"queue\": \"" << queue << "\", \"producers\": " << p
+                   << ", \"items\": " << opt.items << ", \"seconds\": " << r.seconds << ", \"items_per_sec\": " << rate
+                   << ", \"p50_ns\": " << r.p50 << ", \"p99_ns\": " << r.p99 << ", \"p999_ns\": " << r.p999 << "}";
+                first = false;
+            }
+            os.flush();
+        }
+    if ( opt.format == "json" )
+        os << "\n]\n";
+    return EXIT_SUCCESS;
+}
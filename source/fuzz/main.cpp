@@ -0,0 +1,572 @@
+/*!
+ * @file main.cpp
+ * @brief Differential fuzzer: random sequences of operations are applied both to
+ *        `sc::list` and to `std::list`, which must stay equal all along.
+ *
+ * Every run is a sequence of operations generated from the seed and the run
+ * number, so any run can be replayed with `--seed=S --run=R`. The operations
+ * act on two lists, A and B, each holding a cursor that moves around and is
+ * used as the position of inserts, erases and splices. After every operation
+ * the sizes and the elements under the cursors are compared; the whole
+ * contents are compared, forwards and backwards, every few operations.
+ *
+ * The runs execute in a child process, so a crash in `sc::list` is caught like
+ * any other divergence. A failing sequence is shrunk, by removing chunks of
+ * operations while it still fails, and printed.
+ *
+ * Usage: list_fuzz [--seed=N] [--runs=N | --time=SECONDS] [--ops=N]
+ *                  [--max-size=N] [--run=R] [--no-shrink]
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <iterator>
+#include <list>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#   define FUZZ_HAS_FORK
+#   include <sys/wait.h>
+#   include <unistd.h>
+#endif
+
+#include "../include/list.h"
+
+namespace {
+
+    using value_t = int;
+    constexpr value_t n_values = 16; // Few distinct values, so unique(), find() and merge() see duplicates.
+
+    //=== Operations.
+
+    enum class kind : std::uint8_t {
+        PUSH_BACK, PUSH_FRONT, POP_BACK, POP_FRONT, INSERT, INSERT_RANGE, ERASE, ERASE_RANGE,
+        CLEAR, ASSIGN, COPY_ASSIGN, SPLICE, MERGE, SORT, UNIQUE, REVERSE,
+        NEXT, PREV, ADVANCE, TO_BEGIN, TO_END, FIND,
+        COUNT_
+    };
+    const char * const kind_names[] = {
+        "push_back", "push_front", "pop_back", "pop_front", "insert", "insert_range", "erase", "erase_range",
+        "clear", "assign", "operator=", "splice", "merge", "sort", "unique", "reverse",
+        "next", "prev", "advance", "to_begin", "to_end", "find" };
+    /// How often each operation is generated, relative to the others.
+    const unsigned kind_weights[] = {
+        10, 10, 5, 5, 10, 4, 8, 3,
+        1, 1, 1, 2, 1, 2, 2, 2,
+        8, 8, 4, 2, 2, 3 };
+
+    /// One operation. Positions and counts are relative to the state the operation finds, so
+    /// any subsequence of a valid sequence is valid too, which is what shrinking relies on.
+    struct op {
+        kind k;
+        std::uint8_t target; //!< 0 acts on A (with B as the other list), 1 acts on B.
+        std::uint16_t n;     //!< Number of elements or steps.
+        value_t value;
+    };
+
+    std::ostream & operator<<( std::ostream & os, const op & o )
+    {
+        return os << ( o.target ? 'B' : 'A' ) << '.' << kind_names[ static_cast< int >( o.k ) ]
+                  << "( n = " << o.n << ", value = " << o.value << " )";
+    }
+
+    /// A divergence between `sc::list` and `std::list`.
+    struct divergence : std::runtime_error {
+        using std::runtime_error::runtime_error;
+    };
+
+    void expect( bool cond, const char * what )
+    {
+        if ( not cond )
+            throw divergence( what );
+    }
+
+    /// A list under test: the model, the subject, and a cursor into each.
+    struct subject_pair {
+        std::list< value_t > model;
+        sc::list< value_t > subject;
+        std::list< value_t >::iterator mcur;
+        sc::list< value_t >::iterator scur;
+
+        subject_pair() : mcur{ model.begin() }, scur{ subject.begin() } {}
+        subject_pair( const subject_pair & ) = delete;
+
+        void reset_cursor( void ) { mcur = model.begin(); scur = subject.begin(); }
+
+        void check_cursor( void )
+        {
+            bool mend = mcur == model.end();
+            expect( mend == ( scur == subject.end() ), "the cursors disagree on being at end()" );
+            if ( not mend )
+                expect( *mcur == *scur, "the cursors point to different values" );
+        }
+
+        void check_contents( void )
+        {
+            expect( model.size() == subject.size(), "sizes differ" );
+            auto s = subject.begin();
+            for ( auto m = model.begin(); m != model.end(); ++m, ++s )
+                expect( s != subject.end() and *m == *s, "contents differ, walking forwards" );
+            expect( s == subject.end(), "contents differ, walking forwards" );
+            for ( auto m = model.rbegin(); m != model.rend(); ++m )
+                expect( s != subject.begin() and *--s == *m, "contents differ, walking backwards" );
+            expect( s == subject.begin(), "contents differ, walking backwards" );
+        }
+    };
+
+    /// Applies `o` to both lists of the pair it targets, and checks the cheap invariants.
+    void apply( subject_pair & a, subject_pair & b, const op & o )
+    {
+        subject_pair & p = o.target ? b : a;
+        subject_pair & q = o.target ? a : b;
+        const value_t v = o.value;
+        switch ( o.k )
+        {
+            case kind::PUSH_BACK:
+                p.model.push_back( v );
+                p.subject.push_back( v );
+                break;
+            case kind::PUSH_FRONT:
+                p.model.push_front( v );
+                p.subject.push_front( v );
+                break;
+            case kind::POP_BACK:
+                if ( p.model.empty() ) break;
+                {
+                    bool at_last = p.mcur != p.model.end() and std::next( p.mcur ) == p.model.end();
+                    p.model.pop_back();
+                    p.subject.pop_back();
+                    if ( at_last ) p.reset_cursor();
+                }
+                break;
+            case kind::POP_FRONT:
+                if ( p.model.empty() ) break;
+                {
+                    bool at_first = p.mcur == p.model.begin();
+                    p.model.pop_front();
+                    p.subject.pop_front();
+                    if ( at_first ) p.reset_cursor();
+                }
+                break;
+            case kind::INSERT:
+                p.mcur = p.model.insert( p.mcur, v );
+                p.scur = p.subject.insert( p.scur, v );
+                break;
+            case kind::INSERT_RANGE:
+                {
+                    std::vector< value_t > values( o.n % 32 );
+                    for ( size_t i{0}; i < values.size(); ++i )
+                        values[i] = ( v + static_cast< value_t >( i ) ) % n_values;
+                    p.mcur = p.model.insert( p.mcur, values.begin(), values.end() );
+                    p.scur = p.subject.insert( p.scur, values.begin(), values.end() );
+                }
+                break;
+            case kind::ERASE:
+                if ( p.mcur == p.model.end() ) break;
+                p.mcur = p.model.erase( p.mcur );
+                p.scur = p.subject.erase( p.scur );
+                break;
+            case kind::ERASE_RANGE:
+                {
+                    auto mlast = p.mcur;
+                    auto slast = p.scur;
+                    for ( unsigned i{0}; i < o.n % 32u and mlast != p.model.end(); ++i, ++mlast, ++slast ) {}
+                    p.mcur = p.model.erase( p.mcur, mlast );
+                    p.scur = p.subject.erase( p.scur, slast );
+                }
+                break;
+            case kind::CLEAR:
+                p.model.clear();
+                p.subject.clear();
+                p.reset_cursor();
+                break;
+            case kind::ASSIGN:
+                if ( o.n % 2 == 0 )
+                {
+                    p.model.assign( q.model.begin(), q.model.end() );
+                    p.subject.assign( q.subject.begin(), q.subject.end() );
+                }
+                else
+                {
+                    std::vector< value_t > values( o.n % 32, v );
+                    p.model.assign( values.begin(), values.end() );
+                    p.subject.assign( values.begin(), values.end() );
+                }
+                p.reset_cursor();
+                break;
+            case kind::COPY_ASSIGN:
+                p.model = q.model;
+                p.subject = q.subject;
+                p.reset_cursor();
+                break;
+            case kind::SPLICE:
+                p.model.splice( p.mcur, q.model );
+                p.subject.splice( p.scur, q.subject );
+                q.reset_cursor();
+                break;
+            case kind::MERGE:
+                p.model.sort();
+                p.subject.sort();
+                q.model.sort();
+                q.subject.sort();
+                p.model.merge( q.model );
+                p.subject.merge( q.subject );
+                q.reset_cursor();
+                break;
+            case kind::SORT:
+                p.model.sort();
+                p.subject.sort();
+                break;
+            case kind::UNIQUE:
+                {
+                    // The cursor is invalidated when its element is a duplicate of the one before it.
+                    bool doomed = p.mcur != p.model.end() and p.mcur != p.model.begin() and *std::prev( p.mcur ) == *p.mcur;
+                    p.model.unique();
+                    p.subject.unique();
+                    if ( doomed ) p.reset_cursor();
+                }
+                break;
+            case kind::REVERSE:
+                p.model.reverse();
+                p.subject.reverse();
+                break;
+            case kind::NEXT:
+                if ( p.mcur != p.model.end() ) { ++p.mcur; ++p.scur; }
+                break;
+            case kind::PREV:
+                if ( p.mcur != p.model.begin() ) { --p.mcur; --p.scur; }
+                break;
+            case kind::ADVANCE:
+                for ( unsigned i{0}; i < o.n % 64u and p.mcur != p.model.end(); ++i ) { ++p.mcur; ++p.scur; }
+                break;
+            case kind::TO_BEGIN:
+                p.reset_cursor();
+                break;
+            case kind::TO_END:
+                p.mcur = p.model.end();
+                p.scur = p.subject.end();
+                break;
+            case kind::FIND:
+                {
+                    auto m = std::find( p.model.begin(), p.model.end(), v );
+                    auto s = p.subject.find( v );
+                    expect( ( m == p.model.end() ) == ( s == p.subject.end() ), "find() disagrees" );
+                    expect( static_cast< size_t >( std::count( p.model.begin(), p.model.end(), v ) ) == p.subject.count( v ),
+                            "count() disagrees" );
+                    p.mcur = m;
+                    p.scur = s;
+                }
+                break;
+            case kind::COUNT_:
+                break;
+        }
+        expect( p.model.size() == p.subject.size(), "sizes differ" );
+        expect( q.model.size() == q.subject.size(), "sizes differ" );
+        if ( not p.model.empty() )
+            expect( p.model.front() == p.subject.front() and p.model.back() == p.subject.back(), "front() or back() differ" );
+        p.check_cursor();
+    }
+
+    //=== Generation.
+
+    /// Generates the operations of run `run`, a function of the seed and the run number only.
+    std::vector< op > generate( std::uint64_t seed, std::uint64_t run, size_t n_ops, size_t max_size )
+    {
+        std::mt19937_64 rng{ seed * 0x9E3779B97F4A7C15ull + run };
+        std::discrete_distribution< int > pick( std::begin( kind_weights ), std::end( kind_weights ) );
+        std::vector< op > ops;
+        ops.reserve( n_ops );
+        // Track the sizes roughly, to shrink the lists when they grow past max_size.
+        size_t size[2] = { 0, 0 };
+        for ( size_t i{0}; i < n_ops; ++i )
+        {
+            std::uint64_t r = rng();
+            op o;
+            o.target = static_cast< std::uint8_t >( r & 1 );
+            o.n = static_cast< std::uint16_t >( r >> 8 );
+            o.value = static_cast< value_t >( ( r >> 24 ) % n_values );
+            o.k = static_cast< kind >( pick( rng ) );
+            if ( size[ o.target ] > max_size and ( r >> 40 ) % 4 == 0 )
+                o.k = ( ( r >> 42 ) % 8 == 0 ) ? kind::CLEAR : kind::ERASE_RANGE;
+            switch ( o.k )
+            {
+                case kind::PUSH_BACK: case kind::PUSH_FRONT: case kind::INSERT: ++size[ o.target ]; break;
+                case kind::INSERT_RANGE: size[ o.target ] += o.n % 32; break;
+                case kind::SPLICE: case kind::MERGE: size[ o.target ] += size[ 1 - o.target ]; size[ 1 - o.target ] = 0; break;
+                case kind::CLEAR: size[ o.target ] = 0; break;
+                case kind::COPY_ASSIGN: size[ o.target ] = size[ 1 - o.target ]; break;
+                default: break;
+            }
+            ops.push_back( o );
+        }
+        return ops;
+    }
+
+    //=== Execution.
+
+    /// Result of executing a sequence.
+    struct outcome {
+        bool failed{ false };
+        size_t at{ 0 };          //!< Index of the operation that failed.
+        std::string message;
+    };
+
+    /// Applies the whole sequence to fresh lists, in this process.
+    outcome execute( const std::vector< op > & ops )
+    {
+        subject_pair a, b;
+        outcome out;
+        try {
+            for ( size_t i{0}; i < ops.size(); ++i )
+            {
+                out.at = i;
+                apply( a, b, ops[i] );
+                // Comparing everything is O(n): do it always while the lists are small, seldom after.
+                if ( a.model.size() + b.model.size() <= 64 or i % 64 == 0 )
+                {
+                    a.check_contents();
+                    b.check_contents();
+                }
+            }
+            a.check_contents();
+            b.check_contents();
+        }
+        catch ( const divergence & e ) {
+            out.failed = true;
+            out.message = e.what();
+        }
+        return out;
+    }
+
+#ifdef FUZZ_HAS_FORK
+    /// Applies the sequence in a child process, so that a crash is reported as a failure.
+    outcome execute_isolated( const std::vector< op > & ops )
+    {
+        int fds[2];
+        if ( pipe( fds ) != 0 )
+            throw std::runtime_error( "list_fuzz: pipe() failed" );
+        std::cout.flush();
+        pid_t pid = fork();
+        if ( pid < 0 )
+            throw std::runtime_error( "list_fuzz: fork() failed" );
+        if ( pid == 0 )
+        {
+            close( fds[0] );
+            outcome out = execute( ops );
+            if ( out.failed )
+            {
+                std::string msg = std::to_string( out.at ) + '\n' + out.message;
+                ssize_t ignored = write( fds[1], msg.data(), msg.size() );
+                (void) ignored;
+            }
+            _exit( out.failed ? 1 : 0 );
+        }
+        close( fds[1] );
+        std::string msg;
+        char buf[ 512 ];
+        for ( ssize_t n; ( n = read( fds[0], buf, sizeof( buf ) ) ) > 0; )
+            msg.append( buf, static_cast< size_t >( n ) );
+        close( fds[0] );
+        int status{0};
+        waitpid( pid, &status, 0 );
+
+        outcome out;
+        if ( WIFSIGNALED( status ) )
+        {
+            out.failed = true;
+            out.at = ops.size();
+            out.message = std::string{ "crashed with signal " } + std::to_string( WTERMSIG( status ) )
+                          + " (" + strsignal( WTERMSIG( status ) ) + ")";
+        }
+        else if ( WEXITSTATUS( status ) != 0 )
+        {
+            out.failed = true;
+            auto nl = msg.find( '\n' );
+            out.at = nl == std::string::npos ? ops.size() : std::stoul( msg.substr( 0, nl ) );
+            out.message = nl == std::string::npos ? "exited with an error" : msg.substr( nl + 1 );
+        }
+        return out;
+    }
+#else
+    outcome execute_isolated( const std::vector< op > & ops ) { return execute( ops ); }
+#endif
+
+    //=== Shrinking.
+
+    /*!
+     * Removes chunks of operations, from half of the sequence down to single operations, as long
+     * as the sequence keeps failing; then makes the remaining operations as small as possible.
+     */
+    std::vector< op > shrink( std::vector< op > ops )
+    {
+        // Nothing after the failing operation matters.
+        outcome first = execute_isolated( ops );
+        if ( first.at < ops.size() )
+            ops.resize( first.at + 1 );
+
+        for ( size_t chunk = std::max< size_t >( ops.size() / 2, 1 ); ; chunk /= 2 )
+        {
+            for ( size_t i{0}; i < ops.size(); )
+            {
+                std::vector< op > candidate;
+                candidate.reserve( ops.size() );
+                candidate.insert( candidate.end(), ops.begin(), ops.begin() + static_cast< std::ptrdiff_t >( i ) );
+                candidate.insert( candidate.end(), ops.begin() + static_cast< std::ptrdiff_t >( std::min( i + chunk, ops.size() ) ), ops.end() );
+                if ( execute_isolated( candidate ).failed )
+                    ops.swap( candidate );
+                else
+                    i += chunk;
+            }
+            if ( chunk == 1 )
+                break;
+        }
+        for ( auto & o : ops )
+        {
+            for ( auto simpler : { op{ o.k, o.target, 0, o.value }, op{ o.k, o.target, o.n, 0 }, op{ o.k, o.target, 1, o.value } } )
+            {
+                op saved = o;
+                o = simpler;
+                if ( not execute_isolated( ops ).failed )
+                    o = saved;
+            }
+        }
+        return ops;
+    }
+
+    //=== Command line.
+
+    struct options {
+        std::uint64_t seed{ 1 };
+        std::uint64_t runs{ 100 };
+        size_t ops{ 10000 };
+        size_t max_size{ 1000 };
+        double seconds{ 0 };         //!< When positive, keeps running until this much time has passed.
+        long long only_run{ -1 };    //!< When not negative, runs only this run.
+        bool shrink{ true };
+    };
+
+    bool parse( int argc, char * argv[], options & opt )
+    {
+        for ( int i{1}; i < argc; ++i )
+        {
+            std::string arg{ argv[i] };
+            auto value = [&]( const char * name ) -> const char * {
+                size_t len = std::strlen( name );
+                return arg.compare( 0, len, name ) == 0 ? arg.c_str() + len : nullptr;
+            };
+            if ( auto v = value( "--seed=" ) )          opt.seed = std::strtoull( v, nullptr, 10 );
+            else if ( auto v = value( "--runs=" ) )     opt.runs = std::strtoull( v, nullptr, 10 );
+            else if ( auto v = value( "--ops=" ) )      opt.ops = std::strtoull( v, nullptr, 10 );
+            else if ( auto v = value( "--max-size=" ) ) opt.max_size = std::strtoull( v, nullptr, 10 );
+            else if ( auto v = value( "--time=" ) )     opt.seconds = std::atof( v );
+            else if ( auto v = value( "--run=" ) )      opt.only_run = std::atoll( v );
+            else if ( arg == "--no-shrink" )            opt.shrink = false;
+            else return false;
+        }
+        return true;
+    }
+
+    /// Reports a failing run, shrunk unless told otherwise.
+    void report( const options & opt, std::uint64_t run, const std::vector< op > & ops )
+    {
+        outcome out = execute_isolated( ops );
+        std::cout << "FAILED: seed " << opt.seed << ", run " << run << ", at operation " << out.at
+                  << " of " << ops.size() << ": " << out.message << '\n'
+                  << "Replay with: list_fuzz --seed=" << opt.seed << " --run=" << run
+                  << " --ops=" << opt.ops << " --max-size=" << opt.max_size << '\n';
+        if ( not opt.shrink )
+            return;
+        std::vector< op > small = shrink( ops );
+        out = execute_isolated( small );
+        std::cout << "Shrunk to " << small.size() << " operations, failing with: " << out.message << '\n';
+        for ( const auto & o : small )
+            std::cout << "    " << o << '\n';
+    }
+}
+
+int main( int argc, char * argv[] )
+{
+    options opt;
+    if ( not parse( argc, argv, opt ) )
+    {
+        std::cerr << "Usage: " << argv[0] << " [--seed=N] [--runs=N | --time=SECONDS] [--ops=N]"
+                  << " [--max-size=N] [--run=R] [--no-shrink]\n";
+        return EXIT_FAILURE;
+    }
+
+    using clock = std::chrono::steady_clock;
+    auto t0 = clock::now();
+    auto elapsed = [&]{ return std::chrono::duration< double >( clock::now() - t0 ).count(); };
+
+    if ( opt.only_run >= 0 )
+    {
+        auto run = static_cast< std::uint64_t >( opt.only_run );
+        auto ops = generate( opt.seed, run, opt.ops, opt.max_size );
+        if ( not execute_isolated( ops ).failed )
+        {
+            std::cout << "Run " << run << " passed.\n";
+            return EXIT_SUCCESS;
+        }
+        report( opt, run, ops );
+        return EXIT_FAILURE;
+    }
+
+    // The runs execute in one child process, which tells the parent which run it is on, so
+    // the parent knows which run to shrink even if the child crashes.
+    auto run_all = [&]( int progress_fd ) -> bool {
+        for ( std::uint64_t run{0}; opt.seconds > 0 ? elapsed() < opt.seconds : run < opt.runs; ++run )
+        {
+#ifdef FUZZ_HAS_FORK
+            if ( write( progress_fd, &run, sizeof( run ) ) != sizeof( run ) )
+                return false;
+#endif
+            if ( execute( generate( opt.seed, run, opt.ops, opt.max_size ) ).failed )
+                return false;
+        }
+        return true;
+    };
+
+    std::uint64_t runs_done{0}, last_run{0};
+    bool passed{ false };
+#ifdef FUZZ_HAS_FORK
+    int fds[2];
+    if ( pipe( fds ) != 0 )
+        return EXIT_FAILURE;
+    std::cout.flush();
+    pid_t pid = fork();
+    if ( pid == 0 )
+    {
+        close( fds[0] );
+        _exit( run_all( fds[1] ) ? 0 : 1 );
+    }
+    close( fds[1] );
+    std::uint64_t run;
+    while ( read( fds[0], &run, sizeof( run ) ) == sizeof( run ) )
+    {
+        last_run = run;
+        ++runs_done;
+    }
+    close( fds[0] );
+    int status{0};
+    waitpid( pid, &status, 0 );
+    passed = WIFEXITED( status ) and WEXITSTATUS( status ) == 0;
+#else
+    passed = run_all( -1 );
+#endif
+    if ( not passed )
+    {
+        report( opt, last_run, generate( opt.seed, last_run, opt.ops, opt.max_size ) );
+        return EXIT_FAILURE;
+    }
+    double secs = elapsed();
+    std::cout << "OK: " << runs_done << " runs of " << opt.ops << " operations (seed " << opt.seed << "), "
+              << static_cast< double >( runs_done * opt.ops ) / secs / 1e6 << " million operations per second.\n";
+    return EXIT_SUCCESS;
+}
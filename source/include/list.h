@@ -13,8 +13,34 @@ using std::copy;
 using std::swap;
 #include <cstddef>   // std::ptrdiff_t
 #include <type_traits>
+#include <utility>   // move
+
+#include "list_algo.h"
+#include "list_alloc.h"
+#include "list_stats.h"
+
+// Atomic access to a node link that another thread may be reading or writing at the same time.
+#if defined(__GNUC__) || defined(__clang__)
+#   define SC_LOAD_LINK( link ) __atomic_load_n( &(link), __ATOMIC_ACQUIRE )
+#   define SC_STORE_LINK( link, value ) __atomic_store_n( &(link), (value), __ATOMIC_RELEASE )
+#else
+#   include <atomic>
+#   define SC_LOAD_LINK( link ) \
+        reinterpret_cast< std::atomic< decltype( link ) > & >( link ).load( std::memory_order_acquire )
+#   define SC_STORE_LINK( link, value ) \
+        reinterpret_cast< std::atomic< decltype( link ) > & >( link ).store( (value), std::memory_order_release )
+#endif
 
 namespace sc { // linear sequence. Better name: sequence container (same as STL).
+    template < typename T, typename Alloc, bool MultiProducer > class list_queue;
+
+    /// Whether the allocation policy `A` retires nodes for later instead of freeing them
+    /// (`A::defers_free`, see list_epoch.h).
+    template < typename A, typename = void >
+    struct defers_free : std::false_type {};
+    template < typename A >
+    struct defers_free< A, typename std::enable_if< A::defers_free >::type > : std::true_type {};
+
     /*!
      * A class representing a biderectional iterator defined over a linked list.
      *
@@ -25,10 +51,20 @@ namespace sc { // linear sequence. Better name: sequence container (same as STL)
      *
      * \date May, 2nd 2017.
      * \author Selan R. dos Santos
+     *
+     * The `Stats` policy receives a hook call for every node allocated or freed,
+     * link followed, element copied and public operation called. The default,
+     * `no_stats`, ignores all of them; see list_stats.h for the alternatives.
+     *
+     * The `Alloc` policy provides the memory of the nodes. The default, `heap_nodes`,
+     * uses the global allocator; see list_alloc.h for the alternatives. With a policy
+     * that defers frees, such as `epoch_nodes`, erased nodes are retired instead, links
+     * are stored and loaded atomically, and readers may iterate while the list changes
+     * (see list_epoch.h).
      */
 
-    template < typename T >
-    class list
+    template < typename T, typename Stats = no_stats, typename Alloc = heap_nodes >
+    class list : private Stats
     {
         private:
         //=== the data node.
@@ -41,6 +77,12 @@ namespace sc { // linear sequence. Better name: sequence container (same as STL)
             Node( const T &d=T{} , Node * n=nullptr, Node * p=nullptr )
                 : data {d}, next{n}, prev{p}
             { /* empty */ }
+            explicit Node( T && d ) : data{ std::move( d ) }, next{nullptr}, prev{nullptr}
+            { /* empty */ }
+
+            // Nodes get their memory from the allocation policy.
+            static void * operator new( size_t bytes ) { return Alloc::allocate( bytes, alignof( Node ) ); }
+            static void operator delete( void * p, size_t bytes ) noexcept { Alloc::deallocate( p, bytes, alignof( Node ) ); }
         };
 
 
@@ -102,7 +144,7 @@ namespace sc { // linear sequence. Better name: sequence container (same as STL)
                  * @return const_iterator The result of the expression.
                  */
                 const_iterator operator++() { 
-                    m_ptr = m_ptr->next;
+                    m_ptr = list::load_link( m_ptr->next );
                     return const_iterator(*this); 
                 }
                 /**
@@ -112,7 +154,7 @@ namespace sc { // linear sequence. Better name: sequence container (same as STL)
                  */
                 const_iterator operator++(int) { 
                     const_iterator temp = (*this); 
-                    m_ptr = m_ptr->next;
+                    m_ptr = list::load_link( m_ptr->next );
                     return const_iterator(temp); 
                 }
                 /**
@@ -121,7 +163,7 @@ namespace sc { // linear sequence. Better name: sequence container (same as STL)
                  * @return const_iterator The result of the expression.
                  */
                 const_iterator operator--() {  
-                    m_ptr = m_ptr->prev;
+                    m_ptr = list::load_link( m_ptr->prev );
                     return const_iterator(*this); 
                 }
                 /**
@@ -131,7 +173,7 @@ namespace sc { // linear sequence. Better name: sequence container (same as STL)
                  */
                 const_iterator operator--(int) {
                     const_iterator temp = (*this); 
-                    m_ptr = m_ptr->prev;
+                    m_ptr = list::load_link( m_ptr->prev );
                     return const_iterator(temp); 
                 }
                 /**
@@ -163,7 +205,11 @@ namespace sc { // linear sequence. Better name: sequence container (same as STL)
                  * @return const_iterator The result of the expression.
                  */
                 const_iterator operator+=( difference_type step) {
-                    *this = step + *this;
+                    Stats::on_walk( step < 0 ? -step : step );
+                    for ( ; step > 0; --step )
+                        m_ptr = list::load_link( m_ptr->next );
+                    for ( ; step < 0; ++step )
+                        m_ptr = list::load_link( m_ptr->prev );
                     return const_iterator(*this); 
                 }
                 /**
@@ -173,8 +219,7 @@ namespace sc { // linear sequence. Better name: sequence container (same as STL)
                  * @return const_iterator The result of the expression.
                  */
                 const_iterator operator-=(  difference_type step ) {
-                    *this = *this - step; 
-                    return const_iterator(*this); 
+                    return *this += -step;
                 }
                 /**
                  * @brief access the members of the structure using pointers.
@@ -195,7 +240,7 @@ namespace sc { // linear sequence. Better name: sequence container (same as STL)
                 }
 
                 // We need friendship so the list<T> class may access the m_ptr field.
-                friend class list<T>;
+                friend class list<T, Stats, Alloc>;
                 friend std::ostream & operator<< ( std::ostream & os_, const const_iterator & s_ ){
                     os_ << "[@"<< s_.m_ptr << ", val = " << s_.m_ptr->data << "]";
                     return os_;
@@ -236,6 +281,12 @@ namespace sc { // linear sequence. Better name: sequence container (same as STL)
                  * @return iterator& the result of the expression.
                  */
                 iterator& operator=( const iterator & ) = default;
+                /**
+                 * @brief Converts to a constant iterator to the same element, as std::list iterators do.
+                 */
+                operator const_iterator() const {
+                    return const_iterator( m_ptr );
+                }
                 /**
                  * @brief The unary indirection operator dereferences a pointer
                  *
@@ -258,7 +309,7 @@ namespace sc { // linear sequence. Better name: sequence container (same as STL)
                  * @return iterator The result of the expression.
                  */
                 iterator operator++() { 
-                    m_ptr = m_ptr->next;
+                    m_ptr = list::load_link( m_ptr->next );
                     return iterator(*this); 
                 }
                 /**
@@ -268,7 +319,7 @@ namespace sc { // linear sequence. Better name: sequence container (same as STL)
                  */
                 iterator operator++(int) {
                     iterator temp = (*this); 
-                    m_ptr = m_ptr->next;
+                    m_ptr = list::load_link( m_ptr->next );
 	                return iterator(temp); 
                 }
                 /**
@@ -277,7 +328,7 @@ namespace sc { // linear sequence. Better name: sequence container (same as STL)
                  * @return iterator The result of the expression.
                  */
                 iterator operator--() {
-                    m_ptr = m_ptr->prev;
+                    m_ptr = list::load_link( m_ptr->prev );
                     return iterator(*this); 
                 }
                 /**
@@ -287,7 +338,7 @@ namespace sc { // linear sequence. Better name: sequence container (same as STL)
                  */
                 iterator operator--(int) {
                     iterator temp = (*this); 
-                    m_ptr = m_ptr->prev;
+                    m_ptr = list::load_link( m_ptr->prev );
 	                return temp; 
                 }
                 /**
@@ -319,7 +370,11 @@ namespace sc { // linear sequence. Better name: sequence container (same as STL)
                  * @return iterator The result of the expression.
                  */
                 iterator operator+=( difference_type step) {
-                    *this = step + *this;
+                    Stats::on_walk( step < 0 ? -step : step );
+                    for ( ; step > 0; --step )
+                        m_ptr = list::load_link( m_ptr->next );
+                    for ( ; step < 0; ++step )
+                        m_ptr = list::load_link( m_ptr->prev );
                     return iterator(*this); 
                 }
                 /**
@@ -329,8 +384,7 @@ namespace sc { // linear sequence. Better name: sequence container (same as STL)
                  * @return iterator The result of the expression.
                  */
                 iterator operator-=(  difference_type step ) {
-                    *this = *this - step;
-                    return iterator(*this); 
+                    return *this += -step;
                 }
                 /**
                  * @brief access the members of the structure using pointers.
@@ -350,7 +404,7 @@ namespace sc { // linear sequence. Better name: sequence container (same as STL)
                     return std::distance(m_ptr, rhs.m_ptr);
                 }
                 // We need friendship so the list<T> class may access the m_ptr field.
-                friend class list<T>;
+                friend class list<T, Stats, Alloc>;
                 friend std::ostream & operator<< ( std::ostream & os_, const iterator & s_ )
                 {
                     os_ << "[@"<< s_.m_ptr << ", val = " << s_.m_ptr->data << "]";
@@ -361,6 +415,9 @@ namespace sc { // linear sequence. Better name: sequence container (same as STL)
 
         //=== Private members.
         private:
+            // The queues build their chains out of list nodes, and hand them over to a list.
+            template < typename, typename, bool > friend class list_queue;
+
             size_t m_len;    // comprimento da lista.
             Node * m_head; // nó cabeça.
             Node * m_tail; // nó calda.
@@ -376,6 +433,9 @@ namespace sc { // linear sequence. Better name: sequence container (same as STL)
         list(){
             m_head = new Node();
             m_tail = new Node();
+            this->on_alloc( sizeof( Node ) );
+            this->on_alloc( sizeof( Node ) );
+            this->on_call( list_op::CONSTRUCT );
             m_head->prev = nullptr;
             m_tail->next = nullptr;	
             m_head->next = m_tail;
@@ -398,7 +458,7 @@ namespace sc { // linear sequence. Better name: sequence container (same as STL)
          */
         explicit list( size_t count ) : list(){
 	        for(size_t i = 0; i < count; ++i){
-                insert(end(), T{});   
+                link_before( m_tail, T{} );
             }    
         }
         /**
@@ -409,42 +469,29 @@ namespace sc { // linear sequence. Better name: sequence container (same as STL)
          */
         template< typename InputIt >
         list( InputIt first, InputIt last ): list() {
-            for (InputIt i = first; i != last; i++){
-                insert( m_tail, *(i));
-            }
+            insert_range( m_tail, first, last );
         }
         /**
          * @brief Copy constructor. Constructs the container with the copy of the contents of clone_.
          * 
          */
         list( const list & clone_ ) : list(){
-            Node* tmp = clone_.m_head->next;
-            while (tmp->next != nullptr){
-                insert(m_tail, tmp->data);
-                tmp = tmp->next;
-            }
+            this->on_call( list_op::COPY );
+            insert_range( m_tail, clone_.cbegin(), clone_.cend() );
         }
         /**
          * @brief Constructs the container with the contents of the initializer list ilist_.
          * 
          */
         list( std::initializer_list<T> ilist_ ): list(){
-            for (auto i = ilist_.begin(); i != ilist_.end(); i++){
-                insert( m_tail, *i);
-            }
+            insert_range( m_tail, ilist_.begin(), ilist_.end() );
         }
         /**
          * @brief Destructs the list.
          */
         ~list() { 
-            Node* temp;
             this->m_len = 0;
-            while (m_head != nullptr)
-            {
-                temp = m_head;
-                m_head = m_head->next;
-                delete temp;
-	        }
+            free_nodes( m_head, nullptr );
          }
         /**
          * @brief Copy assignment operator. Replaces the contents with a copy of the contents of rhs.
@@ -453,12 +500,10 @@ namespace sc { // linear sequence. Better name: sequence container (same as STL)
          * @return *this
          */
         list & operator=( const list & rhs ){
-            clear();
-            Node* tmp = rhs.m_head->next;
-            while (tmp->next != nullptr){
-                insert(m_tail,tmp->data);
-                tmp = tmp->next;
-            }
+            if ( this == &rhs )
+                return *this;
+            this->on_call( list_op::ASSIGN );
+            assign_nodes( rhs.cbegin(), rhs.cend() );
             return *this;
         }
         /**
@@ -468,22 +513,20 @@ namespace sc { // linear sequence. Better name: sequence container (same as STL)
          * @return *this
          */
         list & operator=( std::initializer_list<T> ilist_ ) {
-            clear();
-            for (auto i = ilist_.begin(); i != ilist_.end(); i++){
-                insert( m_tail, *i);
-            }
+            this->on_call( list_op::ASSIGN );
+            assign_nodes( ilist_.begin(), ilist_.end() );
             return *this;
         }
 
 
-        //=== [II] ITERATORS (4).
+        //=== [II] ITERATORS (6).
         /**
          * @brief Returns an iterator to the first element of the list.
          * 
          * @return Iterator to the first element.
          */
         iterator begin() {
-            return iterator(m_head->next);
+            return iterator( load_link( m_head->next ) );
         }
         /**
          * @brief Returns an constant iterator to the first element of the list.
@@ -491,8 +534,9 @@ namespace sc { // linear sequence. Better name: sequence container (same as STL)
          * @return Constant iterator to the first element.
          */
         const_iterator cbegin() const  { 
-            return const_iterator(m_head->next); 
+            return const_iterator( load_link( m_head->next ) );
         }
+        const_iterator begin() const { return cbegin(); }
         /**
          * @brief Returns an iterator to the element following the last element of the list.
          * 
@@ -509,6 +553,7 @@ namespace sc { // linear sequence. Better name: sequence container (same as STL)
         const_iterator cend() const  { 
             return const_iterator(m_tail); 
         }
+        const_iterator end() const { return cend(); }
 
 
         //=== [III] Capacity/Status (2).
@@ -529,6 +574,14 @@ namespace sc { // linear sequence. Better name: sequence container (same as STL)
         size_t size(void) const {
             return m_len; 
         }
+        /**
+         * @brief Returns a snapshot of the counters kept by the `Stats` policy; all zeros for `no_stats`.
+         * 
+         * @return The counters of this list.
+         */
+        list_stats stats( void ) const {
+            return this->snapshot();
+        }
         
         
         //=== [IV] Modifiers (9).
@@ -536,13 +589,8 @@ namespace sc { // linear sequence. Better name: sequence container (same as STL)
          * @brief Erases all elements from the container
          */
         void clear()  {
-            if (m_head == nullptr) 
-                return;
-
-            while( m_tail->prev != m_head ) {
-                pop_front();
-            }  
-	        m_len = 0;
+            this->on_call( list_op::CLEAR );
+            clear_nodes();
         }
         /**
          * @brief Returns a reference to the first element in the container.
@@ -582,7 +630,8 @@ namespace sc { // linear sequence. Better name: sequence container (same as STL)
          * @param value_ The value of the element to prepend.
          */
         void push_front( const T & value_ ) {
-            insert(begin(), value_);
+            this->on_call( list_op::PUSH_FRONT );
+            link_before( m_head->next, value_ );
         }
         /**
          * @brief Appends the given element value to the end of the container.
@@ -590,27 +639,22 @@ namespace sc { // linear sequence. Better name: sequence container (same as STL)
          * @param value_ The value of the element to append.
          */
         void push_back( const T & value_ ) {
-            insert(end(), value_);            
+            this->on_call( list_op::PUSH_BACK );
+            link_before( m_tail, value_ );
         }
         /**
          * @brief Removes the first element of the container. If there are no elements in the container, the behavior is undefined.
          */
         void pop_front( ) {
-            Node *tmp = m_head;
-            m_head = m_head->next;
-            m_head->prev = nullptr;
-            delete tmp;
-            --m_len;
+            this->on_call( list_op::POP_FRONT );
+            unlink_node( m_head->next );
         }
         /**
          * @brief Removes the last element of the container. If there are no elements in the container, the behavior is undefined.
          */
         void pop_back( ) {
-            Node *tmp = m_tail;
-            m_tail = m_tail->prev;
-            m_tail->next = nullptr;
-            delete tmp;
-            --m_len;
+            this->on_call( list_op::POP_BACK );
+            unlink_node( m_tail->prev );
         }
 
 
@@ -623,9 +667,12 @@ namespace sc { // linear sequence. Better name: sequence container (same as STL)
          */
         template < class InItr >
         void assign( InItr first_, InItr last_ ){
-            for (InItr i = first_; i != last_; i++){
-                insert( m_tail, *(first_));
-            }
+            this->on_call( list_op::ASSIGN );
+            // Copy the new elements in first, so the range may come from this very list.
+            Node* old = m_head->next;
+            insert_range( old, first_, last_ );
+            while ( old != m_tail )
+                old = unlink_node( old );
         }
         /**
          * @brief Replaces the contents with the elements from the initializer list ilist.
@@ -633,9 +680,8 @@ namespace sc { // linear sequence. Better name: sequence container (same as STL)
          * @param ilist_ Initializer list to copy the values from.
          */
         void assign( std::initializer_list<T> ilist_ ){
-            for (auto i = ilist_.begin(); i != ilist_.end(); i++){
-                insert( m_tail, *(ilist_.begin()));
-            }
+            this->on_call( list_op::ASSIGN );
+            assign_nodes( ilist_.begin(), ilist_.end() );
         }
         /*!
          *  Inserts a new value in the list before the iterator 'it'
@@ -646,11 +692,8 @@ namespace sc { // linear sequence. Better name: sequence container (same as STL)
          *  \return An iterator to the new element in the list.
          */
         iterator insert( iterator pos_, const T & value_ ){
-            Node *newNode = new Node(value_, pos_.m_ptr, pos_.m_ptr->prev);
-            pos_.m_ptr->prev->next = newNode;
-            pos_.m_ptr->prev = newNode;
-            m_len++;
-            return iterator(newNode); 
+            this->on_call( list_op::INSERT );
+            return iterator( link_before( pos_.m_ptr, value_ ) );
         }
         /**
          * @brief Inserts elements from range [first_, last_) before pos_.
@@ -662,10 +705,8 @@ namespace sc { // linear sequence. Better name: sequence container (same as STL)
          */
         template < typename InItr >
         iterator insert( iterator pos_, InItr first_, InItr last_ ) {
-            for (InItr i = first_; i != last_; i++){
-                insert( pos_, *(i));            
-            }
-            return pos_;
+            this->on_call( list_op::INSERT );
+            return iterator( insert_range( pos_.m_ptr, first_, last_ ) );
         }
         /**
          * @brief Inserts elements from initializer list ilist_ before cpos_.
@@ -675,10 +716,7 @@ namespace sc { // linear sequence. Better name: sequence container (same as STL)
          * @return  Iterator pointing to the first element inserted, or cpos_ if ilist is empty.
          */
         iterator insert( iterator cpos_, std::initializer_list<T> ilist_ ) {
-            for (auto i = ilist_.begin(); i != ilist_.end(); i++){
-                insert( cpos_, *i);
-            }
-            return cpos_;
+            return insert( cpos_, ilist_.begin(), ilist_.end() );
         }
         /*!
          *  Erases the node pointed by 'it_' and returns an iterator
@@ -688,14 +726,8 @@ namespace sc { // linear sequence. Better name: sequence container (same as STL)
          *  \return An iterator to the node following the deleted node.
          */
         iterator erase( iterator it_ ){
-            Node *tmp = it_.m_ptr;
-            Node *aux_p = tmp->prev;
-            Node *aux_n = tmp->next;
-            aux_p->next = aux_n;
-            aux_n->prev = aux_p;
-            delete tmp;
-            m_len--;
-            return iterator{aux_n};
+            this->on_call( list_op::ERASE );
+            return iterator{ unlink_node( it_.m_ptr ) };
         }
         /**
          * @brief Removes the elements in the range [start; end) .
@@ -705,13 +737,11 @@ namespace sc { // linear sequence. Better name: sequence container (same as STL)
          * @return Iterator following the last removed element.
          */
         iterator erase( iterator start, iterator end ){
-            iterator aux_r, aux_s = start;
-            while (start != end) {
-                start++;
-                aux_r = erase(aux_s);
-                aux_s = start;
-            }
-            return iterator{aux_r};
+            this->on_call( list_op::ERASE );
+            Node* p = start.m_ptr;
+            while ( p != end.m_ptr )
+                p = unlink_node( p );
+            return iterator{ p };
         }
 
 
@@ -722,81 +752,345 @@ namespace sc { // linear sequence. Better name: sequence container (same as STL)
          * @param other Another container to merge
          */
         void merge( list & other ){
-            Node* tmp = other.m_head->next;
-            while (tmp->next != nullptr){
-                insert(m_tail,tmp->data);
-                tmp = tmp->next;
-            }
-            sort();
-            other.clear();
-            other.m_len = 0;
-            return; 
+            this->on_call( list_op::MERGE );
+            if ( &other == this or other.m_len == 0 )
+                return;
+            // Merge the two chains in one pass, relinking other's nodes into this list.
+            size_t count = other.m_len;
+            size_t total = m_len + count;
+            Node* theirs = other.detach_chain();
+            Node* ours = detach_chain();
+            adopt( other, count );
+            attach_chain( detail::merge_chains( links{ this }, ours, theirs ) );
+            m_len = total;
         }
         /**
-         * @brief Transfers elements from one list to another.
+         * @brief Transfers elements from one list to another. No element is copied and no
+         * node is allocated: the nodes of `other` are relinked before `pos`, in O(1).
          * 
          * @param pos Element before which the content will be inserted
          * @param other Another container to transfer the content from
          */
         void splice( const_iterator pos, list & other ){
-            Node* tmp = other.m_head->next;
-            while (tmp->next != nullptr){
-                Node *newNode = new Node(tmp->data, pos.m_ptr, pos.m_ptr->prev);
-                pos.m_ptr->prev->next = newNode;
-                pos.m_ptr->prev = newNode;
-                m_len++;
-            
-                tmp = tmp->next;
-            }
-            other.clear();
+            this->on_call( list_op::SPLICE );
+            if ( &other == this or other.m_len == 0 )
+                return;
+            Node* first = other.m_head->next;
+            Node* last = other.m_tail->prev;
+            size_t count = other.m_len;
+            other.m_head->next = other.m_tail;
+            other.m_tail->prev = other.m_head;
             other.m_len = 0;
+            adopt( other, count );
+            link_chain( pos.m_ptr, first, last, count );
         }
         /**
          * @brief Reverses the order of the elements in the container.
          */
         void reverse( void ){
-            Node* left = m_head;
-            Node* right = m_head;
-  
-            while (right->next != nullptr)
-                right = right->next;
-            
-            while (left != right && left->prev != right) {
-                std::swap(left->data, right->data);
-                left = left->next;
-                right = right->prev;
-            }
+            this->on_call( list_op::REVERSE );
+            if ( m_len < 2 )
+                return;
+            // Swap the links of every element node, then hook the ends back to the sentinels.
+            // Elements are not copied, so iterators keep pointing to the same elements.
+            Node* first = m_head->next;
+            Node* last = m_tail->prev;
+            for ( Node* p = first; p != m_tail; p = p->prev )
+                std::swap( p->next, p->prev );
+            this->on_traverse( m_len );
+            m_head->next = last;
+            last->prev = m_head;
+            m_tail->prev = first;
+            first->next = m_tail;
         }
         /**
          * @brief Removes all consecutive duplicate elements from the container.
          */
         void unique( void ){
-            Node* right = m_head->next;
-            while (right->next != nullptr) {
-                if(right->data == right->next->data)
-                    erase(right->next);
-                if(right->prev->data == right->data){
-                    erase(right->prev);
-                }    
-                
-                right = right->next;
+            this->on_call( list_op::UNIQUE );
+            if ( m_len < 2 )
+                return;
+            // Only element nodes are compared; the sentinels hold no value.
+            Node* p = m_head->next;
+            while ( p->next != m_tail ) {
+                if ( p->next->data == p->data )
+                    unlink_node( p->next );
+                else
+                    p = p->next;
+                this->on_traverse( 1 );
             }
-            return; 
         }
         /**
-         * @brief Sorts the elements in ascending order.
+         * @brief Sorts the elements in ascending order. The sort is stable, takes O(n log n)
+         * comparisons and moves nodes instead of elements, so iterators remain valid.
          */
         void sort( void ){  
-            Node* right = m_head->next;
-            while (right->next != nullptr) {
-                Node* left = right;
-                while (left->prev != nullptr){   
-                    if(left->data < left->prev->data)
-                        std::swap(left->data, left->prev->data);
-                    left = left->prev;
+            this->on_call( list_op::SORT );
+            sort_nodes();
+        }
+
+        //=== [VII] SEARCH & REDUCTION (6)
+        // The nodes are scattered across the heap, so there is no block of
+        // contiguous elements a vector unit could consume. Each scan is a plain
+        // walk: the address of a node is only known once the previous one was
+        // loaded, so a software prefetch cannot get ahead of the walk itself.
+        /**
+         * @brief Finds the first element equal to value_.
+         * 
+         * @param value_ The value to search for.
+         * @return Iterator to the first element equal to value_, or end() if there is none.
+         */
+        iterator find( const T & value_ ) {
+            this->on_call( list_op::FIND );
+            return iterator( find_node( value_ ) );
+        }
+        /**
+         * @brief Finds the first element equal to value_.
+         * 
+         * @param value_ The value to search for.
+         * @return Constant iterator to the first element equal to value_, or cend() if there is none.
+         */
+        const_iterator find( const T & value_ ) const {
+            this->on_call( list_op::FIND );
+            return const_iterator( find_node( value_ ) );
+        }
+        /**
+         * @brief Checks whether the container holds an element equal to value_.
+         * 
+         * @param value_ The value to search for.
+         * @return true if such an element exists, false otherwise.
+         */
+        bool contains( const T & value_ ) const {
+            this->on_call( list_op::FIND );
+            return find_node( value_ ) != m_tail;
+        }
+        /**
+         * @brief Counts the elements equal to value_.
+         * 
+         * @param value_ The value to count.
+         * @return The number of elements equal to value_.
+         */
+        size_t count( const T & value_ ) const {
+            this->on_call( list_op::FIND );
+            this->on_traverse( m_len );
+            return detail::count_nodes( links{ this }, m_head->next, m_tail, value_ );
+        }
+        /**
+         * @brief Finds the smallest element. If several are equivalent, the first one is returned.
+         * 
+         * @return Constant iterator to the smallest element, or cend() if the container is empty.
+         */
+        const_iterator min( void ) const {
+            this->on_call( list_op::FIND );
+            this->on_traverse( m_len );
+            return const_iterator( detail::min_node( links{ this }, m_head->next, m_tail ) );
+        }
+        /**
+         * @brief Finds the largest element. If several are equivalent, the first one is returned.
+         * 
+         * @return Constant iterator to the largest element, or cend() if the container is empty.
+         */
+        const_iterator max( void ) const {
+            this->on_call( list_op::FIND );
+            this->on_traverse( m_len );
+            return const_iterator( detail::max_node( links{ this }, m_head->next, m_tail ) );
+        }
+        /**
+         * @brief Sums up all the elements, starting from init_.
+         * 
+         * @param init_ The initial value of the sum.
+         * @return init_ plus every element of the container, added from front to back.
+         */
+        template < typename Acc >
+        Acc accumulate( Acc init_ ) const {
+            this->on_call( list_op::FIND );
+            this->on_traverse( m_len );
+            return detail::accumulate_nodes( links{ this }, m_head->next, m_tail, init_ );
+        }
+
+        private:
+        /// Returns the first node holding value_, or the tail sentinel if there is none.
+        Node* find_node( const T & value_ ) const {
+            return detail::find_node( links{ this }, m_head->next, m_tail, value_ );
+        }
+        /// Allocates a node holding a copy of value_.
+        Node* make_node( const T & value_, Node* next_ = nullptr, Node* prev_ = nullptr ) {
+            Node* n = new Node( value_, next_, prev_ );
+            this->on_alloc( sizeof( Node ) );
+            this->on_copy( 1 );
+            return n;
+        }
+        /// Frees a node that is no longer linked.
+        void free_node( Node* n ) {
+            free_node( n, reclaims_later{} );
+            this->on_free( sizeof( Node ) );
+        }
+        /// Readers may still hold the node: it is destroyed once they have left.
+        static void free_node( Node* n, std::true_type ) { Alloc::retire( n, &dispose_node ); }
+        static void free_node( Node* n, std::false_type ) { delete n; }
+        static void dispose_node( void * n ) { delete static_cast< Node* >( n ); }
+        /// Links a new node holding value_ right before `pos`, and returns it.
+        Node* link_before( Node* pos, const T & value_ ) {
+            Node* n = make_node( value_, pos, pos->prev );
+            store_link( pos->prev->next, n );
+            store_link( pos->prev, n );
+            ++m_len;
+            return n;
+        }
+        /// Unlinks and frees the element node `n`, and returns the node that followed it.
+        Node* unlink_node( Node* n ) {
+            Node* next = n->next;
+            store_link( n->prev->next, next );
+            store_link( next->prev, n->prev );
+            free_node( n );
+            --m_len;
+            return next;
+        }
+        /// Frees every element node, keeping both sentinels. They are unlinked first, so a
+        /// reader never finds a node that is already retired.
+        void clear_nodes( void ) {
+            this->on_traverse( m_len );
+            Node* first = m_head->next;
+            store_link( m_head->next, m_tail );
+            store_link( m_tail->prev, m_head );
+            free_nodes( first, m_tail );
+            m_len = 0;
+        }
+        /**
+         * @brief Copies the range [first_, last_) into new nodes, linked right before `pos`.
+         *
+         * @return The first node inserted, or `pos` if the range is empty.
+         */
+        template < typename InItr >
+        Node* insert_range( Node* pos, InItr first_, InItr last_ ) {
+            if ( first_ == last_ )
+                return pos;
+            // Build the new nodes as a detached chain, so the list is only touched once.
+            Node* first = make_node( *first_ );
+            Node* last = first;
+            size_t count{1};
+            try {
+                for ( ++first_; first_ != last_; ++first_ ) {
+                    last->next = make_node( *first_, nullptr, last );
+                    last = last->next;
+                    ++count;
                 }
-                right = right->next;
-            } 
+            }
+            catch ( ... ) {
+                free_chain( first );
+                throw;
+            }
+            link_chain( pos, first, last, count );
+            return first;
+        }
+        /// Links the detached chain [first, last] of `count` nodes right before `pos`.
+        void link_chain( Node* pos, Node* first, Node* last, size_t count ) {
+            first->prev = pos->prev;
+            last->next = pos;
+            store_link( pos->prev->next, first );
+            store_link( pos->prev, last );
+            m_len += count;
+        }
+        /// Unlinks every element node as a null terminated chain, leaving the list empty.
+        /// Writer only: a reader inside an epoch guard could run into the null link, so the
+        /// operations built on it (sort, merge) need the readers out, as list_epoch.h says.
+        Node* detach_chain( void ) {
+            if ( m_len == 0 )
+                return nullptr;
+            Node* first = m_head->next;
+            m_tail->prev->next = nullptr;
+            m_head->next = m_tail;
+            m_tail->prev = m_head;
+            m_len = 0;
+            return first;
+        }
+        /// Links the null terminated chain `first` between the sentinels, restoring its back links.
+        /// The list must be empty; its length is left for the caller to set.
+        void attach_chain( Node* first ) {
+            Node* prev = m_head;
+            for ( Node* p = first; p != nullptr; prev = p, p = p->next ) {
+                prev->next = p;
+                p->prev = prev;
+            }
+            prev->next = m_tail;
+            m_tail->prev = prev;
+        }
+        /// Accounts for `count` nodes that moved from `other` to this list.
+        void adopt( list & other, size_t count ) {
+            other.on_release( count * sizeof( Node ) );
+            this->on_adopt( count * sizeof( Node ) );
+        }
+        /// Frees every node of a detached, null terminated chain.
+        void free_chain( Node* first ) {
+            free_nodes( first, nullptr );
+        }
+
+        //=== Compile-time dispatch on the allocation policy: whether `Alloc` frees nodes at once or
+        // later. Tags rather than `if constexpr`, so this header still builds as C++11.
+        using reclaims_later = std::integral_constant< bool, defers_free< Alloc >::value >;
+
+        /// Links that readers may follow while the list changes are atomic when nodes are reclaimed later.
+        static Node* load_link( Node* const & link ) { return load_link( link, reclaims_later{} ); }
+        static Node* load_link( Node* const & link, std::true_type ) { return SC_LOAD_LINK( link ); }
+        static Node* load_link( Node* const & link, std::false_type ) { return link; }
+        static void store_link( Node* & link, Node* n ) { store_link( link, n, reclaims_later{} ); }
+        static void store_link( Node* & link, Node* n, std::true_type ) { SC_STORE_LINK( link, n ); }
+        static void store_link( Node* & link, Node* n, std::false_type ) { link = n; }
+
+        /// Frees the nodes from `p` up to, but not including, `stop`, following the `next` links.
+        void free_nodes( Node* p, Node* stop ) {
+            while ( p != stop ) {
+                Node* next = p->next;
+                free_node( p );
+                p = next;
+            }
+        }
+        /**
+         * @brief Replaces the elements with copies of [first_, last_), which must not come from this list.
+         *
+         * The nodes already held are overwritten in place, so only the difference in length is
+         * allocated or freed. Types that cannot be copy assigned are rebuilt from scratch.
+         */
+        template < typename InItr >
+        void assign_nodes( InItr first_, InItr last_ ) {
+            assign_nodes( first_, last_, std::is_copy_assignable< T >{} );
+        }
+        template < typename InItr >
+        void assign_nodes( InItr first_, InItr last_, std::true_type ) {
+            Node* p = m_head->next;
+            size_t n{0};
+            for ( ; p != m_tail and first_ != last_; p = p->next, ++first_, ++n )
+                p->data = *first_;
+            this->on_traverse( n );
+            this->on_copy( n );
+            if ( first_ != last_ )
+                insert_range( m_tail, first_, last_ );
+            while ( p != m_tail )
+                p = unlink_node( p );
+        }
+        template < typename InItr >
+        void assign_nodes( InItr first_, InItr last_, std::false_type ) {
+            clear_nodes();
+            insert_range( m_tail, first_, last_ );
+        }
+        /// How the node algorithms of list_algo.h walk this list; chains end at a null link.
+        struct links {
+            using ref = Node*;
+            const list * owner;
+            Node* nil( void ) const { return nullptr; }
+            Node* next( Node* n ) const { return n->next; }
+            void set_next( Node* n, Node* m ) const { n->next = m; }
+            const T & value( Node* n ) const { return n->data; }
+            void step( void ) const { owner->on_traverse( 1 ); }
+        };
+        /// Sorts the elements in ascending order by relinking the nodes, in O(n log n) and stably.
+        /// Nodes are never copied or reallocated, so iterators remain valid.
+        void sort_nodes( void ) {
+            if ( m_len < 2 )
+                return;
+            size_t count = m_len;
+            attach_chain( detail::sort_chain( links{ this }, detach_chain() ) );
+            m_len = count;
         }
     };
 
@@ -810,8 +1104,8 @@ namespace sc { // linear sequence. Better name: sequence container (same as STL)
      * @param l2_ list whose content is compared with `l1_`.
      * @return true if the contents of the list are equal, false otherwise.
      */
-    template < typename T >
-    inline bool operator==(const sc::list<T> & l1_, const sc::list<T> & l2_ ){ 
+    template < typename T, typename S, typename A >
+    inline bool operator==(const sc::list<T, S, A> & l1_, const sc::list<T, S, A> & l2_ ){ 
         if(l1_.size() != l2_.size()) {
             return false;
         }
@@ -834,8 +1128,8 @@ namespace sc { // linear sequence. Better name: sequence container (same as STL)
      * @param l2_ list whose content is compared with `l1_`.
      * @return true if the contents of the list are not equal, false otherwise.
      */
-    template < typename T >
-    inline bool operator!=( const sc::list<T> & l1_, const sc::list<T> & l2_ ){
+    template < typename T, typename S, typename A >
+    inline bool operator!=( const sc::list<T, S, A> & l1_, const sc::list<T, S, A> & l2_ ){
         if(l1_.size() != l2_.size()) {
             return true;
         }
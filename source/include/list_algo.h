@@ -0,0 +1,136 @@
+#ifndef _LIST_ALGO_H_
+#define _LIST_ALGO_H_
+
+/*!
+ * @file list_algo.h
+ * @brief Node algorithms shared by the list types: the merge sort and the scans.
+ *
+ * `sc::list`, `sc::static_list`, `sc::small_list` and `sc::mapped_list` name
+ * their nodes differently (a pointer, an array index, a file offset), but sort
+ * and search them the same way. Each describes its nodes with a small `links`
+ * type, and the algorithms here work through it:
+ *
+ *     using ref = ...;                         // How a node is named.
+ *     ref nil() const;                         // The end of a chain.
+ *     ref next( ref n ) const;                 // The node after n.
+ *     void set_next( ref n, ref m ) const;     // Makes m follow n.
+ *     const T & value( ref n ) const;          // The element n holds.
+ *     void step() const;                       // Called once per node visited, for statistics.
+ *
+ * Only `sort_chain()` and `merge_chains()` call `set_next()`, so the scans may
+ * run on links that cannot write.
+ */
+
+#include <cstddef>
+
+namespace sc {
+namespace detail {
+
+    /// Merges the sorted chains `a` and `b`, ended by `nil()`; on ties, nodes of `a` come first.
+    template < typename Links >
+    typename Links::ref merge_chains( const Links & l, typename Links::ref a, typename Links::ref b ) {
+        using ref = typename Links::ref;
+        ref first = l.nil();
+        ref last = l.nil();
+        while ( a != l.nil() and b != l.nil() ) {
+            ref n;
+            if ( l.value( b ) < l.value( a ) ) { n = b; b = l.next( b ); }
+            else                               { n = a; a = l.next( a ); }
+            if ( last == l.nil() )
+                first = n;
+            else
+                l.set_next( last, n );
+            last = n;
+            l.step();
+        }
+        ref rest = ( a != l.nil() ) ? a : b;
+        if ( last == l.nil() )
+            return rest;
+        l.set_next( last, rest );
+        return first;
+    }
+
+    /**
+     * @brief Sorts the chain that starts at `first` and ends at `nil()`, and returns its new first node.
+     *
+     * Bottom-up merge sort: `runs[i]` holds a sorted run of 2^i nodes. Each node is merged
+     * into the runs like a carry in a binary counter, so it takes O(n log n) comparisons and
+     * no memory beyond the 64 runs. Earlier nodes always end up on the left side of a merge,
+     * so the sort is stable. Only `next` links change; the caller restores the others.
+     */
+    template < typename Links >
+    typename Links::ref sort_chain( const Links & l, typename Links::ref first ) {
+        using ref = typename Links::ref;
+        ref runs[ 64 ];
+        size_t n_runs{0};
+        while ( first != l.nil() ) {
+            ref carry = first;
+            first = l.next( first );
+            l.set_next( carry, l.nil() );
+            size_t i{0};
+            for ( ; i < n_runs and runs[i] != l.nil(); ++i ) {
+                carry = merge_chains( l, runs[i], carry );
+                runs[i] = l.nil();
+            }
+            runs[i] = carry;
+            if ( i == n_runs )
+                ++n_runs;
+        }
+        ref sorted = l.nil();
+        for ( size_t i{0}; i < n_runs; ++i )
+            sorted = merge_chains( l, runs[i], sorted );
+        return sorted;
+    }
+
+    /// Returns the first node in [first, last) holding value_, or `last` if there is none.
+    template < typename Links, typename T >
+    typename Links::ref find_node( const Links & l, typename Links::ref first, typename Links::ref last, const T & value_ ) {
+        while ( first != last and not ( l.value( first ) == value_ ) ) {
+            first = l.next( first );
+            l.step();
+        }
+        return first;
+    }
+
+    /// Counts the nodes in [first, last) holding value_.
+    template < typename Links, typename T >
+    size_t count_nodes( const Links & l, typename Links::ref first, typename Links::ref last, const T & value_ ) {
+        size_t n{0};
+        for ( ; first != last; first = l.next( first ) )
+            if ( l.value( first ) == value_ )
+                ++n;
+        return n;
+    }
+
+    /// Returns the first node in [first, last) holding the smallest element, or `last` if the range is empty.
+    template < typename Links >
+    typename Links::ref min_node( const Links & l, typename Links::ref first, typename Links::ref last ) {
+        typename Links::ref best = first;
+        for ( ; first != last; first = l.next( first ) )
+            if ( l.value( first ) < l.value( best ) )
+                best = first;
+        return best;
+    }
+
+    /// Returns the first node in [first, last) holding the largest element, or `last` if the range is empty.
+    template < typename Links >
+    typename Links::ref max_node( const Links & l, typename Links::ref first, typename Links::ref last ) {
+        typename Links::ref best = first;
+        for ( ; first != last; first = l.next( first ) )
+            if ( l.value( best ) < l.value( first ) )
+                best = first;
+        return best;
+    }
+
+    /// Adds the elements in [first, last) to init_, from front to back.
+    template < typename Links, typename Acc >
+    Acc accumulate_nodes( const Links & l, typename Links::ref first, typename Links::ref last, Acc init_ ) {
+        for ( ; first != last; first = l.next( first ) )
+            init_ = init_ + l.value( first );
+        return init_;
+    }
+
+} // namespace detail
+} // namespace sc
+
+#endif
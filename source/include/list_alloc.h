@@ -0,0 +1,271 @@
+#ifndef _LIST_ALLOC_H_
+#define _LIST_ALLOC_H_
+
+/*!
+ * @file list_alloc.h
+ * @brief Where `sc::list` gets its nodes from.
+ *
+ * `sc::list` takes an allocation policy as its third template argument. The
+ * default one, `sc::heap_nodes`, hands every node to the global `operator new`
+ * and `operator delete`. `sc::node_cache` keeps per-thread pools of nodes
+ * instead, for pipelines where lists are built on one thread and destroyed on
+ * another:
+ *
+ *     using pipe_list = sc::list< int, sc::no_stats, sc::node_cache >;
+ *
+ * A policy has two static members, called with the size and alignment of a node:
+ *
+ *     static void * allocate( size_t bytes, size_t align );
+ *     static void deallocate( void * p, size_t bytes, size_t align ) noexcept;
+ */
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>   // malloc
+#include <mutex>
+#include <new>
+
+namespace sc {
+
+    /// The default policy: every node comes from the global allocator.
+    struct heap_nodes {
+        static void * allocate( size_t bytes, size_t align ) {
+#if defined(__cpp_aligned_new)
+            if ( align > __STDCPP_DEFAULT_NEW_ALIGNMENT__ )
+                return ::operator new( bytes, std::align_val_t( align ) );
+#endif
+            (void)align;
+            return ::operator new( bytes );
+        }
+        static void deallocate( void * p, size_t bytes, size_t align ) noexcept {
+#if defined(__cpp_aligned_new)
+            if ( align > __STDCPP_DEFAULT_NEW_ALIGNMENT__ ) {
+                ::operator delete( p, std::align_val_t( align ) );
+                return;
+            }
+#endif
+            (void)bytes;
+            (void)align;
+            ::operator delete( p );
+        }
+    };
+
+    namespace cache {
+        constexpr size_t chunk_bytes = size_t{1} << 16; //!< Nodes are carved out of 64 KiB chunks, aligned to their size.
+        constexpr size_t granule = 16;                  //!< Node sizes are rounded up to a multiple of this.
+        constexpr size_t n_classes = 16;                //!< So nodes of up to 256 bytes are cached.
+        constexpr size_t magazine_size = 64;            //!< Nodes freed for another thread are handed back this many at a time.
+        constexpr size_t n_magazines = 8;               //!< Threads a thread fills magazines for at once.
+
+        /// A free node, linked into a free list.
+        struct block { block * next; };
+
+        /*!
+         * The nodes of one thread. Only the owner takes nodes from `local`; other threads
+         * push the nodes they free onto `remote`, a whole magazine at a time, and the owner
+         * takes them all back in one exchange once `local` runs dry. A pool outlives its
+         * thread: it is then abandoned, and the next thread that needs a pool adopts it.
+         */
+        struct pool {
+            block * local[ n_classes ];
+            std::atomic< block * > remote[ n_classes ];
+            char * bump{ nullptr };     //!< Next free byte of the chunk being carved.
+            char * bump_end{ nullptr };
+            pool * next_abandoned{ nullptr };
+
+            pool() {
+                for ( size_t i{0}; i < n_classes; ++i ) {
+                    local[i] = nullptr;
+                    remote[i].store( nullptr, std::memory_order_relaxed );
+                }
+            }
+        };
+
+        /// Sits at the start of every chunk, so any node finds its pool by masking its address.
+        struct alignas( 64 ) chunk_header { pool * owner; };
+
+        inline pool * owner_of( void * p ) {
+            auto addr = reinterpret_cast< std::uintptr_t >( p ) & ~static_cast< std::uintptr_t >( chunk_bytes - 1 );
+            return reinterpret_cast< chunk_header * >( addr )->owner;
+        }
+        /// Pushes the chain [first, last] onto the remote free list of `owner`.
+        inline void push_remote( pool * owner, size_t cls, block * first, block * last ) {
+            block * head = owner->remote[ cls ].load( std::memory_order_relaxed );
+            do {
+                last->next = head;
+            } while ( not owner->remote[ cls ].compare_exchange_weak( head, first, std::memory_order_release,
+                                                                       std::memory_order_relaxed ) );
+        }
+
+        /// Pools whose threads have exited, and the one used by threads already being torn down.
+        struct registry {
+            std::mutex lock;
+            pool * abandoned{ nullptr };
+            pool * fallback{ nullptr };
+
+            static registry & global( void ) {
+                static registry r;
+                return r;
+            }
+            /// Adopts an abandoned pool, or creates a new one.
+            pool * acquire( void ) {
+                std::lock_guard< std::mutex > guard{ lock };
+                if ( abandoned == nullptr )
+                    return new pool;
+                pool * p = abandoned;
+                abandoned = p->next_abandoned;
+                return p;
+            }
+            void abandon( pool * p ) {
+                std::lock_guard< std::mutex > guard{ lock };
+                p->next_abandoned = abandoned;
+                abandoned = p;
+            }
+        };
+
+        /// Nodes freed on this thread for another one, gathered until there are enough to hand back.
+        struct magazine {
+            pool * owner{ nullptr };
+            size_t cls{0};
+            block * first{ nullptr };
+            block * last{ nullptr };
+            size_t count{0};
+
+            void flush( void ) {
+                if ( count != 0 )
+                    push_remote( owner, cls, first, last );
+                owner = nullptr;
+                first = last = nullptr;
+                count = 0;
+            }
+        };
+
+        /// 0 before this thread's cache exists, 1 while it does, 2 after it was destroyed.
+        inline int & thread_state( void ) {
+            static thread_local int state{0};
+            return state;
+        }
+
+        /// What a thread keeps: its own pool, and the magazines it fills for others.
+        struct thread_cache {
+            pool * mine{ nullptr };
+            magazine mags[ n_magazines ];
+            size_t victim{0};
+
+            thread_cache() { thread_state() = 1; }
+            ~thread_cache() {
+                for ( auto & m : mags )
+                    m.flush();
+                if ( mine != nullptr )
+                    registry::global().abandon( mine );
+                thread_state() = 2;
+            }
+            pool * own( void ) {
+                if ( mine == nullptr )
+                    mine = registry::global().acquire();
+                return mine;
+            }
+            /// Adds a node freed for `owner` to its magazine, handing the magazine back once full.
+            void stash( pool * owner, size_t cls, block * b ) {
+                magazine * m{ nullptr };
+                for ( auto & candidate : mags )
+                    if ( candidate.owner == owner and candidate.cls == cls ) {
+                        m = &candidate;
+                        break;
+                    }
+                if ( m == nullptr ) {
+                    m = &mags[ victim ];
+                    victim = ( victim + 1 ) % n_magazines;
+                    m->flush();
+                    m->owner = owner;
+                    m->cls = cls;
+                }
+                b->next = m->first;
+                m->first = b;
+                if ( m->count++ == 0 )
+                    m->last = b;
+                if ( m->count == magazine_size )
+                    m->flush();
+            }
+        };
+
+        /// The cache of the calling thread, or nullptr once it was destroyed, at thread exit.
+        inline thread_cache * this_thread( void ) {
+            if ( thread_state() == 2 )
+                return nullptr;
+            static thread_local thread_cache tc;
+            return &tc;
+        }
+
+        /// Takes a node of class `cls` from `p`: a local one, else one freed remotely, else a new one.
+        inline void * take( pool * p, size_t cls ) {
+            block * b = p->local[ cls ];
+            if ( b == nullptr )
+                b = p->remote[ cls ].exchange( nullptr, std::memory_order_acquire );
+            if ( b != nullptr ) {
+                p->local[ cls ] = b->next;
+                return b;
+            }
+            const size_t bytes = ( cls + 1 ) * granule;
+            if ( p->bump == nullptr or p->bump + bytes > p->bump_end ) {
+                void * raw{ nullptr };
+                if ( ::posix_memalign( &raw, chunk_bytes, chunk_bytes ) != 0 )
+                    throw std::bad_alloc{};
+                static_cast< chunk_header * >( raw )->owner = p;
+                p->bump = static_cast< char * >( raw ) + sizeof( chunk_header );
+                p->bump_end = static_cast< char * >( raw ) + chunk_bytes;
+            }
+            void * n = p->bump;
+            p->bump += bytes;
+            return n;
+        }
+    }
+
+    /*!
+     * Per-thread node pools. A node goes back to the pool of the thread that allocated it:
+     * straight away if the same thread frees it, otherwise in a magazine of up to 64 nodes,
+     * which the freeing thread hands over with a single atomic operation. The global
+     * allocator is only asked for 64 KiB chunks, so threads do not contend on its locks.
+     *
+     * Chunks are never returned to the system; a pool keeps them for its next nodes, and
+     * outlives its thread to be adopted by a later one. Nodes larger than 256 bytes, or
+     * aligned to more than 16, come from the global allocator as with `heap_nodes`.
+     *
+     * POSIX only (`posix_memalign`).
+     */
+    struct node_cache {
+        static void * allocate( size_t bytes, size_t align ) {
+            if ( bytes > cache::n_classes * cache::granule or align > cache::granule )
+                return heap_nodes::allocate( bytes, align );
+            const size_t cls = ( bytes - 1 ) / cache::granule;
+            if ( cache::thread_cache * tc = cache::this_thread() )
+                return cache::take( tc->own(), cls );
+            // The thread is exiting and its cache is gone: share a pool under the lock.
+            cache::registry & r = cache::registry::global();
+            std::lock_guard< std::mutex > guard{ r.lock };
+            if ( r.fallback == nullptr )
+                r.fallback = new cache::pool;
+            return cache::take( r.fallback, cls );
+        }
+        static void deallocate( void * p, size_t bytes, size_t align ) noexcept {
+            if ( bytes > cache::n_classes * cache::granule or align > cache::granule ) {
+                heap_nodes::deallocate( p, bytes, align );
+                return;
+            }
+            const size_t cls = ( bytes - 1 ) / cache::granule;
+            cache::block * b = static_cast< cache::block * >( p );
+            cache::pool * owner = cache::owner_of( p );
+            cache::thread_cache * tc = cache::this_thread();
+            if ( tc != nullptr and owner == tc->mine ) {
+                b->next = owner->local[ cls ];
+                owner->local[ cls ] = b;
+            }
+            else if ( tc != nullptr )
+                tc->stash( owner, cls, b );
+            else
+                cache::push_remote( owner, cls, b, b );
+        }
+    };
+}
+#endif
@@ -0,0 +1,392 @@
+#ifndef _LIST_BINARY_H_
+#define _LIST_BINARY_H_
+
+/*!
+ * @file list_binary.h
+ * @brief Binary snapshot (save/load) of `sc::list` objects.
+ *
+ * A snapshot is laid out as
+ *
+ *     +--------+---------+------+-----------+-------+---------+----------+
+ *     | magic  | version | kind | byte order| width |  count  | payload  | checksum
+ *     | 8 B    | u16     | u8   | u32       | u32   |  u64    | ...      | u64
+ *     +--------+---------+------+-----------+-------+---------+----------+
+ *
+ * where `kind` tells whether the payload is a raw copy of the elements (only
+ * for trivially copyable types) or a sequence of records written by a
+ * per-element `codec`. Integers are stored in the byte order of the machine
+ * that wrote the file; loading a file with a different byte order is rejected.
+ */
+
+#include <algorithm> // min, max
+#include <cstdint>
+#include <cstring>    // memcpy
+#include <fstream>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "list.h"
+
+namespace sc {
+
+    /// Thrown whenever a snapshot cannot be written or read back.
+    class list_io_error : public std::runtime_error {
+        public:
+            explicit list_io_error( const std::string & msg ) : std::runtime_error{ msg } { /* empty */ }
+    };
+
+    /*!
+     * Per-element codec used to serialize types that are not trivially copyable.
+     * Specialize it for your own types with two static members:
+     *
+     *     template < typename Writer > static void encode( Writer & w, const T & value );
+     *     template < typename Reader > static T decode( Reader & r );
+     */
+    template < typename T >
+    struct codec;
+
+    /// Codec for strings: the length followed by the raw characters.
+    template <>
+    struct codec< std::string > {
+        template < typename Writer >
+        static void encode( Writer & w, const std::string & value ) {
+            w.put( static_cast< std::uint64_t >( value.size() ) );
+            w.write( value.data(), value.size() );
+        }
+        /// A corrupt length is rejected before anything is allocated for it. When the stream cannot
+        /// tell how much is left, the string grows as its bytes arrive, so the length runs into the
+        /// end of the stream rather than into the allocator.
+        template < typename Reader >
+        static std::string decode( Reader & r ) {
+            const auto size = r.template get< std::uint64_t >();
+            const auto left = r.remaining();
+            if ( size > left )
+                throw list_io_error( "sc::list: string runs past the end of the snapshot" );
+            std::string value;
+            if ( left != UINT64_MAX )
+                value.reserve( static_cast< size_t >( size ) );
+            while ( value.size() < size ) {
+                size_t at = value.size();
+                value.resize( at + static_cast< size_t >( std::min< std::uint64_t >( size - at, 1 << 16 ) ) );
+                r.read( &value[at], value.size() - at );
+            }
+            return value;
+        }
+    };
+
+    namespace binary {
+        constexpr char magic[8] = { 'S', 'C', 'L', 'I', 'S', 'T', '\0', '\x1a' };
+        constexpr std::uint16_t version = 1;
+        constexpr std::uint32_t byte_order_mark = 0x01020304;
+        constexpr size_t buffer_size = size_t{1} << 20; //!< Size of the staging buffer, 1 MiB.
+
+        /// How the payload of a snapshot is encoded.
+        enum class kind_t : std::uint8_t { RAW = 0, CODEC = 1 };
+
+        /// Running checksum over the payload. It mixes 8 bytes at a time, so it keeps up with the disk.
+        /// The result only depends on the bytes fed, not on how they were split across `update()` calls.
+        class checksum {
+            private:
+                std::uint64_t m_hash{ 0xcbf29ce484222325ull };
+                char m_carry[8];     //!< Bytes of an incomplete word, waiting for the next update.
+                size_t m_carried{0}; //!< How many bytes are in `m_carry`.
+
+                void mix( const char * word8 ) {
+                    std::uint64_t word;
+                    std::memcpy( &word, word8, 8 );
+                    m_hash = ( m_hash ^ word ) * 0x100000001b3ull;
+                    m_hash ^= m_hash >> 29;
+                }
+            public:
+                void update( const char * data, size_t n ) {
+                    if ( m_carried != 0 ) { // Complete the pending word first.
+                        size_t take = std::min( sizeof( m_carry ) - m_carried, n );
+                        std::memcpy( m_carry + m_carried, data, take );
+                        m_carried += take;
+                        data += take;
+                        n -= take;
+                        if ( m_carried < sizeof( m_carry ) )
+                            return;
+                        mix( m_carry );
+                        m_carried = 0;
+                    }
+                    for ( ; n >= 8; n -= 8, data += 8 )
+                        mix( data );
+                    std::memcpy( m_carry, data, n );
+                    m_carried = n;
+                }
+                std::uint64_t value( void ) const {
+                    std::uint64_t hash{ m_hash };
+                    for ( size_t i{0}; i < m_carried; ++i )
+                        hash = ( hash ^ static_cast< unsigned char >( m_carry[i] ) ) * 0x100000001b3ull;
+                    return hash;
+                }
+        };
+
+        /// Buffered writer: gathers small writes into large blocks before handing them to the stream.
+        class writer {
+            private:
+                std::ostream & m_os;
+                std::vector< char > m_buffer;
+                size_t m_used;
+                checksum m_sum;
+
+            public:
+                explicit writer( std::ostream & os ) : m_os{ os }, m_buffer( buffer_size ), m_used{0} { /* empty */ }
+
+                /// Writes `n` bytes, that are covered by the checksum.
+                void write( const void * data, size_t n ) {
+                    const char * src = static_cast< const char * >( data );
+                    if ( m_used + n > m_buffer.size() )
+                        flush();
+                    if ( n >= m_buffer.size() ) { // Too big to stage, send it straight away.
+                        m_sum.update( src, n );
+                        put_raw( src, n );
+                        return;
+                    }
+                    std::memcpy( m_buffer.data() + m_used, src, n );
+                    m_used += n;
+                }
+                /// Writes a single trivially copyable value.
+                template < typename U >
+                void put( const U & value ) { write( &value, sizeof( U ) ); }
+                /// Hands the staged bytes to the stream.
+                void flush( void ) {
+                    m_sum.update( m_buffer.data(), m_used );
+                    put_raw( m_buffer.data(), m_used );
+                    m_used = 0;
+                }
+                /// Flushes the payload and appends its checksum, which is not covered by itself.
+                void finish( void ) {
+                    flush();
+                    std::uint64_t sum = m_sum.value();
+                    put_raw( reinterpret_cast< const char * >( &sum ), sizeof( sum ) );
+                    m_os.flush();
+                    if ( not m_os )
+                        throw list_io_error( "sc::list: failed to write snapshot" );
+                }
+                /// Staging area, so callers may fill it directly with `commit()`; grows to hold `n` bytes if it must.
+                char * reserve( size_t n ) {
+                    if ( m_used + n > m_buffer.size() )
+                        flush();
+                    if ( n > m_buffer.size() )
+                        m_buffer.resize( n );
+                    return m_buffer.data() + m_used;
+                }
+                void commit( size_t n ) { m_used += n; }
+
+            private:
+                void put_raw( const char * data, size_t n ) {
+                    if ( not m_os.write( data, static_cast< std::streamsize >( n ) ) )
+                        throw list_io_error( "sc::list: failed to write snapshot" );
+                }
+        };
+
+        /// Buffered reader, the counterpart of `writer`.
+        class reader {
+            private:
+                std::istream & m_is;
+                std::vector< char > m_buffer;
+                size_t m_pos;
+                size_t m_end;
+                checksum m_sum;
+                std::uint64_t m_stream_left; //!< Bytes the stream held past the buffer, or UINT64_MAX if unknown.
+
+            public:
+                explicit reader( std::istream & is )
+                    : m_is{ is }, m_buffer( buffer_size ), m_pos{0}, m_end{0}, m_stream_left{ UINT64_MAX } {
+                    // Measure the rest of the stream when it can seek, so lengths read from it can be checked.
+                    const std::istream::pos_type unknown( -1 );
+                    std::istream::pos_type here = m_is.tellg();
+                    if ( here == unknown )
+                        return;
+                    std::istream::pos_type end = m_is.seekg( 0, std::ios::end ) ? m_is.tellg() : unknown;
+                    m_is.clear();
+                    m_is.seekg( here );
+                    if ( end != unknown )
+                        m_stream_left = static_cast< std::uint64_t >( end - here );
+                }
+
+                /// At most how many bytes are left to read, or UINT64_MAX when the stream cannot tell.
+                std::uint64_t remaining( void ) const {
+                    return m_stream_left == UINT64_MAX ? UINT64_MAX : m_stream_left + ( m_end - m_pos );
+                }
+
+                /// Reads `n` bytes, that are covered by the checksum.
+                void read( void * data, size_t n ) {
+                    char * dst = static_cast< char * >( data );
+                    while ( n > 0 ) {
+                        if ( m_pos == m_end )
+                            refill();
+                        size_t chunk = std::min( n, m_end - m_pos );
+                        std::memcpy( dst, m_buffer.data() + m_pos, chunk );
+                        m_sum.update( dst, chunk );
+                        m_pos += chunk;
+                        dst += chunk;
+                        n -= chunk;
+                    }
+                }
+                /// Reads a single trivially copyable value.
+                template < typename U >
+                U get( void ) {
+                    U value;
+                    read( &value, sizeof( U ) );
+                    return value;
+                }
+                /// Reads the trailing checksum and compares it against the bytes read so far.
+                void verify( void ) {
+                    std::uint64_t expected{ m_sum.value() }, stored;
+                    char * dst = reinterpret_cast< char * >( &stored );
+                    for ( size_t i{0}; i < sizeof( stored ); ++i ) {
+                        if ( m_pos == m_end )
+                            refill();
+                        dst[i] = m_buffer[ m_pos++ ];
+                    }
+                    if ( stored != expected )
+                        throw list_io_error( "sc::list: snapshot checksum mismatch" );
+                }
+
+            private:
+                void refill( void ) {
+                    m_is.read( m_buffer.data(), static_cast< std::streamsize >( m_buffer.size() ) );
+                    m_end = static_cast< size_t >( m_is.gcount() );
+                    m_pos = 0;
+                    if ( m_stream_left != UINT64_MAX )
+                        m_stream_left -= std::min< std::uint64_t >( m_stream_left, m_end );
+                    if ( m_end == 0 )
+                        throw list_io_error( "sc::list: truncated snapshot" );
+                }
+        };
+
+        /// Payload of trivially copyable elements: the element bytes, back to back.
+        template < typename T, typename Codec, typename S, typename A >
+        void save_payload( writer & w, const sc::list< T, S, A > & l, std::true_type ) {
+            const size_t per_block = std::max< size_t >( 1, buffer_size / sizeof( T ) ); // Elements over the buffer size go one at a time.
+            auto it = l.cbegin();
+            while ( it != l.cend() ) {
+                char * dst = w.reserve( per_block * sizeof( T ) );
+                size_t n{0};
+                for ( ; n < per_block and it != l.cend(); ++n, ++it )
+                    std::memcpy( dst + n * sizeof( T ), &*it, sizeof( T ) );
+                w.commit( n * sizeof( T ) );
+            }
+        }
+        /// Payload of any other type: one codec record per element.
+        template < typename T, typename Codec, typename S, typename A >
+        void save_payload( writer & w, const sc::list< T, S, A > & l, std::false_type ) {
+            for ( auto it = l.cbegin(); it != l.cend(); ++it )
+                Codec::encode( w, *it );
+        }
+
+        template < typename T, typename Codec, typename S, typename A >
+        void load_payload( reader & r, sc::list< T, S, A > & l, std::uint64_t count, std::true_type ) {
+            using slot = typename std::aligned_storage< sizeof( T ), alignof( T ) >::type;
+            const size_t per_block = std::max< size_t >( 1, buffer_size / sizeof( T ) );
+            std::vector< slot > block( per_block );
+            const T * first = reinterpret_cast< const T * >( block.data() );
+            while ( count > 0 ) {
+                size_t n = static_cast< size_t >( std::min< std::uint64_t >( count, per_block ) );
+                r.read( block.data(), n * sizeof( T ) );
+                l.insert( l.end(), first, first + n );
+                count -= n;
+            }
+        }
+        template < typename T, typename Codec, typename S, typename A >
+        void load_payload( reader & r, sc::list< T, S, A > & l, std::uint64_t count, std::false_type ) {
+            // Decode a batch of elements, then hand it to the list as a single chain.
+            const size_t per_batch = 4096;
+            std::vector< T > batch;
+            batch.reserve( static_cast< size_t >( std::min< std::uint64_t >( count, per_batch ) ) );
+            while ( count > 0 ) {
+                batch.clear();
+                for ( ; count > 0 and batch.size() < per_batch; --count )
+                    batch.push_back( Codec::decode( r ) );
+                l.insert( l.end(), batch.begin(), batch.end() );
+            }
+        }
+
+        /// Whether elements of type T are stored raw, by memcpy.
+        template < typename T >
+        using is_raw = std::integral_constant< bool, std::is_trivially_copyable< T >::value >;
+    }
+
+    /*!
+     * Writes a binary snapshot of `l` into `os`, which should be opened in binary mode.
+     * Trivially copyable elements are copied in large blocks; any other type goes through `Codec`.
+     *
+     * @param l The list to save.
+     * @param os The destination stream.
+     * @throw list_io_error if the stream fails.
+     */
+    template < typename T, typename Codec = codec< T >, typename S = no_stats, typename A = heap_nodes >
+    void save( const sc::list< T, S, A > & l, std::ostream & os ) {
+        using raw = binary::is_raw< T >;
+        binary::writer w{ os };
+        w.write( binary::magic, sizeof( binary::magic ) );
+        w.put( binary::version );
+        w.put( static_cast< std::uint8_t >( raw::value ? binary::kind_t::RAW : binary::kind_t::CODEC ) );
+        w.put( binary::byte_order_mark );
+        w.put( static_cast< std::uint32_t >( raw::value ? sizeof( T ) : 0 ) );
+        w.put( static_cast< std::uint64_t >( l.size() ) );
+        binary::save_payload< T, Codec >( w, l, raw{} );
+        w.finish();
+    }
+
+    /*!
+     * Reads a snapshot written by `save()` from `is`, appending its elements to `l`.
+     * The stream is read in large blocks, so it may be consumed past the end of the snapshot.
+     * The elements are loaded into a list of their own, and spliced onto `l` once the checksum
+     * matches, so a failed load leaves `l` as it was.
+     *
+     * @param l The list that receives the elements.
+     * @param is The source stream.
+     * @throw list_io_error if the snapshot is malformed, was written for another type or byte order,
+     *        or fails its checksum.
+     */
+    template < typename T, typename Codec = codec< T >, typename S = no_stats, typename A = heap_nodes >
+    void load( sc::list< T, S, A > & l, std::istream & is ) {
+        using raw = binary::is_raw< T >;
+        binary::reader r{ is };
+        char magic[ sizeof( binary::magic ) ];
+        r.read( magic, sizeof( magic ) );
+        if ( std::memcmp( magic, binary::magic, sizeof( magic ) ) != 0 )
+            throw list_io_error( "sc::list: not a list snapshot" );
+        if ( r.get< std::uint16_t >() != binary::version )
+            throw list_io_error( "sc::list: unsupported snapshot version" );
+        auto kind = static_cast< binary::kind_t >( r.get< std::uint8_t >() );
+        if ( r.get< std::uint32_t >() != binary::byte_order_mark )
+            throw list_io_error( "sc::list: snapshot byte order does not match this machine" );
+        auto width = r.get< std::uint32_t >();
+        if ( kind != ( raw::value ? binary::kind_t::RAW : binary::kind_t::CODEC ) or
+             width != ( raw::value ? sizeof( T ) : 0 ) )
+            throw list_io_error( "sc::list: snapshot was written for another element type" );
+        auto count = r.get< std::uint64_t >();
+        sc::list< T, S, A > loaded;
+        binary::load_payload< T, Codec >( r, loaded, count, raw{} );
+        r.verify();
+        l.splice( l.cend(), loaded );
+    }
+
+    /// Saves `l` into the file `filename`, replacing its contents.
+    template < typename T, typename Codec = codec< T >, typename S = no_stats, typename A = heap_nodes >
+    void save( const sc::list< T, S, A > & l, const std::string & filename ) {
+        std::ofstream ofs{ filename, std::ios::binary | std::ios::trunc };
+        if ( not ofs )
+            throw list_io_error( "sc::list: cannot open " + filename );
+        save< T, Codec >( l, ofs );
+    }
+
+    /// Appends to `l` the elements of the snapshot stored in the file `filename`.
+    template < typename T, typename Codec = codec< T >, typename S = no_stats, typename A = heap_nodes >
+    void load( sc::list< T, S, A > & l, const std::string & filename ) {
+        std::ifstream ifs{ filename, std::ios::binary };
+        if ( not ifs )
+            throw list_io_error( "sc::list: cannot open " + filename );
+        load< T, Codec >( l, ifs );
+    }
+}
+#endif
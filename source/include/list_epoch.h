@@ -0,0 +1,248 @@
+#ifndef _LIST_EPOCH_H_
+#define _LIST_EPOCH_H_
+
+/*!
+ * @file list_epoch.h
+ * @brief Epoch-based reclamation, so readers may walk a list while a writer erases from it.
+ *
+ * A list whose nodes come from `sc::epoch_nodes` does not free a node when it is
+ * erased: it retires it, and the node (element included) is destroyed only once
+ * every reader that might still hold it has left its critical section. Readers
+ * mark their critical sections with `sc::epoch::guard`, and walk the list with its
+ * ordinary iterators, without locks or reference counts:
+ *
+ *     using shared_list = sc::list< std::string, sc::no_stats, sc::epoch_nodes<> >;
+ *     shared_list names;
+ *
+ *     // Readers, on any number of threads.
+ *     {
+ *         sc::epoch::guard g;
+ *         for ( auto it = names.cbegin(); it != names.cend(); ++it )
+ *             use( *it );
+ *     }
+ *
+ *     // The writer (one at a time).
+ *     names.erase( it );
+ *     names.push_back( "x" );
+ *
+ * While readers are inside a guard, the writer may insert, push, pop, erase,
+ * remove, `unique()` and `clear()`. Operations that relink or overwrite nodes in
+ * place (`sort()`, `reverse()`, `splice()`, `merge()`, the assignments) and the
+ * destruction of the list still need the readers out. Readers use iterators
+ * only; `size()`, `front()` and `back()` are for the writer.
+ *
+ * How it works: a global epoch counter advances when every reader inside a guard
+ * has seen its current value. A node retired at epoch e is freed once the counter
+ * reaches e + 2, by which point no reader that entered before it was unlinked can
+ * still be inside its guard. Each thread keeps the nodes it retired in three bags,
+ * one per epoch modulo 3, and empties a bag when it comes round again.
+ */
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "list_alloc.h"
+
+namespace sc {
+
+    namespace epoch {
+        constexpr size_t advance_every = 64; //!< Retires between two attempts to advance the epoch.
+
+        /// A node waiting for the readers to leave, and how to destroy it.
+        struct retired {
+            void * p;
+            void (*dispose)( void * );
+        };
+
+        /*!
+         * The epoch state of one thread. Records are never freed: when a thread exits, its
+         * record is released with the nodes it still holds, and reused by a later thread.
+         */
+        struct alignas( 64 ) record {
+            std::atomic< uint64_t > state{0};    //!< (epoch << 1) | 1 while inside a guard, 0 otherwise.
+            std::atomic< bool > in_use{ true };
+            record * next{ nullptr };
+            size_t depth{0};                     //!< Nested guards.
+            size_t since_advance{0};
+            std::vector< retired > bags[3];      //!< Retired nodes, by epoch modulo 3.
+            uint64_t bag_epoch[3]{ 0, 0, 0 };    //!< The epoch the nodes in each bag were retired at.
+
+            /// Destroys the nodes in bag `i`. They are moved out first, since destroying an
+            /// element may retire more nodes.
+            size_t empty_bag( size_t i ) {
+                std::vector< retired > doomed;
+                doomed.swap( bags[i] );
+                for ( const auto & r : doomed )
+                    r.dispose( r.p );
+                return doomed.size();
+            }
+        };
+
+        /// The global epoch and every thread's record.
+        struct domain {
+            std::atomic< uint64_t > epoch{0};
+            std::atomic< record * > records{ nullptr };
+
+            static domain & global( void ) {
+                static domain d;
+                return d;
+            }
+            /// Claims a released record, or adds a new one.
+            record * acquire( void ) {
+                for ( record * r = records.load( std::memory_order_acquire ); r != nullptr; r = r->next ) {
+                    bool expected{ false };
+                    if ( r->in_use.compare_exchange_strong( expected, true, std::memory_order_acquire ) )
+                        return r;
+                }
+                record * r = new record;
+                r->next = records.load( std::memory_order_relaxed );
+                while ( not records.compare_exchange_weak( r->next, r, std::memory_order_release,
+                                                           std::memory_order_relaxed ) )
+                    ; // retry with the new head.
+                return r;
+            }
+            void release( record * r ) { r->in_use.store( false, std::memory_order_release ); }
+            /// Moves the epoch past `e` if every reader inside a guard has seen `e`.
+            bool try_advance( uint64_t e ) {
+                std::atomic_thread_fence( std::memory_order_seq_cst );
+                for ( record * r = records.load( std::memory_order_acquire ); r != nullptr; r = r->next ) {
+                    uint64_t s = r->state.load( std::memory_order_acquire );
+                    if ( ( s & 1 ) and ( s >> 1 ) != e )
+                        return false;
+                }
+                return epoch.compare_exchange_strong( e, e + 1, std::memory_order_seq_cst );
+            }
+        };
+
+        /// 0 before this thread's record exists, 1 while it does, 2 after it was released.
+        inline int & thread_state( void ) {
+            static thread_local int state{0};
+            return state;
+        }
+
+        /// Holds the record of a thread for as long as the thread lives.
+        struct thread_handle {
+            record * rec;
+            thread_handle() : rec{ domain::global().acquire() } { thread_state() = 1; }
+            ~thread_handle() {
+                domain::global().release( rec );
+                thread_state() = 2;
+            }
+        };
+
+        /// The record of the calling thread, or nullptr once it was released, at thread exit.
+        inline record * this_thread( void ) {
+            if ( thread_state() == 2 )
+                return nullptr;
+            static thread_local thread_handle h;
+            return h.rec;
+        }
+
+        inline void retire( record * r, void * p, void (*dispose)( void * ) ) {
+            domain & d = domain::global();
+            // The unlinking stores must be visible before the epoch is read.
+            std::atomic_thread_fence( std::memory_order_seq_cst );
+            uint64_t e = d.epoch.load( std::memory_order_seq_cst );
+            size_t i = e % 3;
+            if ( r->bag_epoch[i] != e ) {
+                // Retired at e - 3 or before: every reader has left since.
+                r->bag_epoch[i] = e;
+                r->empty_bag( i );
+            }
+            r->bags[i].push_back( retired{ p, dispose } );
+            if ( ++r->since_advance >= advance_every ) {
+                r->since_advance = 0;
+                d.try_advance( e );
+            }
+        }
+
+        /*!
+         * Marks a critical section in which the calling thread reads lists of `sc::epoch_nodes`.
+         * No node that was reachable when the guard was made is freed before it is destroyed.
+         * Guards nest; only the outermost one costs anything.
+         */
+        class guard {
+            private:
+                record * m_rec;
+                bool m_borrowed; //!< The thread's own record was gone, so this one was claimed for the guard.
+
+            public:
+                guard() : m_rec{ this_thread() }, m_borrowed{ m_rec == nullptr } {
+                    if ( m_borrowed )
+                        m_rec = domain::global().acquire();
+                    if ( m_rec->depth++ == 0 ) {
+                        uint64_t e = domain::global().epoch.load( std::memory_order_relaxed );
+                        // A full barrier, so the list is read only after the epoch is announced.
+                        m_rec->state.exchange( ( e << 1 ) | 1, std::memory_order_seq_cst );
+                    }
+                }
+                ~guard() {
+                    if ( --m_rec->depth == 0 )
+                        m_rec->state.store( 0, std::memory_order_release );
+                    if ( m_borrowed )
+                        domain::global().release( m_rec );
+                }
+                guard( const guard & ) = delete;
+                guard & operator=( const guard & ) = delete;
+        };
+
+        /// Retires `p`: `dispose( p )` runs once no reader can reach it any more.
+        inline void retire( void * p, void (*dispose)( void * ) ) {
+            if ( record * r = this_thread() ) {
+                retire( r, p, dispose );
+                return;
+            }
+            domain & d = domain::global();
+            record * r = d.acquire();
+            retire( r, p, dispose );
+            d.release( r );
+        }
+
+        /**
+         * @brief Tries to advance the epoch, then frees whatever is safe to free, both the nodes
+         *        this thread retired and those left behind by threads that exited.
+         *
+         * @return How many nodes were freed.
+         */
+        inline size_t collect( void ) {
+            domain & d = domain::global();
+            record * mine = this_thread();
+            d.try_advance( d.epoch.load( std::memory_order_seq_cst ) );
+            const uint64_t e = d.epoch.load( std::memory_order_seq_cst );
+            size_t freed{0};
+            for ( record * r = d.records.load( std::memory_order_acquire ); r != nullptr; r = r->next ) {
+                bool expected{ false };
+                if ( r != mine and not r->in_use.compare_exchange_strong( expected, true, std::memory_order_acquire ) )
+                    continue;
+                for ( size_t i{0}; i < 3; ++i )
+                    if ( r->bag_epoch[i] + 2 <= e )
+                        freed += r->empty_bag( i );
+                if ( r != mine )
+                    d.release( r );
+            }
+            return freed;
+        }
+
+        /// How many nodes this thread retired that are not freed yet.
+        inline size_t pending( void ) {
+            record * r = this_thread();
+            return r == nullptr ? 0 : r->bags[0].size() + r->bags[1].size() + r->bags[2].size();
+        }
+    }
+
+    /*!
+     * The allocation policy of lists read under `sc::epoch::guard`. Nodes come from `Base`,
+     * and erased ones are retired through `sc::epoch` rather than destroyed right away.
+     */
+    template < typename Base = heap_nodes >
+    struct epoch_nodes {
+        static constexpr bool defers_free = true; //!< Tells `sc::list` to call `retire()` instead of `delete`.
+
+        static void * allocate( size_t bytes, size_t align ) { return Base::allocate( bytes, align ); }
+        static void deallocate( void * p, size_t bytes, size_t align ) noexcept { Base::deallocate( p, bytes, align ); }
+        static void retire( void * p, void (*dispose)( void * ) ) { epoch::retire( p, dispose ); }
+    };
+}
+#endif
@@ -0,0 +1,157 @@
+#ifndef _LIST_QUEUE_H_
+#define _LIST_QUEUE_H_
+
+/*!
+ * @file list_queue.h
+ * @brief Work queues whose consumer takes everything pending as an `sc::list`.
+ *
+ * `sc::mpsc_list_queue<T>` takes pushes from any number of threads and
+ * `sc::spsc_list_queue<T>` from a single one; both have a single consumer. The
+ * queue is a chain of `sc::list` nodes, linked forwards through their `next`
+ * field, which is read and written atomically. A dummy node heads the chain:
+ *
+ *     head                                  tail
+ *      |                                     |
+ *      v                                     v
+ *     +-------+     +----+     +----+     +----+
+ *     | dummy |---->| n1 |---->| .. |---->| nk |---->nullptr
+ *     +-------+     +----+     +----+     +----+
+ *
+ * A push links a new node after `tail`, with one atomic exchange (MPSC) or a
+ * plain store (SPSC) and no loop, so it is wait-free. The consumer's `pop_all()`
+ * walks the chain up to the last node linked so far and relinks all of it into a
+ * list: `n1` to `nk-1` as they are, then the old dummy holding the value moved
+ * out of `nk`, which becomes the new dummy. No node is copied or allocated.
+ *
+ *     sc::mpsc_list_queue< job > q;
+ *     q.push( job{ ... } );              // any thread
+ *     sc::list< job > batch = q.pop_all(); // the consumer
+ *
+ * An MPSC push that has exchanged `tail` but not yet linked its node briefly
+ * hides the nodes pushed after it; the next `pop_all()` returns them.
+ */
+
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+#include <utility>   // move
+
+#include "list.h"
+
+namespace sc {
+
+    /*!
+     * A single consumer queue of `T`, built of the nodes of `sc::list< T, no_stats, Alloc >`.
+     * With `MultiProducer` any number of threads may push at once; without it, only one.
+     * Use the `mpsc_list_queue` and `spsc_list_queue` aliases.
+     */
+    template < typename T, typename Alloc, bool MultiProducer >
+    class list_queue
+    {
+        public:
+            using list_type = sc::list< T, no_stats, Alloc >; //!< What the consumer gets.
+            using value_type = T;
+            using size_type = size_t;
+
+        private:
+            using Node = typename list_type::Node;
+
+            // The dummy node is built empty, and `pop_all()` moves the last element into it.
+            static_assert( std::is_default_constructible< T >::value, "sc::list_queue needs a default constructible T for its dummy node." );
+            static_assert( std::is_move_assignable< T >::value, "sc::list_queue needs a move assignable T for its dummy node." );
+
+            /// Where producers link their nodes: shared by all of them, or owned by the only one.
+            template < bool Multi, typename Dummy = void >
+            struct tail_slot {
+                std::atomic< Node * > last;
+                explicit tail_slot( Node * n ) : last{ n } {}
+                Node * swap( Node * n ) { return last.exchange( n, std::memory_order_acq_rel ); }
+            };
+            template < typename Dummy >
+            struct tail_slot< false, Dummy > {
+                Node * last;
+                explicit tail_slot( Node * n ) : last{ n } {}
+                Node * swap( Node * n ) { Node * prev = last; last = n; return prev; }
+            };
+
+            // The consumer's end and the producers' end on their own cache lines.
+            alignas( 64 ) Node * m_head;
+            alignas( 64 ) tail_slot< MultiProducer > m_tail;
+
+            void link( Node * n ) {
+                Node * prev = m_tail.swap( n );
+                SC_STORE_LINK( prev->next, n );
+            }
+
+        public:
+            //=== Special members.
+            /// Constructs an empty queue.
+            list_queue() : m_head{ new Node() }, m_tail{ m_head } { /* empty */ }
+            /// Destroys the queue and whatever it still holds. No thread may be pushing.
+            ~list_queue() {
+                while ( m_head != nullptr ) {
+                    Node * next = m_head->next;
+                    delete m_head;
+                    m_head = next;
+                }
+            }
+            list_queue( const list_queue & ) = delete;
+            list_queue & operator=( const list_queue & ) = delete;
+
+            //=== Producers.
+            /// Appends a copy of `value`. Wait-free.
+            void push( const T & value ) { link( new Node( value ) ); }
+            /// Appends `value`, moved into the node. Wait-free.
+            void push( T && value ) { link( new Node( std::move( value ) ) ); }
+
+            //=== The consumer.
+            /// Whether nothing was pushed since the last `pop_all()`, as far as the consumer can see.
+            bool empty( void ) const { return SC_LOAD_LINK( m_head->next ) == nullptr; }
+            /**
+             * @brief Moves every element pushed so far to the end of `into`, in push order,
+             *        relinking the queue's nodes into it.
+             *
+             * @param into The list that receives the elements.
+             * @return How many elements were moved.
+             */
+            size_t pop_all( list_type & into ) {
+                Node * dummy = m_head;
+                Node * first = SC_LOAD_LINK( dummy->next );
+                if ( first == nullptr )
+                    return 0;
+                // Walk to the last node linked so far, restoring the back links on the way.
+                Node * last = first;
+                size_t count{1};
+                first->prev = nullptr;
+                for ( Node * n; ( n = SC_LOAD_LINK( last->next ) ) != nullptr; last = n, ++count )
+                    n->prev = last;
+                // Producers may still link after `last`, so it stays as the new dummy; the old
+                // one takes its value and goes last in the batch.
+                dummy->data = std::move( last->data );
+                dummy->next = nullptr;
+                m_head = last;
+                if ( count == 1 )
+                    first = dummy;
+                else {
+                    last->prev->next = dummy;
+                    dummy->prev = last->prev;
+                }
+                into.link_chain( into.m_tail, first, dummy, count );
+                return count;
+            }
+            /// Returns every element pushed so far, in push order, as a list.
+            list_type pop_all( void ) {
+                list_type batch;
+                pop_all( batch );
+                return batch;
+            }
+    };
+
+    /// A queue for many producers and one consumer.
+    template < typename T, typename Alloc = heap_nodes >
+    using mpsc_list_queue = list_queue< T, Alloc, true >;
+    /// A queue for one producer and one consumer.
+    template < typename T, typename Alloc = heap_nodes >
+    using spsc_list_queue = list_queue< T, Alloc, false >;
+}
+#endif
@@ -0,0 +1,190 @@
+#ifndef _LIST_STATS_H_
+#define _LIST_STATS_H_
+
+/*!
+ * @file list_stats.h
+ * @brief Optional instrumentation of `sc::list`.
+ *
+ * `sc::list` takes a statistics policy as its second template argument. The
+ * default one, `sc::no_stats`, has empty inline hooks and no data, so the
+ * instrumentation compiles away entirely. `sc::counting_stats` counts node
+ * allocations, traversals, element copies and calls per operation, both for
+ * the list that did them (see `list::stats()`) and in a process wide
+ * `sc::stats_registry`:
+ *
+ *     sc::list< int, sc::counting_stats > l{ 1, 2, 3 };
+ *     l.sort();
+ *     sc::list_stats s = l.stats();
+ *     sc::stats_registry::global().write_prometheus( std::cout );
+ */
+
+#include <atomic>
+#include <initializer_list>
+#include <cstddef>
+#include <ostream>
+
+namespace sc {
+
+    /// Operations whose calls are counted.
+    enum class list_op : int {
+        CONSTRUCT, COPY, ASSIGN, CLEAR, PUSH_FRONT, PUSH_BACK, POP_FRONT, POP_BACK,
+        INSERT, ERASE, MERGE, SPLICE, REVERSE, UNIQUE, SORT, FIND,
+        COUNT_ //!< Number of operations, not an operation.
+    };
+
+    /// Name of an operation, as used in the exported metrics.
+    inline const char * to_string( list_op op ) {
+        static const char * const names[] = {
+            "construct", "copy", "assign", "clear", "push_front", "push_back", "pop_front", "pop_back",
+            "insert", "erase", "merge", "splice", "reverse", "unique", "sort", "find" };
+        return names[ static_cast< int >( op ) ];
+    }
+
+    /// A snapshot of the counters.
+    struct list_stats {
+        static constexpr int n_ops = static_cast< int >( list_op::COUNT_ );
+
+        size_t node_allocs{0};     //!< Nodes allocated, sentinels included.
+        size_t node_frees{0};      //!< Nodes freed, sentinels included.
+        size_t bytes_live{0};      //!< Bytes held by nodes not freed yet; for a single list, by the nodes it holds.
+        size_t nodes_traversed{0}; //!< Links followed by iterator jumps, clear(), sort(), unique() and the searches.
+        size_t element_copies{0};  //!< Elements copied into a node.
+        size_t calls[ n_ops ]{};   //!< Calls of each public operation, indexed by `list_op`.
+
+        /// Calls of a given operation.
+        size_t operator[]( list_op op ) const { return calls[ static_cast< int >( op ) ]; }
+    };
+
+    /// Process wide totals, fed by every list that uses `counting_stats`.
+    class stats_registry {
+        private:
+            std::atomic< size_t > m_node_allocs{0};
+            std::atomic< size_t > m_node_frees{0};
+            std::atomic< size_t > m_bytes_allocated{0};
+            std::atomic< size_t > m_bytes_freed{0};
+            std::atomic< size_t > m_nodes_traversed{0};
+            std::atomic< size_t > m_element_copies{0};
+            std::atomic< size_t > m_calls[ list_stats::n_ops ];
+
+            static void add( std::atomic< size_t > & counter, size_t n ) {
+                counter.fetch_add( n, std::memory_order_relaxed );
+            }
+
+        public:
+            stats_registry() {
+                for ( auto & c : m_calls )
+                    c.store( 0, std::memory_order_relaxed );
+            }
+            stats_registry( const stats_registry & ) = delete;
+            stats_registry & operator=( const stats_registry & ) = delete;
+
+            /// The registry every `counting_stats` list reports to.
+            static stats_registry & global( void ) {
+                static stats_registry registry;
+                return registry;
+            }
+
+            void on_alloc( size_t bytes ) { add( m_node_allocs, 1 ); add( m_bytes_allocated, bytes ); }
+            void on_free( size_t bytes ) { add( m_node_frees, 1 ); add( m_bytes_freed, bytes ); }
+            void on_traverse( size_t n ) { add( m_nodes_traversed, n ); }
+            void on_copy( size_t n ) { add( m_element_copies, n ); }
+            void on_call( list_op op ) { add( m_calls[ static_cast< int >( op ) ], 1 ); }
+
+            /// Reads every counter. Counters are read one by one, so the snapshot is not atomic as a whole.
+            list_stats snapshot( void ) const {
+                list_stats s;
+                s.node_allocs = m_node_allocs.load( std::memory_order_relaxed );
+                s.node_frees = m_node_frees.load( std::memory_order_relaxed );
+                size_t allocated = m_bytes_allocated.load( std::memory_order_relaxed );
+                size_t freed = m_bytes_freed.load( std::memory_order_relaxed );
+                s.bytes_live = allocated > freed ? allocated - freed : 0;
+                s.nodes_traversed = m_nodes_traversed.load( std::memory_order_relaxed );
+                s.element_copies = m_element_copies.load( std::memory_order_relaxed );
+                for ( int i{0}; i < list_stats::n_ops; ++i )
+                    s.calls[i] = m_calls[i].load( std::memory_order_relaxed );
+                return s;
+            }
+            /// Sets every counter back to zero, except `bytes_live`, which still accounts for the lists alive.
+            void reset( void ) {
+                for ( auto c : { &m_node_allocs, &m_node_frees, &m_nodes_traversed, &m_element_copies } )
+                    c->store( 0, std::memory_order_relaxed );
+                for ( auto & c : m_calls )
+                    c.store( 0, std::memory_order_relaxed );
+            }
+            /// Writes the totals in the Prometheus text exposition format.
+            void write_prometheus( std::ostream & os ) const {
+                list_stats s = snapshot();
+                os << "# TYPE sc_list_node_allocs_total counter\n"
+                   << "sc_list_node_allocs_total " << s.node_allocs << '\n'
+                   << "# TYPE sc_list_node_frees_total counter\n"
+                   << "sc_list_node_frees_total " << s.node_frees << '\n'
+                   << "# TYPE sc_list_bytes_live gauge\n"
+                   << "sc_list_bytes_live " << s.bytes_live << '\n'
+                   << "# TYPE sc_list_nodes_traversed_total counter\n"
+                   << "sc_list_nodes_traversed_total " << s.nodes_traversed << '\n'
+                   << "# TYPE sc_list_element_copies_total counter\n"
+                   << "sc_list_element_copies_total " << s.element_copies << '\n'
+                   << "# TYPE sc_list_calls_total counter\n";
+                for ( int i{0}; i < list_stats::n_ops; ++i )
+                    os << "sc_list_calls_total{op=\"" << to_string( static_cast< list_op >( i ) ) << "\"} "
+                       << s.calls[i] << '\n';
+            }
+    };
+
+    /// The default policy: every hook is empty, so nothing is counted and nothing is stored.
+    struct no_stats {
+        void on_alloc( size_t ) const {}
+        void on_free( size_t ) const {}
+        void on_traverse( size_t ) const {}
+        void on_copy( size_t ) const {}
+        void on_call( list_op ) const {}
+        void on_adopt( size_t ) const {}
+        void on_release( size_t ) const {}
+        /// Iterators do not know their list, so their jumps are only seen by the registry.
+        static void on_walk( size_t ) {}
+        list_stats snapshot( void ) const { return list_stats{}; }
+    };
+
+    /// Counts everything, for the list itself and in `stats_registry::global()`.
+    class counting_stats {
+        private:
+            mutable list_stats m_local; //!< Mutable, so that const operations, like the searches, are counted too.
+
+        public:
+            void on_alloc( size_t bytes ) const {
+                ++m_local.node_allocs;
+                m_local.bytes_live += bytes;
+                stats_registry::global().on_alloc( bytes );
+            }
+            void on_free( size_t bytes ) const {
+                ++m_local.node_frees;
+                m_local.bytes_live -= bytes;
+                stats_registry::global().on_free( bytes );
+            }
+            void on_traverse( size_t n ) const {
+                m_local.nodes_traversed += n;
+                stats_registry::global().on_traverse( n );
+            }
+            void on_copy( size_t n ) const {
+                m_local.element_copies += n;
+                stats_registry::global().on_copy( n );
+            }
+            void on_call( list_op op ) const {
+                ++m_local.calls[ static_cast< int >( op ) ];
+                stats_registry::global().on_call( op );
+            }
+            /// Nodes another list handed over, by `splice()` or `merge()`. They are neither allocated nor freed.
+            void on_adopt( size_t bytes ) const {
+                m_local.bytes_live += bytes;
+            }
+            /// Nodes handed over to another list.
+            void on_release( size_t bytes ) const {
+                m_local.bytes_live -= bytes;
+            }
+            static void on_walk( size_t n ) {
+                stats_registry::global().on_traverse( n );
+            }
+            list_stats snapshot( void ) const { return m_local; }
+    };
+}
+#endif
@@ -0,0 +1,202 @@
+#ifndef _LIST_TEXT_H_
+#define _LIST_TEXT_H_
+
+/*!
+ * @file list_text.h
+ * @brief Bulk text import/export of `sc::list` objects holding numbers.
+ *
+ * The text format is a plain sequence of numbers separated by whitespace,
+ * the same one `operator<<` on a stream would produce without brackets.
+ * Numbers are converted with `std::from_chars`/`std::to_chars`, which do not
+ * touch the locale and do not go through a stream per element. Parsed values
+ * are appended to the list in batches, each one linked in as a single chain.
+ *
+ * Requires C++17.
+ */
+
+#include <algorithm>    // copy, max
+#include <charconv>     // from_chars, to_chars
+#include <fstream>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "list.h"
+
+namespace sc {
+
+    /// Thrown when the text holds something that is not a number of the requested type.
+    class list_parse_error : public std::runtime_error {
+        public:
+            list_parse_error( const std::string & msg, size_t offset )
+                : std::runtime_error{ msg + " at byte " + std::to_string( offset ) }, m_offset{ offset }
+            { /* empty */ }
+            /// Position of the offending token, counted from the beginning of the input.
+            size_t offset( void ) const { return m_offset; }
+        private:
+            size_t m_offset;
+    };
+
+    namespace text {
+        constexpr size_t batch_size = 64 * 1024;       //!< Values converted before they are linked into the list.
+        constexpr size_t buffer_size = size_t{1} << 20; //!< Bytes read from or written to a stream at a time.
+
+        inline bool is_space( char c ) {
+            return c == ' ' or c == '\n' or c == '\t' or c == '\r' or c == '\v' or c == '\f';
+        }
+
+        /*!
+         * Parses every complete token of [first, last) into `l`. When `more` is set, the input
+         * continues in a later call, so a token touching `last` is left unparsed.
+         *
+         * @param base Offset of `first` in the whole input, for error messages.
+         * @return Pointer to the first character that was not consumed.
+         */
+        template < typename T >
+        const char * parse_into( sc::list< T > & l, std::vector< T > & batch,
+                                 const char * first, const char * last, bool more, size_t base ) {
+            const char * p = first;
+            for ( ;; ) {
+                while ( p != last and is_space( *p ) )
+                    ++p;
+                const char * token = p;
+                while ( p != last and not is_space( *p ) )
+                    ++p;
+                if ( token == p or ( more and p == last ) ) {
+                    p = token;
+                    break;
+                }
+                const char * digits = ( *token == '+' and p - token > 1 ) ? token + 1 : token;
+                T value{};
+                auto res = std::from_chars( digits, p, value );
+                if ( digits != token and *digits == '-' ) // "+-5": only one sign is allowed.
+                    res.ec = std::errc::invalid_argument;
+                if ( res.ec == std::errc::result_out_of_range )
+                    throw list_parse_error( "sc::parse_list: value out of range", base + ( token - first ) );
+                if ( res.ec != std::errc{} or res.ptr != p )
+                    throw list_parse_error( "sc::parse_list: invalid number", base + ( token - first ) );
+                batch.push_back( value );
+                if ( batch.size() == batch_size ) {
+                    l.insert( l.end(), batch.begin(), batch.end() );
+                    batch.clear();
+                }
+            }
+            return p;
+        }
+    }
+
+    /*!
+     * Parses whitespace separated numbers.
+     *
+     * @param input The text to parse.
+     * @return A list with the numbers, in the order they appear.
+     * @throw list_parse_error if a token is not a number of type T, or does not fit in it.
+     */
+    template < typename T >
+    sc::list< T > parse_list( std::string_view input ) {
+        static_assert( std::is_arithmetic< T >::value, "sc::parse_list only reads numbers." );
+        sc::list< T > l;
+        std::vector< T > batch;
+        batch.reserve( text::batch_size );
+        text::parse_into( l, batch, input.data(), input.data() + input.size(), false, 0 );
+        l.insert( l.end(), batch.begin(), batch.end() );
+        return l;
+    }
+
+    /*!
+     * Parses whitespace separated numbers read from `is`. The stream is consumed in large blocks,
+     * so the whole input never has to be in memory at once.
+     *
+     * @throw list_parse_error if a token is not a number of type T, or does not fit in it.
+     */
+    template < typename T >
+    sc::list< T > parse_list( std::istream & is ) {
+        static_assert( std::is_arithmetic< T >::value, "sc::parse_list only reads numbers." );
+        sc::list< T > l;
+        std::vector< T > batch;
+        batch.reserve( text::batch_size );
+        std::vector< char > buffer( text::buffer_size );
+        size_t kept{0};   // Bytes of an incomplete token carried over from the previous block.
+        size_t base{0};   // Offset of buffer[0] in the whole input.
+        for ( ;; ) {
+            if ( kept == buffer.size() ) // A single token larger than the buffer.
+                buffer.resize( 2 * buffer.size() );
+            is.read( buffer.data() + kept, static_cast< std::streamsize >( buffer.size() - kept ) );
+            size_t got = static_cast< size_t >( is.gcount() );
+            bool more = got != 0;
+            const char * end = buffer.data() + kept + got;
+            const char * rest = text::parse_into( l, batch, buffer.data(), end, more, base );
+            if ( not more )
+                break;
+            kept = static_cast< size_t >( end - rest );
+            base += static_cast< size_t >( rest - buffer.data() );
+            std::copy( rest, end, buffer.data() );
+        }
+        l.insert( l.end(), batch.begin(), batch.end() );
+        return l;
+    }
+
+    /// Parses whitespace separated numbers from the file `filename`.
+    template < typename T >
+    sc::list< T > parse_list_file( const std::string & filename ) {
+        std::ifstream ifs{ filename, std::ios::binary };
+        if ( not ifs )
+            throw std::runtime_error( "sc::parse_list: cannot open " + filename );
+        return parse_list< T >( ifs );
+    }
+
+    /*!
+     * Appends the elements of `l` to `buffer`, separated by `sep`.
+     *
+     * @param l The list to format.
+     * @param buffer Where the text is appended.
+     * @param sep The separator written between two elements.
+     */
+    template < typename T, typename S, typename A >
+    void format_list( const sc::list< T, S, A > & l, std::string & buffer, char sep = ' ' ) {
+        static_assert( std::is_arithmetic< T >::value, "sc::format_list only writes numbers." );
+        // Enough room for the longest number of any arithmetic type, plus the separator.
+        constexpr size_t max_chars = 64;
+        size_t used = buffer.size();
+        for ( auto it = l.cbegin(); it != l.cend(); ++it ) {
+            if ( buffer.size() - used < max_chars )
+                buffer.resize( std::max( 2 * buffer.size(), used + 4096 ) );
+            char * p = &buffer[ used ];
+            if ( it != l.cbegin() )
+                *p++ = sep;
+            p = std::to_chars( p, &buffer[0] + buffer.size(), *it ).ptr;
+            used = static_cast< size_t >( p - &buffer[0] );
+        }
+        buffer.resize( used );
+    }
+
+    /*!
+     * Writes the elements of `l` to `os`, separated by `sep`, a large block at a time.
+     *
+     * @throw std::runtime_error if the stream fails.
+     */
+    template < typename T, typename S, typename A >
+    void format_list( const sc::list< T, S, A > & l, std::ostream & os, char sep = ' ' ) {
+        static_assert( std::is_arithmetic< T >::value, "sc::format_list only writes numbers." );
+        constexpr size_t max_chars = 64;
+        std::vector< char > buffer( text::buffer_size );
+        char * p = buffer.data();
+        char * const limit = buffer.data() + buffer.size() - max_chars;
+        for ( auto it = l.cbegin(); it != l.cend(); ++it ) {
+            if ( p >= limit ) {
+                os.write( buffer.data(), p - buffer.data() );
+                p = buffer.data();
+            }
+            if ( it != l.cbegin() )
+                *p++ = sep;
+            p = std::to_chars( p, buffer.data() + buffer.size(), *it ).ptr;
+        }
+        os.write( buffer.data(), p - buffer.data() );
+        if ( not os )
+            throw std::runtime_error( "sc::format_list: failed to write" );
+    }
+}
+#endif
@@ -0,0 +1,438 @@
+#ifndef _LIST_VIEWS_H_
+#define _LIST_VIEWS_H_
+
+/*!
+ * @file list_views.h
+ * @brief Lazy views over lists, composed with `|`, that copy and allocate nothing.
+ *
+ * A view wraps the iterators of a range (a list, or another view) and works out
+ * each element as it is reached. Chained views form a single pass: each `++` on
+ * the outer iterator pulls just enough elements through every stage.
+ *
+ *     sc::list< int > nums{ 1, 2, 3, 4, 5, 6, 7, 8 };
+ *     for ( int sq : nums | sc::views::filter( is_even ) | sc::views::transform( square ) | sc::views::take( 2 ) )
+ *         std::cout << sq << ' ';      // 4 16
+ *
+ * - `filter( pred )`: the elements for which `pred` holds.
+ * - `transform( f )`: `f` applied to every element.
+ * - `take( n )`, `drop( n )`: the first `n` elements, or all but them.
+ * - `chunk( n )`: consecutive sub-ranges of `n` elements (the last may be shorter).
+ * - `zip( other )`: pairs of references to the elements at the same position, up to
+ *   the end of the shorter range.
+ *
+ * Containers are held by reference, and must outlive their views; a view over a
+ * temporary container does not compile. Views are held by value, and iterators
+ * refer to the view they came from. With C++20 ranges, views derive from
+ * `std::ranges::view_base`, so `std::ranges` algorithms and adaptors accept them.
+ */
+
+#include <cstddef>
+#include <iterator>
+#include <new>
+#include <type_traits>
+#include <utility>   // declval, forward, pair
+#if __cplusplus >= 202002L
+#   include <ranges>
+#endif
+
+namespace sc {
+namespace views {
+
+    /// What all views derive from, so `|` can tell them apart from containers.
+#if defined(__cpp_lib_ranges)
+    struct view_base : std::ranges::view_base {};
+#else
+    struct view_base {};
+#endif
+
+    template < typename R >
+    using iterator_of = decltype( std::declval< const R & >().begin() );
+    /// A list iterator gives a const reference when it is itself const, so views dereference a copy.
+    template < typename It >
+    using reference_of = decltype( *std::declval< It & >() );
+    template < typename It >
+    reference_of< It > deref( It it ) { return *it; }
+
+    /*!
+     * Holds a function object, and makes it copy assignable, as iterators and views need to be,
+     * even when it is a lambda.
+     */
+    template < typename F >
+    class box {
+        private:
+            typename std::aligned_storage< sizeof( F ), alignof( F ) >::type m_storage;
+
+        public:
+            explicit box( const F & f ) { ::new ( static_cast< void * >( &m_storage ) ) F( f ); }
+            box( const box & other ) { ::new ( static_cast< void * >( &m_storage ) ) F( other.get() ); }
+            box & operator=( const box & other ) {
+                if ( this != &other ) {
+                    get().~F();
+                    ::new ( static_cast< void * >( &m_storage ) ) F( other.get() );
+                }
+                return *this;
+            }
+            ~box() { get().~F(); }
+            const F & get( void ) const { return *reinterpret_cast< const F * >( &m_storage ); }
+    };
+
+    /// A container, seen through a pointer: its `begin()` and `end()` are asked for every time.
+    template < typename C >
+    class ref_range : public view_base {
+        private:
+            C * m_c;
+
+        public:
+            explicit ref_range( C & c ) : m_c{ &c } {}
+            decltype( std::declval< C & >().begin() ) begin() const { return m_c->begin(); }
+            decltype( std::declval< C & >().end() ) end() const { return m_c->end(); }
+    };
+
+    /*!
+     * A base iterator, unchanged but for a const `*` that gives what the base gives, as
+     * `std::ranges` requires. The iterators of the other views do the same.
+     */
+    template < typename It >
+    class pass_iterator {
+        public:
+            using reference         = reference_of< It >;
+            using value_type        = typename std::decay< reference >::type;
+            using pointer           = typename std::add_pointer< reference >::type;
+            using difference_type   = std::ptrdiff_t;
+            using iterator_category = std::forward_iterator_tag;
+
+        private:
+            It m_cur;
+
+        public:
+            pass_iterator() = default;
+            explicit pass_iterator( It cur ) : m_cur{ cur } {}
+            It base( void ) const { return m_cur; }
+            reference operator*() const { return deref( m_cur ); }
+            pass_iterator & operator++() { ++m_cur; return *this; }
+            pass_iterator operator++(int) { pass_iterator temp{ *this }; ++m_cur; return temp; }
+            bool operator==( const pass_iterator & rhs ) const { return m_cur == rhs.m_cur; }
+            bool operator!=( const pass_iterator & rhs ) const { return not ( m_cur == rhs.m_cur ); }
+    };
+
+    /// A pair of iterators, as a range.
+    template < typename It >
+    class subrange : public view_base {
+        private:
+            It m_first;
+            It m_last;
+
+        public:
+            subrange() = default;
+            subrange( It first, It last ) : m_first{ first }, m_last{ last } {}
+            It begin() const { return m_first; }
+            It end() const { return m_last; }
+            bool empty( void ) const { return m_first == m_last; }
+    };
+
+    /// How `|` holds the range on its left: views by value, containers by reference.
+    template < typename R, bool View = std::is_base_of< view_base, typename std::decay< R >::type >::value >
+    struct as_range {
+        static_assert( std::is_lvalue_reference< R >::value,
+                       "sc::views: a view over a temporary container would dangle; name the container first" );
+        using type = ref_range< typename std::remove_reference< R >::type >;
+        static type wrap( R r ) { return type( r ); }
+    };
+    template < typename R >
+    struct as_range< R, true > {
+        using type = typename std::decay< R >::type;
+        template < typename V >
+        static type wrap( V && v ) { return type( std::forward< V >( v ) ); }
+    };
+    template < typename R >
+    using range_t = typename as_range< R >::type;
+
+    //=== filter
+    template < typename Base, typename Pred >
+    class filter_view : public view_base {
+        private:
+            using base_iterator = iterator_of< Base >;
+            Base m_base;
+            box< Pred > m_pred;
+
+        public:
+            class iterator {
+                public:
+                    using reference         = reference_of< base_iterator >;
+                    using value_type        = typename std::decay< reference >::type;
+                    using pointer           = typename std::add_pointer< reference >::type;
+                    using difference_type   = std::ptrdiff_t;
+                    using iterator_category = std::forward_iterator_tag;
+
+                private:
+                    base_iterator m_cur;
+                    base_iterator m_end;
+                    const Pred * m_pred;
+
+                    void skip( void ) {
+                        while ( m_cur != m_end and not ( *m_pred )( deref( m_cur ) ) )
+                            ++m_cur;
+                    }
+
+                public:
+                    iterator() : m_pred{ nullptr } {}
+                    iterator( base_iterator cur, base_iterator end, const Pred * pred )
+                        : m_cur{ cur }, m_end{ end }, m_pred{ pred } { skip(); }
+                    reference operator*() const { return deref( m_cur ); }
+                    iterator & operator++() { ++m_cur; skip(); return *this; }
+                    iterator operator++(int) { iterator temp{ *this }; ++*this; return temp; }
+                    bool operator==( const iterator & rhs ) const { return m_cur == rhs.m_cur; }
+                    bool operator!=( const iterator & rhs ) const { return not ( m_cur == rhs.m_cur ); }
+            };
+
+            filter_view( Base base, const Pred & pred ) : m_base( std::move( base ) ), m_pred( pred ) {}
+            /// Finds the first element that passes, so it is O(n) in the worst case.
+            iterator begin() const { return iterator( m_base.begin(), m_base.end(), &m_pred.get() ); }
+            iterator end() const { return iterator( m_base.end(), m_base.end(), &m_pred.get() ); }
+    };
+
+    //=== transform
+    template < typename Base, typename F >
+    class transform_view : public view_base {
+        private:
+            using base_iterator = iterator_of< Base >;
+            Base m_base;
+            box< F > m_fn;
+
+        public:
+            class iterator {
+                public:
+                    using reference         = decltype( std::declval< const F & >()( std::declval< reference_of< base_iterator > >() ) );
+                    using value_type        = typename std::decay< reference >::type;
+                    using pointer           = void;
+                    using difference_type   = std::ptrdiff_t;
+                    using iterator_category = std::input_iterator_tag;   //!< Elements are made on the fly.
+                    using iterator_concept  = std::forward_iterator_tag; //!< But they may be read again.
+
+                private:
+                    base_iterator m_cur;
+                    const F * m_fn;
+
+                public:
+                    iterator() : m_fn{ nullptr } {}
+                    iterator( base_iterator cur, const F * fn ) : m_cur{ cur }, m_fn{ fn } {}
+                    reference operator*() const { return ( *m_fn )( deref( m_cur ) ); }
+                    iterator & operator++() { ++m_cur; return *this; }
+                    iterator operator++(int) { iterator temp{ *this }; ++m_cur; return temp; }
+                    bool operator==( const iterator & rhs ) const { return m_cur == rhs.m_cur; }
+                    bool operator!=( const iterator & rhs ) const { return not ( m_cur == rhs.m_cur ); }
+            };
+
+            transform_view( Base base, const F & fn ) : m_base( std::move( base ) ), m_fn( fn ) {}
+            iterator begin() const { return iterator( m_base.begin(), &m_fn.get() ); }
+            iterator end() const { return iterator( m_base.end(), &m_fn.get() ); }
+    };
+
+    //=== take
+    template < typename Base >
+    class take_view : public view_base {
+        private:
+            using base_iterator = iterator_of< Base >;
+            Base m_base;
+            size_t m_count;
+
+        public:
+            class iterator {
+                public:
+                    using reference         = reference_of< base_iterator >;
+                    using value_type        = typename std::decay< reference >::type;
+                    using pointer           = typename std::add_pointer< reference >::type;
+                    using difference_type   = std::ptrdiff_t;
+                    using iterator_category = std::forward_iterator_tag;
+
+                private:
+                    base_iterator m_cur;
+                    size_t m_left; //!< Elements still to take.
+
+                public:
+                    iterator() : m_left{0} {}
+                    iterator( base_iterator cur, size_t left ) : m_cur{ cur }, m_left{ left } {}
+                    reference operator*() const { return deref( m_cur ); }
+                    iterator & operator++() { ++m_cur; --m_left; return *this; }
+                    iterator operator++(int) { iterator temp{ *this }; ++*this; return temp; }
+                    /// Equal at the same element, or once both took all they may.
+                    bool operator==( const iterator & rhs ) const {
+                        return m_cur == rhs.m_cur or ( m_left == 0 and rhs.m_left == 0 );
+                    }
+                    bool operator!=( const iterator & rhs ) const { return not ( *this == rhs ); }
+            };
+
+            take_view( Base base, size_t count ) : m_base( std::move( base ) ), m_count{ count } {}
+            iterator begin() const { return iterator( m_base.begin(), m_count ); }
+            iterator end() const { return iterator( m_base.end(), 0 ); }
+    };
+
+    //=== drop
+    template < typename Base >
+    class drop_view : public view_base {
+        private:
+            using base_iterator = iterator_of< Base >;
+            Base m_base;
+            size_t m_count;
+
+        public:
+            using iterator = pass_iterator< base_iterator >;
+
+            drop_view( Base base, size_t count ) : m_base( std::move( base ) ), m_count{ count } {}
+            /// Skips the dropped elements, so it is O(n).
+            iterator begin() const {
+                base_iterator it = m_base.begin();
+                base_iterator last = m_base.end();
+                for ( size_t i{0}; i < m_count and it != last; ++i )
+                    ++it;
+                return iterator( it );
+            }
+            iterator end() const { return iterator( m_base.end() ); }
+    };
+
+    //=== chunk
+    template < typename Base >
+    class chunk_view : public view_base {
+        private:
+            using base_iterator = iterator_of< Base >;
+            Base m_base;
+            size_t m_size;
+
+        public:
+            class iterator {
+                public:
+                    using reference         = subrange< pass_iterator< base_iterator > >;
+                    using value_type        = reference;
+                    using pointer           = void;
+                    using difference_type   = std::ptrdiff_t;
+                    using iterator_category = std::input_iterator_tag;
+                    using iterator_concept  = std::forward_iterator_tag;
+
+                private:
+                    base_iterator m_cur;
+                    base_iterator m_next; //!< Where the next chunk starts.
+                    base_iterator m_end;
+                    size_t m_size;
+
+                    void find_next( void ) {
+                        m_next = m_cur;
+                        for ( size_t i{0}; i < m_size and m_next != m_end; ++i )
+                            ++m_next;
+                    }
+
+                public:
+                    iterator() : m_size{0} {}
+                    iterator( base_iterator cur, base_iterator end, size_t size )
+                        : m_cur{ cur }, m_end{ end }, m_size{ size } { find_next(); }
+                    reference operator*() const {
+                        return reference( pass_iterator< base_iterator >( m_cur ), pass_iterator< base_iterator >( m_next ) );
+                    }
+                    iterator & operator++() { m_cur = m_next; find_next(); return *this; }
+                    iterator operator++(int) { iterator temp{ *this }; ++*this; return temp; }
+                    bool operator==( const iterator & rhs ) const { return m_cur == rhs.m_cur; }
+                    bool operator!=( const iterator & rhs ) const { return not ( m_cur == rhs.m_cur ); }
+            };
+
+            /// A chunk size of 0 is taken as 1.
+            chunk_view( Base base, size_t size ) : m_base( std::move( base ) ), m_size{ size == 0 ? 1 : size } {}
+            iterator begin() const { return iterator( m_base.begin(), m_base.end(), m_size ); }
+            iterator end() const { return iterator( m_base.end(), m_base.end(), m_size ); }
+    };
+
+    //=== zip
+    template < typename Base1, typename Base2 >
+    class zip_view : public view_base {
+        private:
+            using iterator1 = iterator_of< Base1 >;
+            using iterator2 = iterator_of< Base2 >;
+            Base1 m_base1;
+            Base2 m_base2;
+
+        public:
+            class iterator {
+                public:
+                    using reference         = std::pair< reference_of< iterator1 >, reference_of< iterator2 > >;
+                    using value_type        = std::pair< typename std::decay< reference_of< iterator1 > >::type,
+                                                         typename std::decay< reference_of< iterator2 > >::type >;
+                    using pointer           = void;
+                    using difference_type   = std::ptrdiff_t;
+                    using iterator_category = std::input_iterator_tag;
+                    using iterator_concept  = std::forward_iterator_tag;
+
+                private:
+                    iterator1 m_it1;
+                    iterator2 m_it2;
+
+                public:
+                    iterator() = default;
+                    iterator( iterator1 it1, iterator2 it2 ) : m_it1{ it1 }, m_it2{ it2 } {}
+                    reference operator*() const { return reference( deref( m_it1 ), deref( m_it2 ) ); }
+                    iterator & operator++() { ++m_it1; ++m_it2; return *this; }
+                    iterator operator++(int) { iterator temp{ *this }; ++*this; return temp; }
+                    /// Equal once either range is exhausted, so the shorter one ends the zip.
+                    bool operator==( const iterator & rhs ) const { return m_it1 == rhs.m_it1 or m_it2 == rhs.m_it2; }
+                    bool operator!=( const iterator & rhs ) const { return not ( *this == rhs ); }
+            };
+
+            zip_view( Base1 base1, Base2 base2 ) : m_base1( std::move( base1 ) ), m_base2( std::move( base2 ) ) {}
+            iterator begin() const { return iterator( m_base1.begin(), m_base2.begin() ); }
+            iterator end() const { return iterator( m_base1.end(), m_base2.end() ); }
+    };
+
+    //=== The adaptors, which `|` applies to the range on its left.
+    template < typename Pred > struct filter_adaptor { Pred pred; };
+    template < typename F > struct transform_adaptor { F fn; };
+    struct take_adaptor { size_t count; };
+    struct drop_adaptor { size_t count; };
+    struct chunk_adaptor { size_t size; };
+    template < typename Other > struct zip_adaptor { Other other; };
+
+    /// Keeps the elements for which `pred` holds.
+    template < typename Pred >
+    filter_adaptor< typename std::decay< Pred >::type > filter( Pred && pred ) { return { std::forward< Pred >( pred ) }; }
+    /// Applies `fn` to every element.
+    template < typename F >
+    transform_adaptor< typename std::decay< F >::type > transform( F && fn ) { return { std::forward< F >( fn ) }; }
+    /// Keeps the first `count` elements.
+    inline take_adaptor take( size_t count ) { return { count }; }
+    /// Skips the first `count` elements.
+    inline drop_adaptor drop( size_t count ) { return { count }; }
+    /// Splits the range into consecutive sub-ranges of `size` elements.
+    inline chunk_adaptor chunk( size_t size ) { return { size }; }
+    /// Pairs every element with the one at the same position in `other`.
+    template < typename R >
+    zip_adaptor< range_t< R > > zip( R && other ) { return { as_range< R >::wrap( std::forward< R >( other ) ) }; }
+    /// Pairs the elements of `r1` and `r2` at the same positions.
+    template < typename R1, typename R2 >
+    zip_view< range_t< R1 >, range_t< R2 > > zip( R1 && r1, R2 && r2 ) {
+        return zip_view< range_t< R1 >, range_t< R2 > >( as_range< R1 >::wrap( std::forward< R1 >( r1 ) ),
+                                                         as_range< R2 >::wrap( std::forward< R2 >( r2 ) ) );
+    }
+
+    template < typename R, typename Pred >
+    filter_view< range_t< R >, Pred > operator|( R && r, const filter_adaptor< Pred > & a ) {
+        return filter_view< range_t< R >, Pred >( as_range< R >::wrap( std::forward< R >( r ) ), a.pred );
+    }
+    template < typename R, typename F >
+    transform_view< range_t< R >, F > operator|( R && r, const transform_adaptor< F > & a ) {
+        return transform_view< range_t< R >, F >( as_range< R >::wrap( std::forward< R >( r ) ), a.fn );
+    }
+    template < typename R >
+    take_view< range_t< R > > operator|( R && r, take_adaptor a ) {
+        return take_view< range_t< R > >( as_range< R >::wrap( std::forward< R >( r ) ), a.count );
+    }
+    template < typename R >
+    drop_view< range_t< R > > operator|( R && r, drop_adaptor a ) {
+        return drop_view< range_t< R > >( as_range< R >::wrap( std::forward< R >( r ) ), a.count );
+    }
+    template < typename R >
+    chunk_view< range_t< R > > operator|( R && r, chunk_adaptor a ) {
+        return chunk_view< range_t< R > >( as_range< R >::wrap( std::forward< R >( r ) ), a.size );
+    }
+    template < typename R, typename Other >
+    zip_view< range_t< R >, Other > operator|( R && r, const zip_adaptor< Other > & a ) {
+        return zip_view< range_t< R >, Other >( as_range< R >::wrap( std::forward< R >( r ) ), a.other );
+    }
+}
+}
+#endif
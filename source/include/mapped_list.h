@@ -0,0 +1,720 @@
+#ifndef _MAPPED_LIST_H_
+#define _MAPPED_LIST_H_
+
+/*!
+ * @file mapped_list.h
+ * @brief A doubly linked list that lives inside a memory mapped file.
+ *
+ * `sc::mapped_list<T>` keeps the same node layout as `sc::list<T>`, but its
+ * nodes are carved out of a file mapped with `mmap()`. Links are stored as
+ * byte offsets from the beginning of the file instead of `Node*`, so the file
+ * may be mapped at any address: reopening a list only maps the file and reads
+ * its header, no matter how many elements it holds.
+ *
+ * File layout:
+ *
+ *     +--------+-------------------------------------------+
+ *     | Header | Node | Node | (free) | Node | ...         |
+ *     +--------+-------------------------------------------+
+ *     0        sizeof(Header)                          file size
+ *
+ * Erased nodes are kept in a free list threaded through their `next` field,
+ * and the file doubles in size whenever it runs out of nodes.
+ *
+ * Changes reach the file whenever the kernel decides to write the dirty pages
+ * back; call `sync()` to make them durable at a given point.
+ *
+ * A file has a single writer: the list holds an exclusive `flock()` on it for
+ * as long as it is open, and opening a file another list holds, in this process
+ * or any other, throws.
+ *
+ * Nodes cannot move from one file to another, so `splice()` and `merge()` copy
+ * the elements of the other list into this one's nodes, in O(n), and iterators to
+ * the other list's elements do not follow them.
+ *
+ * POSIX only.
+ */
+
+#include <algorithm>    // max
+#include <cerrno>
+#include <cstdint>
+#include <cstring>      // memcmp, memcpy
+#include <initializer_list>
+#include <iterator>
+#include <string>
+#include <system_error>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>      // swap
+
+#include <fcntl.h>      // open
+#include <sys/file.h>   // flock
+#include <sys/mman.h>   // mmap, mremap, msync
+#include <sys/stat.h>   // fstat
+#include <unistd.h>     // ftruncate, close
+
+#include "list_algo.h"
+
+namespace sc {
+
+    template < typename T >
+    class mapped_list
+    {
+        static_assert( std::is_trivially_copyable< T >::value,
+                "sc::mapped_list stores its elements as raw bytes, T must be trivially copyable." );
+
+        private:
+        using offset_t = std::uint64_t;  //!< Byte offset from the beginning of the file; 0 means null.
+
+        //=== The data node.
+        struct Node
+        {
+            T data;
+            offset_t next;
+            offset_t prev;
+        };
+
+        //=== The file header, stored at offset 0.
+        struct Header
+        {
+            char magic[8];
+            std::uint32_t version;
+            std::uint32_t elem_size;  //!< sizeof(T), to reject files created for another element type.
+            std::uint32_t node_size;  //!< sizeof(Node), which also depends on the alignment of T.
+            std::uint32_t reserved;
+            offset_t file_size;       //!< Bytes of the file currently in use by the mapping.
+            offset_t bump;            //!< First never used byte of the node area.
+            offset_t free_head;       //!< First node of the free list.
+            offset_t head;            //!< Head sentinel.
+            offset_t tail;            //!< Tail sentinel.
+            std::uint64_t len;        //!< Number of elements.
+        };
+
+        static constexpr std::uint32_t file_version = 1;
+        static constexpr offset_t min_file_size = 64 * 1024;
+
+        static const char * file_magic() { return "SCMLIST"; }
+
+        //=== The iterator classes.
+        public:
+
+        class const_iterator
+        {
+            public:
+                using value_type        = T;
+                using pointer           = const T *;
+                using reference         = const T &;
+                using difference_type   = std::ptrdiff_t;
+                using iterator_category = std::bidirectional_iterator_tag;
+
+            protected:
+                const mapped_list * m_list; //!< The list, which knows where the file is currently mapped.
+                offset_t m_off;             //!< The node offset; it survives the file being remapped.
+
+            public:
+                /**
+                 * @brief Construct a new const iterator object.
+                 */
+                const_iterator( const mapped_list * l = nullptr, offset_t off = 0 ) : m_list{l}, m_off{off} {/*empty*/}
+                /**
+                 * @brief The unary indirection operator.
+                 *
+                 * @return a constant reference to the element.
+                 */
+                reference operator*() const {
+                    return m_list->node( m_off )->data;
+                }
+                /**
+                 * @brief access the members of the element.
+                 */
+                pointer operator->() const {
+                    return &( m_list->node( m_off )->data );
+                }
+                /**
+                 * @brief The operator prefix increment.
+                 *
+                 * @return const_iterator& the iterator itself.
+                 */
+                const_iterator & operator++() {
+                    m_off = m_list->node( m_off )->next;
+                    return *this;
+                }
+                /**
+                 * @brief The operator postfix increment.
+                 *
+                 * @return const_iterator The iterator before the increment.
+                 */
+                const_iterator operator++(int) {
+                    const_iterator temp{ *this };
+                    ++*this;
+                    return temp;
+                }
+                /**
+                 * @brief The operator prefix decrement.
+                 *
+                 * @return const_iterator& the iterator itself.
+                 */
+                const_iterator & operator--() {
+                    m_off = m_list->node( m_off )->prev;
+                    return *this;
+                }
+                /**
+                 * @brief The operator postfix decrement.
+                 *
+                 * @return const_iterator The iterator before the decrement.
+                 */
+                const_iterator operator--(int) {
+                    const_iterator temp{ *this };
+                    --*this;
+                    return temp;
+                }
+                /**
+                 * @brief Walks `step` positions forwards, or backwards if `step` is negative.
+                 *
+                 * @return const_iterator& the iterator itself.
+                 */
+                const_iterator & operator+=( difference_type step ) {
+                    for ( ; step > 0; --step )
+                        ++*this;
+                    for ( ; step < 0; ++step )
+                        --*this;
+                    return *this;
+                }
+                /**
+                 * @brief Walks `step` positions backwards, or forwards if `step` is negative.
+                 *
+                 * @return const_iterator& the iterator itself.
+                 */
+                const_iterator & operator-=( difference_type step ) {
+                    return *this += -step;
+                }
+                /**
+                 * @brief The equality operator.
+                 *
+                 * @param rhs Variable on the right side of the operation.
+                 * @return true if both iterators refer to the same node.
+                 */
+                bool operator==( const const_iterator & rhs ) const {
+                    return m_off == rhs.m_off and m_list == rhs.m_list;
+                }
+                /**
+                 * @brief The inequality operator.
+                 *
+                 * @param rhs Variable on the right side of the operation.
+                 * @return true if the iterators refer to different nodes.
+                 */
+                bool operator!=( const const_iterator & rhs ) const {
+                    return not ( *this == rhs );
+                }
+
+                friend class mapped_list<T>;
+        };
+
+        class iterator : public const_iterator
+        {
+            public:
+                using pointer   = T *;
+                using reference = T &;
+
+                /**
+                 * @brief Construct a new iterator object.
+                 */
+                iterator( const mapped_list * l = nullptr, offset_t off = 0 ) : const_iterator{ l, off } {/*empty*/}
+                /**
+                 * @brief The unary indirection operator.
+                 *
+                 * @return a reference to the element.
+                 */
+                reference operator*() const {
+                    return const_cast< mapped_list * >( this->m_list )->node( this->m_off )->data;
+                }
+                /**
+                 * @brief access the members of the element.
+                 */
+                pointer operator->() const {
+                    return &**this;
+                }
+                iterator & operator++() { const_iterator::operator++(); return *this; }
+                iterator operator++(int) { iterator temp{ *this }; ++*this; return temp; }
+                iterator & operator--() { const_iterator::operator--(); return *this; }
+                iterator operator--(int) { iterator temp{ *this }; --*this; return temp; }
+                iterator & operator+=( typename const_iterator::difference_type step ) { const_iterator::operator+=( step ); return *this; }
+                iterator & operator-=( typename const_iterator::difference_type step ) { const_iterator::operator-=( step ); return *this; }
+
+                friend class mapped_list<T>;
+        };
+
+
+        //=== Private members.
+        private:
+            int m_fd;          //!< The backing file.
+            char * m_base;     //!< Where the file is currently mapped.
+            size_t m_mapped;   //!< Length of the current mapping.
+
+        public:
+        //=== [I] Special members.
+        /**
+         * @brief Opens the list stored in `path`, creating an empty one if the file does not exist.
+         *
+         * @param path The backing file.
+         * @throw std::system_error if the file cannot be opened, locked, resized or mapped.
+         * @throw std::runtime_error if the file is not a list of this element type.
+         */
+        explicit mapped_list( const std::string & path ) : m_fd{ -1 }, m_base{ nullptr }, m_mapped{ 0 } {
+            m_fd = ::open( path.c_str(), O_RDWR | O_CREAT, 0644 );
+            if ( m_fd < 0 )
+                throw_errno( "open " + path );
+            try {
+                if ( ::flock( m_fd, LOCK_EX | LOCK_NB ) != 0 )
+                    throw_errno( "flock " + path + ", which another list holds open" );
+                open_mapping( path );
+            }
+            catch ( ... ) {
+                unmap_and_close();
+                throw;
+            }
+        }
+        /**
+         * @brief Unmaps the file. Pending changes still reach the file eventually; call `sync()` first
+         *        if they must be durable right away.
+         */
+        ~mapped_list() {
+            unmap_and_close();
+        }
+        /// The list owns the mapping, so it cannot be copied.
+        mapped_list( const mapped_list & ) = delete;
+        mapped_list & operator=( const mapped_list & ) = delete;
+        /**
+         * @brief Replaces the contents with the elements of the initializer list ilist_.
+         *
+         * @param ilist_ Initializer list to use as data source.
+         * @return *this
+         */
+        mapped_list & operator=( std::initializer_list<T> ilist_ ) {
+            assign( ilist_ );
+            return *this;
+        }
+
+
+        //=== [II] ITERATORS.
+        /**
+         * @brief Returns an iterator to the first element of the list.
+         */
+        iterator begin() { return iterator( this, node( header()->head )->next ); }
+        /**
+         * @brief Returns a constant iterator to the first element of the list.
+         */
+        const_iterator cbegin() const { return const_iterator( this, node( header()->head )->next ); }
+        const_iterator begin() const { return cbegin(); }
+        /**
+         * @brief Returns an iterator to the element following the last element of the list.
+         */
+        iterator end() { return iterator( this, header()->tail ); }
+        /**
+         * @brief Returns a constant iterator to the element following the last element of the list.
+         */
+        const_iterator cend() const { return const_iterator( this, header()->tail ); }
+        const_iterator end() const { return cend(); }
+
+
+        //=== [III] Capacity/Status.
+        /**
+         * @brief Checks if the container has no elements.
+         */
+        bool empty( void ) const { return header()->len == 0; }
+        /**
+         * @brief Returns the number of elements in the container.
+         */
+        size_t size( void ) const { return static_cast< size_t >( header()->len ); }
+        /**
+         * @brief Returns the size of the backing file, in bytes.
+         */
+        size_t file_size( void ) const { return static_cast< size_t >( header()->file_size ); }
+
+
+        //=== [IV] Modifiers.
+        /**
+         * @brief Erases all elements from the container. Their nodes go back to the free list.
+         */
+        void clear( void ) {
+            erase( begin(), end() );
+        }
+        /**
+         * @brief Returns a reference to the first element in the container.
+         */
+        T & front( void ) { return *begin(); }
+        const T & front( void ) const { return *cbegin(); }
+        /**
+         * @brief Returns a reference to the last element in the container.
+         */
+        T & back( void ) { return node( node( header()->tail )->prev )->data; }
+        const T & back( void ) const { return node( node( header()->tail )->prev )->data; }
+        /**
+         * @brief Prepends the given element value to the beginning of the container.
+         */
+        void push_front( const T & value_ ) { insert( begin(), value_ ); }
+        /**
+         * @brief Appends the given element value to the end of the container.
+         */
+        void push_back( const T & value_ ) { insert( end(), value_ ); }
+        /**
+         * @brief Removes the first element of the container. If the container is empty, the behavior is undefined.
+         */
+        void pop_front( void ) { erase( begin() ); }
+        /**
+         * @brief Removes the last element of the container. If the container is empty, the behavior is undefined.
+         */
+        void pop_back( void ) { erase( iterator( this, node( header()->tail )->prev ) ); }
+
+
+        //=== [IV-a] MODIFIERS W/ ITERATORS.
+        /**
+         * @brief Replaces the contents with copies of those in the range [first_, last_).
+         */
+        template < typename InItr >
+        void assign( InItr first_, InItr last_ ) {
+            clear();
+            insert( end(), first_, last_ );
+        }
+        /**
+         * @brief Replaces the contents with the elements from the initializer list ilist_.
+         */
+        void assign( std::initializer_list<T> ilist_ ) {
+            assign( ilist_.begin(), ilist_.end() );
+        }
+        /*!
+         *  Inserts a new value in the list before the iterator 'pos_'
+         *  and returns an iterator to the new node.
+         *
+         *  \param pos_ An iterator to the position before which we want to insert the new data.
+         *  \param value_ The value we want to insert in the list.
+         *  \return An iterator to the new element in the list.
+         *  \throw std::system_error if the file had to grow and could not.
+         */
+        iterator insert( const_iterator pos_, const T & value_ ) {
+            T copy{ value_ };           // value_ may live inside the mapping, that acquire() may move.
+            offset_t fresh = acquire(); // May remap, so take node pointers only afterwards.
+            Node * n = node( fresh );
+            Node * p = node( pos_.m_off );
+            n->data = copy;
+            n->next = pos_.m_off;
+            n->prev = p->prev;
+            node( p->prev )->next = fresh;
+            p->prev = fresh;
+            ++header()->len;
+            return iterator( this, fresh );
+        }
+        /**
+         * @brief Inserts elements from range [first_, last_) before pos_.
+         *
+         * @return Iterator pointing to the first element inserted, or pos_ if first_==last_.
+         */
+        template < typename InItr >
+        iterator insert( const_iterator pos_, InItr first_, InItr last_ ) {
+            iterator first{ this, pos_.m_off };
+            bool inserted{ false };
+            for ( ; first_ != last_; ++first_ ) {
+                iterator it = insert( pos_, *first_ );
+                if ( not inserted ) {
+                    first = it;
+                    inserted = true;
+                }
+            }
+            return first;
+        }
+        /**
+         * @brief Inserts elements from initializer list ilist_ before pos_.
+         *
+         * @return Iterator pointing to the first element inserted, or pos_ if ilist_ is empty.
+         */
+        iterator insert( const_iterator pos_, std::initializer_list<T> ilist_ ) {
+            return insert( pos_, ilist_.begin(), ilist_.end() );
+        }
+        /*!
+         *  Erases the node pointed by 'it_' and returns an iterator
+         *  to the node just past the erased node. The node goes back to the free list.
+         *
+         *  \param it_ The node we wish to erase.
+         *  \return An iterator to the node following the erased node.
+         */
+        iterator erase( const_iterator it_ ) {
+            Node * n = node( it_.m_off );
+            offset_t next = n->next;
+            node( n->prev )->next = next;
+            node( next )->prev = n->prev;
+            release( it_.m_off );
+            --header()->len;
+            return iterator( this, next );
+        }
+        /**
+         * @brief Removes the elements in the range [first_, last_).
+         *
+         * @return Iterator following the last removed element.
+         */
+        iterator erase( const_iterator first_, const_iterator last_ ) {
+            while ( first_ != last_ )
+                first_ = erase( first_ );
+            return iterator( this, last_.m_off );
+        }
+
+
+        //=== [V] UTILITY METHODS.
+        /**
+         * @brief Merges the sorted list `other` into this sorted list. On ties, this list's elements
+         *        come first. The elements are copied into this file, and `other` ends up empty.
+         *
+         * @param other Another container to merge.
+         * @throw std::system_error if the file had to grow and could not.
+         */
+        void merge( mapped_list & other ) {
+            if ( &other == this )
+                return;
+            const_iterator pos = cbegin();
+            for ( const_iterator it = other.cbegin(); it != other.cend(); ++it ) {
+                while ( pos != cend() and not ( *it < *pos ) )
+                    ++pos;
+                insert( pos, *it );
+            }
+            other.clear();
+        }
+        /**
+         * @brief Moves the elements of `other` before `pos`. They are copied into this file, in O(n),
+         *        and `other` ends up empty.
+         *
+         * @param pos Element before which the content will be inserted.
+         * @param other Another container to transfer the content from.
+         * @throw std::system_error if the file had to grow and could not.
+         */
+        void splice( const_iterator pos, mapped_list & other ) {
+            if ( &other == this )
+                return;
+            insert( pos, other.cbegin(), other.cend() );
+            other.clear();
+        }
+        /**
+         * @brief Reverses the order of the elements by relinking their nodes, so iterators follow
+         *        their elements.
+         */
+        void reverse( void ) {
+            Header * h = header();
+            if ( h->len < 2 )
+                return;
+            offset_t first = node( h->head )->next;
+            offset_t last = node( h->tail )->prev;
+            for ( offset_t p = first; p != h->tail; p = node( p )->prev )
+                std::swap( node( p )->next, node( p )->prev );
+            node( h->head )->next = last;
+            node( last )->prev = h->head;
+            node( h->tail )->prev = first;
+            node( first )->next = h->tail;
+        }
+        /**
+         * @brief Removes all consecutive duplicate elements from the container.
+         */
+        void unique( void ) {
+            if ( size() < 2 )
+                return;
+            iterator p = begin();
+            for ( iterator next = std::next( p ); next != end(); next = std::next( p ) ) {
+                if ( *next == *p )
+                    erase( next );
+                else
+                    p = next;
+            }
+        }
+        /**
+         * @brief Sorts the elements in ascending order, stably, in O(n log n). Nodes are relinked
+         *        rather than elements copied, so iterators remain valid.
+         */
+        void sort( void ) {
+            Header * h = header();
+            if ( h->len < 2 )
+                return;
+            node( node( h->tail )->prev )->next = 0;
+            offset_t sorted = detail::sort_chain( links{ this }, node( h->head )->next );
+            // Restore the back links and the sentinels.
+            offset_t prev = h->head;
+            for ( offset_t p = sorted; p != 0; prev = p, p = node( p )->next ) {
+                node( prev )->next = p;
+                node( p )->prev = prev;
+            }
+            node( prev )->next = h->tail;
+            node( h->tail )->prev = prev;
+        }
+
+
+        //=== [VI] DURABILITY.
+        /**
+         * @brief Blocks until every change made so far has been written to the file.
+         *
+         * @throw std::system_error if the kernel reports a write error.
+         */
+        void sync( void ) {
+            if ( ::msync( m_base, m_mapped, MS_SYNC ) != 0 )
+                throw_errno( "msync" );
+        }
+        /**
+         * @brief Schedules every change made so far to be written to the file, without waiting.
+         */
+        void sync_async( void ) {
+            if ( ::msync( m_base, m_mapped, MS_ASYNC ) != 0 )
+                throw_errno( "msync" );
+        }
+
+        private:
+        //=== Address translation.
+        Header * header() { return reinterpret_cast< Header * >( m_base ); }
+        const Header * header() const { return reinterpret_cast< const Header * >( m_base ); }
+        Node * node( offset_t off ) { return reinterpret_cast< Node * >( m_base + off ); }
+        const Node * node( offset_t off ) const { return reinterpret_cast< const Node * >( m_base + off ); }
+
+        /// Rounds `off` up to the alignment of a node.
+        static offset_t aligned( offset_t off ) {
+            const offset_t a = alignof( Node );
+            return ( off + a - 1 ) / a * a;
+        }
+
+        /// Maps `path`, laying out an empty list first if the file is new.
+        void open_mapping( const std::string & path ) {
+            struct stat st;
+            if ( ::fstat( m_fd, &st ) != 0 )
+                throw_errno( "fstat " + path );
+
+            if ( st.st_size == 0 ) {
+                // Brand new file: lay out the header and both sentinels.
+                resize_file( min_file_size );
+                map( min_file_size );
+                Header * h = header();
+                std::memcpy( h->magic, file_magic(), sizeof( h->magic ) );
+                h->version = file_version;
+                h->elem_size = sizeof( T );
+                h->node_size = sizeof( Node );
+                h->reserved = 0;
+                h->file_size = min_file_size;
+                h->bump = aligned( sizeof( Header ) );
+                h->free_head = 0;
+                h->len = 0;
+                offset_t head = acquire();
+                offset_t tail = acquire();
+                h = header(); // Large nodes may have grown the file, and moved the mapping.
+                h->head = head;
+                h->tail = tail;
+                node( h->head )->prev = 0;
+                node( h->head )->next = h->tail;
+                node( h->tail )->prev = h->head;
+                node( h->tail )->next = 0;
+                return;
+            }
+
+            if ( static_cast< size_t >( st.st_size ) < sizeof( Header ) )
+                throw std::runtime_error( "sc::mapped_list: " + path + " is not a list file" );
+            map( static_cast< size_t >( st.st_size ) );
+            Header * h = header();
+            // The file may be larger than the header says: `grow()` extends the file before it
+            // records the new size, and a crash may come in between. The extra bytes were never used.
+            if ( std::memcmp( h->magic, file_magic(), sizeof( h->magic ) ) != 0 or
+                 h->version != file_version or
+                 h->elem_size != sizeof( T ) or h->node_size != sizeof( Node ) or
+                 h->file_size > static_cast< offset_t >( st.st_size ) )
+                throw std::runtime_error( "sc::mapped_list: " + path + " is not a list file of this element type" );
+            h->file_size = static_cast< offset_t >( st.st_size );
+        }
+        /// How the node algorithms of list_algo.h walk this list; chains end at offset 0, the header.
+        struct links {
+            using ref = offset_t;
+            mapped_list * owner;
+            offset_t nil( void ) const { return 0; }
+            offset_t next( offset_t off ) const { return owner->node( off )->next; }
+            void set_next( offset_t off, offset_t to ) const { owner->node( off )->next = to; }
+            const T & value( offset_t off ) const { return owner->node( off )->data; }
+            void step( void ) const {}
+        };
+        //=== Node management.
+        /// Takes a node from the free list, or carves a new one out of the file, growing it if needed.
+        offset_t acquire( void ) {
+            Header * h = header();
+            if ( h->free_head != 0 ) {
+                offset_t off = h->free_head;
+                h->free_head = node( off )->next;
+                return off;
+            }
+            // Doubling is not enough for a node larger than the whole file.
+            if ( h->bump + sizeof( Node ) > h->file_size )
+                grow( std::max( 2 * h->file_size, aligned( h->bump + sizeof( Node ) ) ) );
+            h = header(); // The mapping may have moved.
+            offset_t off = h->bump;
+            h->bump = aligned( h->bump + sizeof( Node ) );
+            return off;
+        }
+        /// Returns a node to the free list.
+        void release( offset_t off ) {
+            node( off )->next = header()->free_head;
+            header()->free_head = off;
+        }
+        /// Extends the file and its mapping to `bytes`. The header records the new size only once
+        /// both succeeded, so the header never claims more than the file holds.
+        void grow( offset_t bytes ) {
+            resize_file( bytes );
+#ifdef MREMAP_MAYMOVE
+            void * p = ::mremap( m_base, m_mapped, static_cast< size_t >( bytes ), MREMAP_MAYMOVE );
+            if ( p == MAP_FAILED )
+                throw_errno( "mremap" );
+            m_base = static_cast< char * >( p );
+            m_mapped = static_cast< size_t >( bytes );
+#else
+            ::munmap( m_base, m_mapped );
+            map( static_cast< size_t >( bytes ) );
+#endif
+            header()->file_size = bytes;
+        }
+
+        //=== System calls.
+        void resize_file( offset_t bytes ) {
+            if ( ::ftruncate( m_fd, static_cast< off_t >( bytes ) ) != 0 )
+                throw_errno( "ftruncate" );
+        }
+        void map( size_t bytes ) {
+            void * p = ::mmap( nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0 );
+            if ( p == MAP_FAILED ) {
+                m_base = nullptr;
+                throw_errno( "mmap" );
+            }
+            m_base = static_cast< char * >( p );
+            m_mapped = bytes;
+        }
+        void unmap_and_close( void ) {
+            if ( m_base != nullptr )
+                ::munmap( m_base, m_mapped );
+            if ( m_fd >= 0 )
+                ::close( m_fd );
+            m_base = nullptr;
+            m_fd = -1;
+        }
+        static void throw_errno( const std::string & what ) {
+            throw std::system_error( errno, std::generic_category(), "sc::mapped_list: " + what );
+        }
+    };
+
+    /**
+     * @brief Checks if the contents of l1_ and l2_ are equal: the same number of elements, and
+     *        equal elements at the same positions.
+     */
+    template < typename T >
+    inline bool operator==( const mapped_list< T > & l1_, const mapped_list< T > & l2_ ) {
+        if ( l1_.size() != l2_.size() )
+            return false;
+        auto it2 = l2_.cbegin();
+        for ( auto it1 = l1_.cbegin(); it1 != l1_.cend(); ++it1, ++it2 )
+            if ( not ( *it1 == *it2 ) )
+                return false;
+        return true;
+    }
+    /**
+     * @brief Checks if the contents of l1_ and l2_ are not equal.
+     */
+    template < typename T >
+    inline bool operator!=( const mapped_list< T > & l1_, const mapped_list< T > & l2_ ) {
+        return not ( l1_ == l2_ );
+    }
+}
+#endif
@@ -0,0 +1,367 @@
+#ifndef _PERSISTENT_LIST_H_
+#define _PERSISTENT_LIST_H_
+
+/*!
+ * @file persistent_list.h
+ * @brief An immutable singly linked list whose versions share their nodes.
+ *
+ * `sc::persistent_list<T>` is a handle to a chain of reference counted nodes that
+ * are never modified once linked. Copying a handle takes a snapshot in O(1): it
+ * only counts one more reference to the first node. Changing a handle builds a
+ * new version and leaves every other handle as it was:
+ *
+ *     v1:  a --> b --> c --> d
+ *                      ^
+ *     v2:  a'--> x ----+              v2 = v1, then v2.replace( ++v2.cbegin(), x )
+ *
+ * `push_front()` and `pop_front()` are O(1). An update at position k
+ * (`insert()`, `erase()`, `replace()`) copies the k nodes before it and shares
+ * the rest (path copying), so `push_back()` copies the whole list.
+ *
+ * Reference counts are atomic, and nodes are immutable, so versions may be read,
+ * copied and destroyed on any threads. A single handle, like a `std::shared_ptr`,
+ * must not be changed while another thread reads or copies it: a writer that
+ * publishes versions keeps the current one under a lock, and readers copy it
+ * under that lock, which costs them one increment.
+ *
+ * Nodes are freed, iteratively, when the last version that holds them goes away.
+ */
+
+#include <atomic>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <utility>   // move
+
+#include "list_alloc.h"
+
+namespace sc {
+
+    /*!
+     * An immutable list of `T`, with O(1) copies. The `Alloc` policy provides the memory of
+     * the nodes, as for `sc::list`.
+     */
+    template < typename T, typename Alloc = heap_nodes >
+    class persistent_list
+    {
+        private:
+        //=== The data node.
+        struct Node
+        {
+            T data;
+            Node * next;
+            std::atomic< size_t > refs; //!< How many versions and nodes point to this one.
+
+            Node( const T & d, Node * n ) : data{ d }, next{ n }, refs{ 1 } { /* empty */ }
+            Node( T && d, Node * n ) : data{ std::move( d ) }, next{ n }, refs{ 1 } { /* empty */ }
+
+            static void * operator new( size_t bytes ) { return Alloc::allocate( bytes, alignof( Node ) ); }
+            static void operator delete( void * p, size_t bytes ) noexcept { Alloc::deallocate( p, bytes, alignof( Node ) ); }
+        };
+
+        public:
+        //=== Aliases.
+        using value_type      = T;
+        using size_type       = size_t;
+        using reference       = const T &; //!< Elements cannot be changed in place.
+        using const_reference = const T &;
+
+        //=== The iterator class.
+        class const_iterator
+        {
+            public:
+                using value_type        = T;
+                using pointer           = const T *;
+                using reference         = const T &;
+                using difference_type   = std::ptrdiff_t;
+                using iterator_category = std::forward_iterator_tag;
+
+            private:
+                Node * m_ptr; //!< The node, or nullptr past the end.
+
+            public:
+                /**
+                 * @brief Construct a new const iterator object.
+                 */
+                const_iterator( Node * ptr = nullptr ) : m_ptr{ptr} {/*empty*/}
+                /**
+                 * @brief The unary indirection operator.
+                 *
+                 * @return a constant reference to the element.
+                 */
+                reference operator*() const { return m_ptr->data; }
+                /**
+                 * @brief access the members of the element.
+                 */
+                pointer operator->() const { return &m_ptr->data; }
+                /**
+                 * @brief The operator prefix increment.
+                 */
+                const_iterator & operator++() {
+                    m_ptr = m_ptr->next;
+                    return *this;
+                }
+                /**
+                 * @brief The operator postfix increment.
+                 */
+                const_iterator operator++(int) {
+                    const_iterator temp{ *this };
+                    m_ptr = m_ptr->next;
+                    return temp;
+                }
+                bool operator==( const const_iterator & rhs ) const { return m_ptr == rhs.m_ptr; }
+                bool operator!=( const const_iterator & rhs ) const { return m_ptr != rhs.m_ptr; }
+
+                friend class persistent_list<T, Alloc>;
+        };
+        using iterator = const_iterator;
+
+
+        //=== Private members.
+        private:
+            Node * m_head; //!< The first node, shared with other versions, or nullptr.
+            size_t m_len;  //!< Number of elements.
+
+        public:
+        //=== [I] Special members.
+        /**
+         * @brief Default constructor, constructs an empty container. Nothing is allocated.
+         */
+        persistent_list() noexcept : m_head{ nullptr }, m_len{0} {}
+        /**
+         * @brief Constructs the container with the contents of the range [first, last).
+         */
+        template< typename InputIt >
+        persistent_list( InputIt first, InputIt last ) : persistent_list() {
+            Node ** at = &m_head;
+            try {
+                for ( ; first != last; ++first, ++m_len ) {
+                    *at = new Node( *first, nullptr );
+                    at = &(*at)->next;
+                }
+            }
+            catch ( ... ) {
+                release( m_head );
+                throw;
+            }
+        }
+        /**
+         * @brief Constructs the container with the contents of the initializer list ilist_.
+         */
+        persistent_list( std::initializer_list<T> ilist_ ) : persistent_list( ilist_.begin(), ilist_.end() ) {}
+        /**
+         * @brief Copy constructor: a snapshot of clone_, in O(1). Both share every node.
+         */
+        persistent_list( const persistent_list & clone_ ) noexcept
+            : m_head{ retain( clone_.m_head ) }, m_len{ clone_.m_len } {}
+        /**
+         * @brief Move constructor. Leaves other empty.
+         */
+        persistent_list( persistent_list && other ) noexcept : m_head{ other.m_head }, m_len{ other.m_len } {
+            other.m_head = nullptr;
+            other.m_len = 0;
+        }
+        /**
+         * @brief Destructs this version, and frees the nodes no other version holds.
+         */
+        ~persistent_list() { release( m_head ); }
+        /**
+         * @brief Copy assignment operator: a snapshot of rhs, in O(1).
+         */
+        persistent_list & operator=( const persistent_list & rhs ) noexcept {
+            Node * old = m_head;
+            m_head = retain( rhs.m_head );
+            m_len = rhs.m_len;
+            release( old );
+            return *this;
+        }
+        /**
+         * @brief Move assignment operator. Leaves rhs empty.
+         */
+        persistent_list & operator=( persistent_list && rhs ) noexcept {
+            if ( this != &rhs ) {
+                release( m_head );
+                m_head = rhs.m_head;
+                m_len = rhs.m_len;
+                rhs.m_head = nullptr;
+                rhs.m_len = 0;
+            }
+            return *this;
+        }
+
+
+        //=== [II] ITERATORS.
+        /**
+         * @brief Returns a constant iterator to the first element of the list.
+         */
+        const_iterator cbegin() const { return const_iterator( m_head ); }
+        const_iterator begin() const { return cbegin(); }
+        /**
+         * @brief Returns a constant iterator to the element following the last element of the list.
+         */
+        const_iterator cend() const { return const_iterator(); }
+        const_iterator end() const { return cend(); }
+
+
+        //=== [III] Capacity/Status.
+        /**
+         * @brief Checks if the container has no elements.
+         */
+        bool empty( void ) const { return m_len == 0; }
+        /**
+         * @brief Returns the number of elements in the container.
+         */
+        size_t size( void ) const { return m_len; }
+        /**
+         * @brief Checks whether this version and other share their first node, and so every node.
+         */
+        bool shares_with( const persistent_list & other ) const { return m_head == other.m_head; }
+
+
+        //=== [IV] Modifiers. None of them affects other versions.
+        /**
+         * @brief Empties this version.
+         */
+        void clear( void ) {
+            release( m_head );
+            m_head = nullptr;
+            m_len = 0;
+        }
+        /**
+         * @brief Returns a reference to the first element in the container.
+         */
+        const T & front( void ) const { return m_head->data; }
+        /**
+         * @brief Prepends value_, in O(1). The new node shares the rest of the list.
+         */
+        void push_front( const T & value_ ) {
+            m_head = new Node( value_, m_head );
+            ++m_len;
+        }
+        void push_front( T && value_ ) {
+            m_head = new Node( std::move( value_ ), m_head );
+            ++m_len;
+        }
+        /**
+         * @brief Removes the first element, in O(1).
+         */
+        void pop_front( void ) {
+            Node * old = m_head;
+            --m_len;
+            if ( old->refs.load( std::memory_order_acquire ) == 1 ) {
+                // No other version holds the node, so its reference to the next one becomes ours.
+                m_head = old->next;
+                delete old;
+                return;
+            }
+            m_head = retain( old->next );
+            release( old );
+        }
+        /**
+         * @brief Appends value_. Every node is copied, in O(n).
+         */
+        void push_back( const T & value_ ) {
+            rebuild( nullptr, new Node( value_, nullptr ) );
+            ++m_len;
+        }
+        /**
+         * @brief Inserts value_ before pos, copying the nodes before pos and sharing the rest.
+         *
+         * @return An iterator to the inserted element. Other iterators to the nodes before pos
+         *         now refer to the previous version.
+         */
+        const_iterator insert( const_iterator pos, const T & value_ ) {
+            Node * n = new Node( value_, nullptr );
+            n->next = retain( pos.m_ptr );
+            rebuild( pos.m_ptr, n );
+            ++m_len;
+            return const_iterator( n );
+        }
+        /**
+         * @brief Removes the element at pos, copying the nodes before it and sharing the rest.
+         *
+         * @return An iterator to the element that followed pos.
+         */
+        const_iterator erase( const_iterator pos ) {
+            Node * rest = retain( pos.m_ptr->next );
+            rebuild( pos.m_ptr, rest );
+            --m_len;
+            return const_iterator( rest );
+        }
+        /**
+         * @brief Replaces the element at pos with value_, copying the nodes up to pos and sharing the rest.
+         *
+         * @return An iterator to the new element.
+         */
+        const_iterator replace( const_iterator pos, const T & value_ ) {
+            Node * n = new Node( value_, nullptr );
+            n->next = retain( pos.m_ptr->next );
+            rebuild( pos.m_ptr, n );
+            return const_iterator( n );
+        }
+
+        private:
+        /// Counts one more reference to `n`, if any.
+        static Node * retain( Node * n ) {
+            if ( n != nullptr )
+                n->refs.fetch_add( 1, std::memory_order_relaxed );
+            return n;
+        }
+        /// Drops a reference to `n`, freeing it and, in turn, the nodes only it referred to.
+        static void release( Node * n ) {
+            while ( n != nullptr and n->refs.fetch_sub( 1, std::memory_order_acq_rel ) == 1 ) {
+                Node * next = n->next;
+                delete n;
+                n = next;
+            }
+        }
+        /**
+         * @brief Makes this version copies of the nodes before `stop`, followed by `rest`, whose
+         *        reference it takes over. The previous version's nodes are released.
+         */
+        void rebuild( const Node * stop, Node * rest ) {
+            Node * first{ nullptr };
+            Node ** at = &first;
+            try {
+                for ( const Node * p = m_head; p != stop; p = p->next ) {
+                    *at = new Node( p->data, nullptr );
+                    at = &(*at)->next;
+                }
+            }
+            catch ( ... ) {
+                release( first );
+                release( rest );
+                throw;
+            }
+            *at = rest;
+            release( m_head );
+            m_head = first;
+        }
+    };
+
+    //=== [VI] OPERATORS.
+    /**
+     * @brief Checks if the contents of l1_ and l2_ are equal. Versions that share all their
+     *        nodes compare equal in O(1).
+     */
+    template < typename T, typename A >
+    inline bool operator==( const persistent_list< T, A > & l1_, const persistent_list< T, A > & l2_ ) {
+        if ( l1_.size() != l2_.size() )
+            return false;
+        if ( l1_.shares_with( l2_ ) )
+            return true;
+        auto it2 = l2_.cbegin();
+        for ( auto it1 = l1_.cbegin(); it1 != l1_.cend(); ++it1, ++it2 )
+            if ( not ( *it1 == *it2 ) )
+                return false;
+        return true;
+    }
+    /**
+     * @brief Checks if the contents of l1_ and l2_ are not equal.
+     */
+    template < typename T, typename A >
+    inline bool operator!=( const persistent_list< T, A > & l1_, const persistent_list< T, A > & l2_ ) {
+        return not ( l1_ == l2_ );
+    }
+}
+#endif
@@ -0,0 +1,734 @@
+#ifndef _SMALL_LIST_H_
+#define _SMALL_LIST_H_
+
+/*!
+ * @file small_list.h
+ * @brief A doubly linked list that keeps its first K nodes inside the object.
+ *
+ * `sc::small_list<T, K>` offers the interface of `sc::list<T>`. Its sentinel and
+ * K node slots are members of the object, and only the nodes it needs beyond
+ * those come from the heap, so a list that never holds more than K elements
+ * never allocates. Nodes never move: a list that spills onto the heap keeps its
+ * inline nodes where they are, and iterators stay valid.
+ *
+ *     +----------+------+------+-----+------+
+ *     | Sentinel | Slot | Slot | ... | Slot |  --> heap nodes, once the slots run out
+ *     +----------+------+------+-----+------+
+ *
+ * Free slots are kept in a free list and are always used before the heap.
+ *
+ * `splice()` and `merge()` relink the heap nodes of the other list, like
+ * `sc::list` does, but an element in one of its inline slots is moved into a new
+ * node, since the slot belongs to the other object. Iterators to those elements
+ * are invalidated.
+ */
+
+#include <cstddef>
+#include <functional> // less
+#include <initializer_list>
+#include <iterator>
+#include <new>        // placement new
+#include <type_traits>
+#include <utility>    // move, forward
+
+#include "list_algo.h"
+
+namespace sc {
+
+    template < typename T, size_t K >
+    class small_list
+    {
+        static_assert( K > 0, "sc::small_list needs at least one inline node; use sc::list otherwise." );
+
+        private:
+        //=== The links, which the sentinel has on its own, and the data node.
+        struct Link
+        {
+            Link * next;
+            Link * prev;
+        };
+        struct Node : Link
+        {
+            typename std::aligned_storage< sizeof( T ), alignof( T ) >::type storage;
+        };
+
+
+        //=== The iterator classes.
+        public:
+
+        class const_iterator
+        {
+            public:
+                using value_type        = T;
+                using pointer           = const T *;
+                using reference         = const T &;
+                using difference_type   = std::ptrdiff_t;
+                using iterator_category = std::bidirectional_iterator_tag;
+
+            protected:
+                Link * m_ptr; //!< The raw pointer.
+
+            public:
+                /**
+                 * @brief Construct a new const iterator object.
+                 */
+                const_iterator( Link * ptr = nullptr ) : m_ptr{ptr} {/*empty*/}
+                /**
+                 * @brief The unary indirection operator.
+                 *
+                 * @return a constant reference to the element.
+                 */
+                reference operator*() const {
+                    return value( m_ptr );
+                }
+                /**
+                 * @brief access the members of the element.
+                 */
+                pointer operator->() const {
+                    return &value( m_ptr );
+                }
+                /**
+                 * @brief The operator prefix increment.
+                 *
+                 * @return const_iterator& the iterator itself.
+                 */
+                const_iterator & operator++() {
+                    m_ptr = m_ptr->next;
+                    return *this;
+                }
+                /**
+                 * @brief The operator postfix increment.
+                 *
+                 * @return const_iterator The iterator before the increment.
+                 */
+                const_iterator operator++(int) {
+                    const_iterator temp{ *this };
+                    ++*this;
+                    return temp;
+                }
+                /**
+                 * @brief The operator prefix decrement.
+                 *
+                 * @return const_iterator& the iterator itself.
+                 */
+                const_iterator & operator--() {
+                    m_ptr = m_ptr->prev;
+                    return *this;
+                }
+                /**
+                 * @brief The operator postfix decrement.
+                 *
+                 * @return const_iterator The iterator before the decrement.
+                 */
+                const_iterator operator--(int) {
+                    const_iterator temp{ *this };
+                    --*this;
+                    return temp;
+                }
+                /**
+                 * @brief The equality operator.
+                 *
+                 * @param rhs Variable on the right side of the operation.
+                 * @return true if both iterators refer to the same node.
+                 */
+                bool operator==( const const_iterator & rhs ) const {
+                    return m_ptr == rhs.m_ptr;
+                }
+                /**
+                 * @brief The inequality operator.
+                 *
+                 * @param rhs Variable on the right side of the operation.
+                 * @return true if the iterators refer to different nodes.
+                 */
+                bool operator!=( const const_iterator & rhs ) const {
+                    return not ( *this == rhs );
+                }
+
+                friend class small_list<T, K>;
+        };
+
+        class iterator : public const_iterator
+        {
+            public:
+                using pointer   = T *;
+                using reference = T &;
+
+                /**
+                 * @brief Construct a new iterator object.
+                 */
+                iterator( Link * ptr = nullptr ) : const_iterator{ ptr } {/*empty*/}
+                /**
+                 * @brief The unary indirection operator.
+                 *
+                 * @return a reference to the element.
+                 */
+                reference operator*() const {
+                    return value( this->m_ptr );
+                }
+                /**
+                 * @brief access the members of the element.
+                 */
+                pointer operator->() const {
+                    return &**this;
+                }
+                iterator & operator++() { const_iterator::operator++(); return *this; }
+                iterator operator++(int) { iterator temp{ *this }; ++*this; return temp; }
+                iterator & operator--() { const_iterator::operator--(); return *this; }
+                iterator operator--(int) { iterator temp{ *this }; --*this; return temp; }
+
+                friend class small_list<T, K>;
+        };
+
+
+        //=== Private members.
+        private:
+            Link m_end;           //!< The sentinel, before the first and after the last element.
+            size_t m_len;         //!< Number of elements.
+            size_t m_spilled;     //!< How many of them live in heap nodes.
+            size_t m_bump;        //!< First slot never used since the list was last emptied.
+            Link * m_free;        //!< First slot of the free list.
+            Node m_slots[ K ];    //!< The inline nodes.
+
+        public:
+        //=== [I] Special members.
+        /**
+         * @brief Default constructor, constructs an empty container. Nothing is allocated.
+         */
+        small_list() : m_len{0}, m_spilled{0}, m_bump{0}, m_free{ nullptr } {
+            m_end.next = &m_end;
+            m_end.prev = &m_end;
+        }
+        /**
+         * @brief Constructs the container with count default-inserted instances of T.
+         */
+        explicit small_list( size_t count ) : small_list() {
+            try {
+                for ( size_t i{0}; i < count; ++i )
+                    link_before( &m_end, make_node( T{} ) );
+            }
+            catch ( ... ) {
+                clear();
+                throw;
+            }
+        }
+        /**
+         * @brief Constructs the container with the contents of the range [first, last).
+         */
+        template< typename InputIt >
+        small_list( InputIt first, InputIt last ) : small_list() {
+            insert_range( &m_end, first, last );
+        }
+        /**
+         * @brief Copy constructor. Constructs the container with the copy of the contents of clone_.
+         */
+        small_list( const small_list & clone_ ) : small_list() {
+            insert_range( &m_end, clone_.cbegin(), clone_.cend() );
+        }
+        /**
+         * @brief Constructs the container with the contents of the initializer list ilist_.
+         */
+        small_list( std::initializer_list<T> ilist_ ) : small_list() {
+            insert_range( &m_end, ilist_.begin(), ilist_.end() );
+        }
+        /**
+         * @brief Destructs the list, its elements and its heap nodes.
+         */
+        ~small_list() {
+            free_nodes( trivial_destroy{} );
+        }
+        /**
+         * @brief Copy assignment operator. Replaces the contents with a copy of the contents of rhs.
+         * The nodes already held are reused, so no node is allocated unless rhs is longer.
+         *
+         * @param rhs Another container to use as data source
+         * @return *this
+         */
+        small_list & operator=( const small_list & rhs ) {
+            if ( this != &rhs )
+                assign_nodes( rhs.cbegin(), rhs.cend() );
+            return *this;
+        }
+        /**
+         * @brief Replaces the contents with those identified by initializer list ilist_.
+         *
+         * @param ilist_ Initializer list to use as data source
+         * @return *this
+         */
+        small_list & operator=( std::initializer_list<T> ilist_ ) {
+            assign_nodes( ilist_.begin(), ilist_.end() );
+            return *this;
+        }
+
+
+        //=== [II] ITERATORS.
+        /**
+         * @brief Returns an iterator to the first element of the list.
+         */
+        iterator begin() { return iterator( m_end.next ); }
+        /**
+         * @brief Returns a constant iterator to the first element of the list.
+         */
+        const_iterator cbegin() const { return const_iterator( m_end.next ); }
+        const_iterator begin() const { return cbegin(); }
+        /**
+         * @brief Returns an iterator to the element following the last element of the list.
+         */
+        iterator end() { return iterator( &m_end ); }
+        /**
+         * @brief Returns a constant iterator to the element following the last element of the list.
+         */
+        const_iterator cend() const { return const_iterator( const_cast< Link * >( &m_end ) ); }
+        const_iterator end() const { return cend(); }
+
+
+        //=== [III] Capacity/Status.
+        /**
+         * @brief Checks if the container has no elements.
+         */
+        bool empty( void ) const { return m_len == 0; }
+        /**
+         * @brief Returns the number of elements in the container.
+         */
+        size_t size( void ) const { return m_len; }
+        /**
+         * @brief Returns how many elements fit in the object itself, K.
+         */
+        static constexpr size_t inline_capacity( void ) { return K; }
+        /**
+         * @brief Returns how many elements live in heap nodes.
+         */
+        size_t spilled( void ) const { return m_spilled; }
+
+
+        //=== [IV] Modifiers.
+        /**
+         * @brief Erases all elements from the container, and frees its heap nodes.
+         */
+        void clear( void ) {
+            free_nodes( trivial_destroy{} );
+            m_len = 0;
+            m_spilled = 0;
+            m_bump = 0;
+            m_free = nullptr;
+            m_end.next = &m_end;
+            m_end.prev = &m_end;
+        }
+        /**
+         * @brief Returns a reference to the first element in the container.
+         */
+        T & front( void ) { return value( m_end.next ); }
+        const T & front( void ) const { return value( m_end.next ); }
+        /**
+         * @brief Returns a reference to the last element in the container.
+         */
+        T & back( void ) { return value( m_end.prev ); }
+        const T & back( void ) const { return value( m_end.prev ); }
+        /**
+         * @brief Prepends the given element value to the beginning of the container.
+         */
+        void push_front( const T & value_ ) {
+            link_before( m_end.next, make_node( value_ ) );
+        }
+        /**
+         * @brief Appends the given element value to the end of the container.
+         */
+        void push_back( const T & value_ ) {
+            link_before( &m_end, make_node( value_ ) );
+        }
+        /**
+         * @brief Removes the first element of the container. If there are no elements in the container, the behavior is undefined.
+         */
+        void pop_front( void ) {
+            unlink_node( m_end.next );
+        }
+        /**
+         * @brief Removes the last element of the container. If there are no elements in the container, the behavior is undefined.
+         */
+        void pop_back( void ) {
+            unlink_node( m_end.prev );
+        }
+
+
+        //=== [IV-a] MODIFIERS W/ ITERATORS.
+        /**
+         * @brief Replaces the contents with copies of those in the range [first_, last_).
+         */
+        template < class InItr >
+        void assign( InItr first_, InItr last_ ) {
+            // Copy the new elements in first, so the range may come from this very list.
+            Link * old = m_end.next;
+            insert_range( old, first_, last_ );
+            while ( old != &m_end )
+                old = unlink_node( old );
+        }
+        /**
+         * @brief Replaces the contents with the elements from the initializer list ilist_.
+         */
+        void assign( std::initializer_list<T> ilist_ ) {
+            assign_nodes( ilist_.begin(), ilist_.end() );
+        }
+        /*!
+         *  Inserts a new value in the list before the iterator 'pos_'
+         *  and returns an iterator to the new node.
+         *
+         *  \param pos_ An iterator to the position before which we want to insert the new data.
+         *  \param value_ The value we want to insert in the list.
+         *  \return An iterator to the new element in the list.
+         */
+        iterator insert( const_iterator pos_, const T & value_ ) {
+            return iterator( link_before( pos_.m_ptr, make_node( value_ ) ) );
+        }
+        /**
+         * @brief Inserts elements from range [first_, last_) before pos_.
+         *
+         * @return Iterator pointing to the first element inserted, or pos_ if first_==last_.
+         */
+        template < typename InItr >
+        iterator insert( const_iterator pos_, InItr first_, InItr last_ ) {
+            return iterator( insert_range( pos_.m_ptr, first_, last_ ) );
+        }
+        /**
+         * @brief Inserts elements from initializer list ilist_ before pos_.
+         *
+         * @return Iterator pointing to the first element inserted, or pos_ if ilist_ is empty.
+         */
+        iterator insert( const_iterator pos_, std::initializer_list<T> ilist_ ) {
+            return insert( pos_, ilist_.begin(), ilist_.end() );
+        }
+        /*!
+         *  Erases the node pointed by 'it_' and returns an iterator
+         *  to the node just past the erased node.
+         *
+         *  \param it_ The node we wish to erase.
+         *  \return An iterator to the node following the erased node.
+         */
+        iterator erase( const_iterator it_ ) {
+            return iterator( unlink_node( it_.m_ptr ) );
+        }
+        /**
+         * @brief Removes the elements in the range [first_, last_).
+         *
+         * @return Iterator following the last removed element.
+         */
+        iterator erase( const_iterator first_, const_iterator last_ ) {
+            Link * p = first_.m_ptr;
+            while ( p != last_.m_ptr )
+                p = unlink_node( p );
+            return iterator( p );
+        }
+
+
+        //=== [V] UTILITY METHODS.
+        /**
+         * @brief Merges two sorted lists into one. The lists should be sorted into ascending order.
+         * `other` is left empty.
+         *
+         * @param other Another container to merge
+         */
+        void merge( small_list & other ) {
+            if ( &other == this )
+                return;
+            Link * p = m_end.next;
+            while ( other.m_len != 0 ) {
+                Link * q = other.m_end.next;
+                while ( p != &m_end and not ( value( q ) < value( p ) ) )
+                    p = p->next;
+                link_before( p, take( other, q ) );
+            }
+        }
+        /**
+         * @brief Transfers elements from one list to another, before `pos`. `other` is left empty.
+         *
+         * @param pos Element before which the content will be inserted
+         * @param other Another container to transfer the content from
+         */
+        void splice( const_iterator pos, small_list & other ) {
+            if ( &other == this )
+                return;
+            while ( other.m_len != 0 )
+                link_before( pos.m_ptr, take( other, other.m_end.next ) );
+        }
+        /**
+         * @brief Reverses the order of the elements in the container.
+         */
+        void reverse( void ) {
+            // Swapping the links of every node, the sentinel included, turns the ring around.
+            Link * p = &m_end;
+            do {
+                std::swap( p->next, p->prev );
+                p = p->prev;
+            } while ( p != &m_end );
+        }
+        /**
+         * @brief Removes all consecutive duplicate elements from the container.
+         */
+        void unique( void ) {
+            if ( m_len < 2 )
+                return;
+            Link * p = m_end.next;
+            while ( p->next != &m_end ) {
+                if ( value( p->next ) == value( p ) )
+                    unlink_node( p->next );
+                else
+                    p = p->next;
+            }
+        }
+        /**
+         * @brief Sorts the elements in ascending order. The sort is stable, takes O(n log n)
+         * comparisons and relinks nodes instead of moving elements, so iterators remain valid.
+         */
+        void sort( void ) {
+            if ( m_len < 2 )
+                return;
+            m_end.prev->next = nullptr;
+            Link * sorted = detail::sort_chain( links{}, m_end.next );
+            // Restore the back links, closing the ring at the sentinel.
+            Link * prev = &m_end;
+            for ( Link * q = sorted; q != nullptr; prev = q, q = q->next ) {
+                prev->next = q;
+                q->prev = prev;
+            }
+            prev->next = &m_end;
+            m_end.prev = prev;
+        }
+
+
+        //=== [VII] SEARCH & REDUCTION.
+        /**
+         * @brief Finds the first element equal to value_.
+         *
+         * @return Iterator to the first element equal to value_, or end() if there is none.
+         */
+        iterator find( const T & value_ ) { return iterator( find_node( value_ ) ); }
+        const_iterator find( const T & value_ ) const { return const_iterator( find_node( value_ ) ); }
+        /**
+         * @brief Checks whether the container holds an element equal to value_.
+         */
+        bool contains( const T & value_ ) const { return find_node( value_ ) != &m_end; }
+        /**
+         * @brief Counts the elements equal to value_.
+         */
+        size_t count( const T & value_ ) const {
+            return detail::count_nodes( links{}, m_end.next, sentinel(), value_ );
+        }
+        /**
+         * @brief Finds the smallest element. If several are equivalent, the first one is returned.
+         *
+         * @return Constant iterator to the smallest element, or cend() if the container is empty.
+         */
+        const_iterator min( void ) const {
+            return const_iterator( detail::min_node( links{}, m_end.next, sentinel() ) );
+        }
+        /**
+         * @brief Finds the largest element. If several are equivalent, the first one is returned.
+         *
+         * @return Constant iterator to the largest element, or cend() if the container is empty.
+         */
+        const_iterator max( void ) const {
+            return const_iterator( detail::max_node( links{}, m_end.next, sentinel() ) );
+        }
+        /**
+         * @brief Sums up all the elements, starting from init_.
+         *
+         * @return init_ plus every element of the container, added from front to back.
+         */
+        template < typename Acc >
+        Acc accumulate( Acc init_ ) const {
+            return detail::accumulate_nodes( links{}, m_end.next, sentinel(), init_ );
+        }
+
+        private:
+        //=== Compile-time dispatch on the element type.
+        using trivial_destroy = std::integral_constant< bool, std::is_trivially_destructible< T >::value >;
+
+        static T & value( Link * p ) { return *reinterpret_cast< T * >( &static_cast< Node * >( p )->storage ); }
+        static const T & value( const Link * p ) {
+            return *reinterpret_cast< const T * >( &static_cast< const Node * >( p )->storage );
+        }
+
+        /// Tells whether `p` is one of the inline slots, rather than a heap node.
+        bool is_inline( const Link * p ) const {
+            std::less< const Link * > before;
+            return not before( p, &m_slots[0] ) and before( p, &m_slots[0] + K );
+        }
+        /// Takes a free slot, or allocates a heap node when there is none left.
+        Node * acquire( void ) {
+            if ( m_free != nullptr ) {
+                Node * n = static_cast< Node * >( m_free );
+                m_free = m_free->next;
+                return n;
+            }
+            if ( m_bump < K )
+                return &m_slots[ m_bump++ ];
+            Node * n = new Node;
+            ++m_spilled;
+            return n;
+        }
+        /// Returns a slot to the free list, or frees a heap node.
+        void release( Link * p ) {
+            if ( is_inline( p ) ) {
+                p->next = m_free;
+                m_free = p;
+            }
+            else {
+                delete static_cast< Node * >( p );
+                --m_spilled;
+            }
+        }
+        /// Takes a node and constructs value_ in it.
+        template < typename U >
+        Node * make_node( U && value_ ) {
+            Node * n = acquire();
+            try {
+                ::new ( static_cast< void * >( &n->storage ) ) T( std::forward< U >( value_ ) );
+            }
+            catch ( ... ) {
+                release( n );
+                throw;
+            }
+            return n;
+        }
+        /// Links the detached node `n` right before `pos`, and returns it.
+        Link * link_before( Link * pos, Link * n ) {
+            n->next = pos;
+            n->prev = pos->prev;
+            pos->prev->next = n;
+            pos->prev = n;
+            ++m_len;
+            return n;
+        }
+        /// Unlinks the element node `p`, without destroying it, and returns the node that followed it.
+        Link * detach( Link * p ) {
+            Link * next = p->next;
+            p->prev->next = next;
+            next->prev = p->prev;
+            --m_len;
+            return next;
+        }
+        /// Unlinks and destroys the element node `p`, and returns the node that followed it.
+        Link * unlink_node( Link * p ) {
+            Link * next = detach( p );
+            value( p ).~T();
+            release( p );
+            return next;
+        }
+        /**
+         * @brief Hands the element node `q` of `other` over to this list, unlinked.
+         * A heap node changes hands as it is; an inline one is moved into a node of this list.
+         */
+        Link * take( small_list & other, Link * q ) {
+            if ( other.is_inline( q ) ) {
+                Node * n = make_node( std::move( value( q ) ) ); // Before touching `other`, in case it throws.
+                other.unlink_node( q );
+                return n;
+            }
+            other.detach( q );
+            --other.m_spilled;
+            ++m_spilled;
+            return q;
+        }
+        /**
+         * @brief Copies the range [first_, last_) into new nodes, linked right before `pos`.
+         *
+         * @return The first node inserted, or `pos` if the range is empty.
+         */
+        template < typename InItr >
+        Link * insert_range( Link * pos, InItr first_, InItr last_ ) {
+            Link * first = pos;
+            size_t count{0};
+            try {
+                for ( ; first_ != last_; ++first_, ++count ) {
+                    Link * n = link_before( pos, make_node( *first_ ) );
+                    if ( count == 0 )
+                        first = n;
+                }
+            }
+            catch ( ... ) {
+                for ( Link * p = first; count > 0; --count )
+                    p = unlink_node( p );
+                throw;
+            }
+            return first;
+        }
+        /// Replaces the elements with copies of [first_, last_), which must not come from this list,
+        /// overwriting the nodes already held. Types that cannot be copy assigned are rebuilt from scratch.
+        template < typename InItr >
+        void assign_nodes( InItr first_, InItr last_ ) {
+            assign_nodes( first_, last_, std::is_copy_assignable< T >{} );
+        }
+        template < typename InItr >
+        void assign_nodes( InItr first_, InItr last_, std::false_type ) {
+            clear();
+            insert_range( &m_end, first_, last_ );
+        }
+        template < typename InItr >
+        void assign_nodes( InItr first_, InItr last_, std::true_type ) {
+            Link * p = m_end.next;
+            for ( ; p != &m_end and first_ != last_; p = p->next, ++first_ )
+                value( p ) = *first_;
+            if ( first_ != last_ )
+                insert_range( &m_end, first_, last_ );
+            while ( p != &m_end )
+                p = unlink_node( p );
+        }
+        /// Finds the first node holding value_, or the sentinel if there is none.
+        Link * find_node( const T & value_ ) const {
+            return detail::find_node( links{}, m_end.next, sentinel(), value_ );
+        }
+        /// The sentinel, as the end of the ranges the scans walk.
+        Link * sentinel( void ) const { return const_cast< Link * >( &m_end ); }
+        /// How the node algorithms of list_algo.h walk this list; chains end at a null link.
+        struct links {
+            using ref = Link *;
+            Link * nil( void ) const { return nullptr; }
+            Link * next( Link * p ) const { return p->next; }
+            void set_next( Link * p, Link * q ) const { p->next = q; }
+            const T & value( Link * p ) const { return small_list::value( static_cast< const Link * >( p ) ); }
+            void step( void ) const {}
+        };
+        /// Trivially destructible elements: only the heap nodes need a walk, to be freed.
+        void free_nodes( std::true_type ) {
+            if ( m_spilled == 0 )
+                return;
+            for ( Link * p = m_end.next; p != &m_end; ) {
+                Link * next = p->next;
+                if ( not is_inline( p ) )
+                    delete static_cast< Node * >( p );
+                p = next;
+            }
+        }
+        void free_nodes( std::false_type ) {
+            for ( Link * p = m_end.next; p != &m_end; ) {
+                Link * next = p->next;
+                value( p ).~T();
+                if ( not is_inline( p ) )
+                    delete static_cast< Node * >( p );
+                p = next;
+            }
+        }
+    };
+
+    //=== [VI] OPERATORS.
+    /**
+     * @brief Checks if the contents of l1_ and l2_ are equal, that is, they have the same number of
+     *        elements and each element in l1_ compares equal with the element in l2_ at the same position.
+     */
+    template < typename T, size_t K >
+    inline bool operator==( const small_list< T, K > & l1_, const small_list< T, K > & l2_ ) {
+        if ( l1_.size() != l2_.size() )
+            return false;
+        auto it2 = l2_.cbegin();
+        for ( auto it1 = l1_.cbegin(); it1 != l1_.cend(); ++it1, ++it2 )
+            if ( not ( *it1 == *it2 ) )
+                return false;
+        return true;
+    }
+    /**
+     * @brief Checks if the contents of l1_ and l2_ are not equal.
+     */
+    template < typename T, size_t K >
+    inline bool operator!=( const small_list< T, K > & l1_, const small_list< T, K > & l2_ ) {
+        return not ( l1_ == l2_ );
+    }
+}
+#endif
@@ -0,0 +1,763 @@
+#ifndef _STATIC_LIST_H_
+#define _STATIC_LIST_H_
+
+/*!
+ * @file static_list.h
+ * @brief A doubly linked list of at most N elements, stored inside the object itself.
+ *
+ * `sc::static_list<T, N>` offers the interface of `sc::list<T>`, but its nodes
+ * live in an array member instead of the heap, so it never allocates. Links are
+ * array indices, as narrow as N allows, and node N is the sentinel, which closes
+ * the list into a ring:
+ *
+ *     +------+------+--------+------+-----+----------+
+ *     | Node | Node | (free) | Node | ... | Sentinel |
+ *     +------+------+--------+------+-----+----------+
+ *     0                                   N
+ *
+ * Nodes that were never used are handed out in order; erased nodes are kept in a
+ * free list threaded through their `next` field, and are recycled first.
+ * Inserting into a full list throws `std::length_error` and leaves it unchanged.
+ *
+ * Since the nodes cannot move to another object, `splice()` and `merge()` move
+ * the elements of the other list instead of relinking its nodes.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>    // memcpy
+#include <initializer_list>
+#include <iterator>
+#include <new>        // placement new
+#include <stdexcept>
+#include <type_traits>
+#include <utility>    // move, forward
+
+#include "list_algo.h"
+
+namespace sc {
+
+    template < typename T, size_t N >
+    class static_list
+    {
+        static_assert( N > 0, "sc::static_list needs room for at least one element." );
+        static_assert( N < UINT32_MAX, "sc::static_list indexes its nodes with 32 bits." );
+
+        private:
+        /// Index of a node in the array; the narrowest type that holds N.
+        using index_t = typename std::conditional< ( N < UINT16_MAX ), std::uint16_t, std::uint32_t >::type;
+        /// The sentinel's index, which also ends detached chains and the free list.
+        static constexpr index_t none = static_cast< index_t >( N );
+
+        //=== The data node. The element is only constructed while the node is in the list.
+        struct Node
+        {
+            typename std::aligned_storage< sizeof( T ), alignof( T ) >::type storage;
+            index_t next;
+            index_t prev;
+        };
+
+
+        //=== The iterator classes.
+        public:
+
+        class const_iterator
+        {
+            public:
+                using value_type        = T;
+                using pointer           = const T *;
+                using reference         = const T &;
+                using difference_type   = std::ptrdiff_t;
+                using iterator_category = std::bidirectional_iterator_tag;
+
+            protected:
+                const static_list * m_list; //!< The list that holds the node.
+                index_t m_idx;              //!< The node index.
+
+            public:
+                /**
+                 * @brief Construct a new const iterator object.
+                 */
+                const_iterator( const static_list * l = nullptr, index_t idx = none ) : m_list{l}, m_idx{idx} {/*empty*/}
+                /**
+                 * @brief The unary indirection operator.
+                 *
+                 * @return a constant reference to the element.
+                 */
+                reference operator*() const {
+                    return m_list->value( m_idx );
+                }
+                /**
+                 * @brief access the members of the element.
+                 */
+                pointer operator->() const {
+                    return &m_list->value( m_idx );
+                }
+                /**
+                 * @brief The operator prefix increment.
+                 *
+                 * @return const_iterator& the iterator itself.
+                 */
+                const_iterator & operator++() {
+                    m_idx = m_list->m_nodes[ m_idx ].next;
+                    return *this;
+                }
+                /**
+                 * @brief The operator postfix increment.
+                 *
+                 * @return const_iterator The iterator before the increment.
+                 */
+                const_iterator operator++(int) {
+                    const_iterator temp{ *this };
+                    ++*this;
+                    return temp;
+                }
+                /**
+                 * @brief The operator prefix decrement.
+                 *
+                 * @return const_iterator& the iterator itself.
+                 */
+                const_iterator & operator--() {
+                    m_idx = m_list->m_nodes[ m_idx ].prev;
+                    return *this;
+                }
+                /**
+                 * @brief The operator postfix decrement.
+                 *
+                 * @return const_iterator The iterator before the decrement.
+                 */
+                const_iterator operator--(int) {
+                    const_iterator temp{ *this };
+                    --*this;
+                    return temp;
+                }
+                /**
+                 * @brief Walks `step` positions forwards, or backwards if `step` is negative.
+                 *
+                 * @return const_iterator& the iterator itself.
+                 */
+                const_iterator & operator+=( difference_type step ) {
+                    for ( ; step > 0; --step )
+                        ++*this;
+                    for ( ; step < 0; ++step )
+                        --*this;
+                    return *this;
+                }
+                /**
+                 * @brief Walks `step` positions backwards, or forwards if `step` is negative.
+                 *
+                 * @return const_iterator& the iterator itself.
+                 */
+                const_iterator & operator-=( difference_type step ) {
+                    return *this += -step;
+                }
+                /**
+                 * @brief The equality operator.
+                 *
+                 * @param rhs Variable on the right side of the operation.
+                 * @return true if both iterators refer to the same node.
+                 */
+                bool operator==( const const_iterator & rhs ) const {
+                    return m_idx == rhs.m_idx and m_list == rhs.m_list;
+                }
+                /**
+                 * @brief The inequality operator.
+                 *
+                 * @param rhs Variable on the right side of the operation.
+                 * @return true if the iterators refer to different nodes.
+                 */
+                bool operator!=( const const_iterator & rhs ) const {
+                    return not ( *this == rhs );
+                }
+
+                friend class static_list<T, N>;
+        };
+
+        class iterator : public const_iterator
+        {
+            public:
+                using pointer   = T *;
+                using reference = T &;
+
+                /**
+                 * @brief Construct a new iterator object.
+                 */
+                iterator( const static_list * l = nullptr, index_t idx = none ) : const_iterator{ l, idx } {/*empty*/}
+                /**
+                 * @brief The unary indirection operator.
+                 *
+                 * @return a reference to the element.
+                 */
+                reference operator*() const {
+                    return const_cast< static_list * >( this->m_list )->value( this->m_idx );
+                }
+                /**
+                 * @brief access the members of the element.
+                 */
+                pointer operator->() const {
+                    return &**this;
+                }
+                iterator & operator++() { const_iterator::operator++(); return *this; }
+                iterator operator++(int) { iterator temp{ *this }; ++*this; return temp; }
+                iterator & operator--() { const_iterator::operator--(); return *this; }
+                iterator operator--(int) { iterator temp{ *this }; --*this; return temp; }
+                iterator & operator+=( typename const_iterator::difference_type step ) { const_iterator::operator+=( step ); return *this; }
+                iterator & operator-=( typename const_iterator::difference_type step ) { const_iterator::operator-=( step ); return *this; }
+
+                friend class static_list<T, N>;
+        };
+
+
+        //=== Private members.
+        private:
+            Node m_nodes[ N + 1 ]; //!< The element nodes, then the sentinel.
+            index_t m_len;         //!< Number of elements.
+            index_t m_bump;        //!< First node never used since the list was last emptied.
+            index_t m_free;        //!< First node of the free list.
+
+        public:
+        //=== [I] Special members.
+        /**
+         * @brief Default constructor, constructs an empty container. No element is constructed.
+         */
+        static_list() : m_len{0}, m_bump{0}, m_free{ none } {
+            m_nodes[ none ].next = none;
+            m_nodes[ none ].prev = none;
+        }
+        /**
+         * @brief Constructs the container with count default-inserted instances of T.
+         *
+         * @throw std::length_error if count is larger than N.
+         */
+        explicit static_list( size_t count ) : static_list() {
+            reserve_for( count );
+            for ( size_t i{0}; i < count; ++i )
+                link_before( none, make_node( T{} ) );
+        }
+        /**
+         * @brief Constructs the container with the contents of the range [first, last).
+         *
+         * @throw std::length_error if the range has more than N elements.
+         */
+        template< typename InputIt >
+        static_list( InputIt first, InputIt last ) : static_list() {
+            insert_range( none, first, last );
+        }
+        /**
+         * @brief Copy constructor. Constructs the container with the copy of the contents of clone_.
+         */
+        static_list( const static_list & clone_ ) : static_list() {
+            copy_from( clone_, trivial_copy{} );
+        }
+        /**
+         * @brief Constructs the container with the contents of the initializer list ilist_.
+         *
+         * @throw std::length_error if ilist_ has more than N elements.
+         */
+        static_list( std::initializer_list<T> ilist_ ) : static_list() {
+            insert_range( none, ilist_.begin(), ilist_.end() );
+        }
+        /**
+         * @brief Destructs the list and its elements.
+         */
+        ~static_list() {
+            destroy_values( trivial_destroy{} );
+        }
+        /**
+         * @brief Copy assignment operator. Replaces the contents with a copy of the contents of rhs.
+         *
+         * @param rhs Another container to use as data source
+         * @return *this
+         */
+        static_list & operator=( const static_list & rhs ) {
+            if ( this == &rhs )
+                return *this;
+            clear();
+            copy_from( rhs, trivial_copy{} );
+            return *this;
+        }
+        /**
+         * @brief Replaces the contents with those identified by initializer list ilist_.
+         *
+         * @param ilist_ Initializer list to use as data source
+         * @return *this
+         * @throw std::length_error if ilist_ has more than N elements; the list is left unchanged.
+         */
+        static_list & operator=( std::initializer_list<T> ilist_ ) {
+            assign( ilist_ );
+            return *this;
+        }
+
+
+        //=== [II] ITERATORS.
+        /**
+         * @brief Returns an iterator to the first element of the list.
+         */
+        iterator begin() { return iterator( this, m_nodes[ none ].next ); }
+        /**
+         * @brief Returns a constant iterator to the first element of the list.
+         */
+        const_iterator cbegin() const { return const_iterator( this, m_nodes[ none ].next ); }
+        const_iterator begin() const { return cbegin(); }
+        /**
+         * @brief Returns an iterator to the element following the last element of the list.
+         */
+        iterator end() { return iterator( this, none ); }
+        /**
+         * @brief Returns a constant iterator to the element following the last element of the list.
+         */
+        const_iterator cend() const { return const_iterator( this, none ); }
+        const_iterator end() const { return cend(); }
+
+
+        //=== [III] Capacity/Status.
+        /**
+         * @brief Checks if the container has no elements.
+         */
+        bool empty( void ) const { return m_len == 0; }
+        /**
+         * @brief Checks if the container cannot take another element.
+         */
+        bool full( void ) const { return m_len == N; }
+        /**
+         * @brief Returns the number of elements in the container.
+         */
+        size_t size( void ) const { return m_len; }
+        /**
+         * @brief Returns the most elements the container can hold, N.
+         */
+        static constexpr size_t capacity( void ) { return N; }
+        static constexpr size_t max_size( void ) { return N; }
+
+
+        //=== [IV] Modifiers.
+        /**
+         * @brief Erases all elements from the container. For trivially destructible T, it takes O(1).
+         */
+        void clear( void ) {
+            destroy_values( trivial_destroy{} );
+            m_len = 0;
+            m_bump = 0;
+            m_free = none;
+            m_nodes[ none ].next = none;
+            m_nodes[ none ].prev = none;
+        }
+        /**
+         * @brief Returns a reference to the first element in the container.
+         */
+        T & front( void ) { return value( m_nodes[ none ].next ); }
+        const T & front( void ) const { return value( m_nodes[ none ].next ); }
+        /**
+         * @brief Returns a reference to the last element in the container.
+         */
+        T & back( void ) { return value( m_nodes[ none ].prev ); }
+        const T & back( void ) const { return value( m_nodes[ none ].prev ); }
+        /**
+         * @brief Prepends the given element value to the beginning of the container.
+         *
+         * @throw std::length_error if the container is full.
+         */
+        void push_front( const T & value_ ) {
+            link_before( m_nodes[ none ].next, make_node( value_ ) );
+        }
+        /**
+         * @brief Appends the given element value to the end of the container.
+         *
+         * @throw std::length_error if the container is full.
+         */
+        void push_back( const T & value_ ) {
+            link_before( none, make_node( value_ ) );
+        }
+        /**
+         * @brief Removes the first element of the container. If there are no elements in the container, the behavior is undefined.
+         */
+        void pop_front( void ) {
+            unlink_node( m_nodes[ none ].next );
+        }
+        /**
+         * @brief Removes the last element of the container. If there are no elements in the container, the behavior is undefined.
+         */
+        void pop_back( void ) {
+            unlink_node( m_nodes[ none ].prev );
+        }
+
+
+        //=== [IV-a] MODIFIERS W/ ITERATORS.
+        /**
+         * @brief Replaces the contents with copies of those in the range [first_, last_).
+         *
+         * The range may come from this very list. A single-pass range cannot be counted before it
+         * is read, so if it does not fit the list is left empty.
+         *
+         * @throw std::length_error if the range has more than N elements; the list is left unchanged.
+         */
+        template < class InItr >
+        void assign( InItr first_, InItr last_ ) {
+            assign_range( first_, last_, std::is_convertible< InItr, const_iterator >{} );
+        }
+        /**
+         * @brief Replaces the contents with the elements from the initializer list ilist_.
+         *
+         * @throw std::length_error if ilist_ has more than N elements; the list is left unchanged.
+         */
+        void assign( std::initializer_list<T> ilist_ ) {
+            reserve_for( ilist_.size() ); // Before the old elements go.
+            clear();
+            insert_range( none, ilist_.begin(), ilist_.end() );
+        }
+        /*!
+         *  Inserts a new value in the list before the iterator 'pos_'
+         *  and returns an iterator to the new node.
+         *
+         *  \param pos_ An iterator to the position before which we want to insert the new data.
+         *  \param value_ The value we want to insert in the list.
+         *  \return An iterator to the new element in the list.
+         *  \throw std::length_error if the container is full.
+         */
+        iterator insert( const_iterator pos_, const T & value_ ) {
+            return iterator( this, link_before( pos_.m_idx, make_node( value_ ) ) );
+        }
+        /**
+         * @brief Inserts elements from range [first_, last_) before pos_.
+         *
+         * @return Iterator pointing to the first element inserted, or pos_ if first_==last_.
+         * @throw std::length_error if the elements do not fit; the list is left unchanged.
+         */
+        template < typename InItr >
+        iterator insert( const_iterator pos_, InItr first_, InItr last_ ) {
+            return iterator( this, insert_range( pos_.m_idx, first_, last_ ) );
+        }
+        /**
+         * @brief Inserts elements from initializer list ilist_ before pos_.
+         *
+         * @return Iterator pointing to the first element inserted, or pos_ if ilist_ is empty.
+         * @throw std::length_error if the elements do not fit; the list is left unchanged.
+         */
+        iterator insert( const_iterator pos_, std::initializer_list<T> ilist_ ) {
+            return insert( pos_, ilist_.begin(), ilist_.end() );
+        }
+        /*!
+         *  Erases the node pointed by 'it_' and returns an iterator
+         *  to the node just past the erased node. The node goes back to the free list.
+         *
+         *  \param it_ The node we wish to erase.
+         *  \return An iterator to the node following the erased node.
+         */
+        iterator erase( const_iterator it_ ) {
+            return iterator( this, unlink_node( it_.m_idx ) );
+        }
+        /**
+         * @brief Removes the elements in the range [first_, last_).
+         *
+         * @return Iterator following the last removed element.
+         */
+        iterator erase( const_iterator first_, const_iterator last_ ) {
+            index_t p = first_.m_idx;
+            while ( p != last_.m_idx )
+                p = unlink_node( p );
+            return iterator( this, p );
+        }
+
+
+        //=== [V] UTILITY METHODS.
+        /**
+         * @brief Merges two sorted lists into one. The lists should be sorted into ascending order.
+         * The elements of `other` are moved into this list, which `other` is left empty.
+         *
+         * @param other Another container to merge
+         * @throw std::length_error if the elements of both lists do not fit; neither list is changed.
+         */
+        void merge( static_list & other ) {
+            if ( &other == this or other.m_len == 0 )
+                return;
+            reserve_for( m_len + other.m_len );
+            index_t p = m_nodes[ none ].next;
+            for ( index_t q = other.m_nodes[ none ].next; q != none; q = other.m_nodes[ q ].next ) {
+                while ( p != none and not ( other.value( q ) < value( p ) ) )
+                    p = m_nodes[ p ].next;
+                link_before( p, make_node( std::move( other.value( q ) ) ) );
+            }
+            other.clear();
+        }
+        /**
+         * @brief Transfers elements from one list to another. Nodes cannot leave the object that
+         * holds them, so the elements of `other` are moved before `pos`, in O(other.size()).
+         *
+         * @param pos Element before which the content will be inserted
+         * @param other Another container to transfer the content from
+         * @throw std::length_error if the elements of both lists do not fit; neither list is changed.
+         */
+        void splice( const_iterator pos, static_list & other ) {
+            if ( &other == this or other.m_len == 0 )
+                return;
+            reserve_for( m_len + other.m_len );
+            for ( index_t q = other.m_nodes[ none ].next; q != none; q = other.m_nodes[ q ].next )
+                link_before( pos.m_idx, make_node( std::move( other.value( q ) ) ) );
+            other.clear();
+        }
+        /**
+         * @brief Reverses the order of the elements in the container.
+         */
+        void reverse( void ) {
+            // Swapping the links of every node, the sentinel included, turns the ring around.
+            // Elements are not moved, so iterators keep pointing to the same elements.
+            index_t p = none;
+            do {
+                std::swap( m_nodes[ p ].next, m_nodes[ p ].prev );
+                p = m_nodes[ p ].prev;
+            } while ( p != none );
+        }
+        /**
+         * @brief Removes all consecutive duplicate elements from the container.
+         */
+        void unique( void ) {
+            if ( m_len < 2 )
+                return;
+            index_t p = m_nodes[ none ].next;
+            while ( m_nodes[ p ].next != none ) {
+                if ( value( m_nodes[ p ].next ) == value( p ) )
+                    unlink_node( m_nodes[ p ].next );
+                else
+                    p = m_nodes[ p ].next;
+            }
+        }
+        /**
+         * @brief Sorts the elements in ascending order. The sort is stable, takes O(n log n)
+         * comparisons and relinks nodes instead of moving elements, so iterators remain valid.
+         */
+        void sort( void ) {
+            if ( m_len < 2 )
+                return;
+            // The ring already ends at the sentinel, so the elements form a chain ended by `none`.
+            index_t sorted = detail::sort_chain( links< static_list >{ this }, m_nodes[ none ].next );
+            // Restore the back links, closing the ring at the sentinel.
+            index_t prev = none;
+            for ( index_t q = sorted; q != none; prev = q, q = m_nodes[ q ].next ) {
+                m_nodes[ prev ].next = q;
+                m_nodes[ q ].prev = prev;
+            }
+            m_nodes[ prev ].next = none;
+            m_nodes[ none ].prev = prev;
+        }
+
+
+        //=== [VII] SEARCH & REDUCTION.
+        /**
+         * @brief Finds the first element equal to value_.
+         *
+         * @return Iterator to the first element equal to value_, or end() if there is none.
+         */
+        iterator find( const T & value_ ) { return iterator( this, find_node( value_ ) ); }
+        const_iterator find( const T & value_ ) const { return const_iterator( this, find_node( value_ ) ); }
+        /**
+         * @brief Checks whether the container holds an element equal to value_.
+         */
+        bool contains( const T & value_ ) const { return find_node( value_ ) != none; }
+        /**
+         * @brief Counts the elements equal to value_.
+         */
+        size_t count( const T & value_ ) const {
+            return detail::count_nodes( links< const static_list >{ this }, m_nodes[ none ].next, none, value_ );
+        }
+        /**
+         * @brief Finds the smallest element. If several are equivalent, the first one is returned.
+         *
+         * @return Constant iterator to the smallest element, or cend() if the container is empty.
+         */
+        const_iterator min( void ) const {
+            return const_iterator( this, detail::min_node( links< const static_list >{ this }, m_nodes[ none ].next, none ) );
+        }
+        /**
+         * @brief Finds the largest element. If several are equivalent, the first one is returned.
+         *
+         * @return Constant iterator to the largest element, or cend() if the container is empty.
+         */
+        const_iterator max( void ) const {
+            return const_iterator( this, detail::max_node( links< const static_list >{ this }, m_nodes[ none ].next, none ) );
+        }
+        /**
+         * @brief Sums up all the elements, starting from init_.
+         *
+         * @return init_ plus every element of the container, added from front to back.
+         */
+        template < typename Acc >
+        Acc accumulate( Acc init_ ) const {
+            return detail::accumulate_nodes( links< const static_list >{ this }, m_nodes[ none ].next, none, init_ );
+        }
+
+        private:
+        //=== Compile-time dispatch on the element type.
+        using trivial_copy = std::integral_constant< bool, std::is_trivially_copyable< T >::value >;
+        using trivial_destroy = std::integral_constant< bool, std::is_trivially_destructible< T >::value >;
+
+        T & value( index_t i ) { return *reinterpret_cast< T * >( &m_nodes[ i ].storage ); }
+        const T & value( index_t i ) const { return *reinterpret_cast< const T * >( &m_nodes[ i ].storage ); }
+
+        /// Throws, before anything is changed, unless `count` elements fit.
+        static void reserve_for( size_t count ) {
+            if ( count > N )
+                throw std::length_error( "sc::static_list: capacity exceeded" );
+        }
+        /// Takes a node from the free list, or the first never used one.
+        index_t acquire( void ) {
+            if ( m_free != none ) {
+                index_t i = m_free;
+                m_free = m_nodes[ i ].next;
+                return i;
+            }
+            if ( m_bump == N )
+                throw std::length_error( "sc::static_list: capacity exceeded" );
+            return m_bump++;
+        }
+        /// Returns a node to the free list.
+        void release( index_t i ) {
+            m_nodes[ i ].next = m_free;
+            m_free = i;
+        }
+        /// Takes a node and constructs a copy of value_ in it.
+        template < typename U >
+        index_t make_node( U && value_ ) {
+            index_t i = acquire();
+            try {
+                ::new ( static_cast< void * >( &m_nodes[ i ].storage ) ) T( std::forward< U >( value_ ) );
+            }
+            catch ( ... ) {
+                release( i );
+                throw;
+            }
+            return i;
+        }
+        /// Links the detached node `i` right before `pos`, and returns it.
+        index_t link_before( index_t pos, index_t i ) {
+            index_t prev = m_nodes[ pos ].prev;
+            m_nodes[ i ].next = pos;
+            m_nodes[ i ].prev = prev;
+            m_nodes[ prev ].next = i;
+            m_nodes[ pos ].prev = i;
+            ++m_len;
+            return i;
+        }
+        /// Unlinks and destroys the element node `i`, and returns the node that followed it.
+        index_t unlink_node( index_t i ) {
+            index_t next = m_nodes[ i ].next;
+            index_t prev = m_nodes[ i ].prev;
+            m_nodes[ prev ].next = next;
+            m_nodes[ next ].prev = prev;
+            value( i ).~T();
+            release( i );
+            --m_len;
+            return next;
+        }
+        /**
+         * @brief Copies the range [first_, last_) into new nodes, linked right before `pos`.
+         *
+         * @return The first node inserted, or `pos` if the range is empty.
+         * @throw std::length_error if the range does not fit, after taking back what it inserted.
+         */
+        template < typename InItr >
+        index_t insert_range( index_t pos, InItr first_, InItr last_ ) {
+            index_t first = pos;
+            size_t count{0};
+            try {
+                for ( ; first_ != last_; ++first_, ++count ) {
+                    index_t i = link_before( pos, make_node( *first_ ) );
+                    if ( count == 0 )
+                        first = i;
+                }
+            }
+            catch ( ... ) {
+                for ( index_t i = first; count > 0; --count )
+                    i = unlink_node( i );
+                throw;
+            }
+            return first;
+        }
+        /// A range of a list of this type: if it is this list, the range is kept and the rest erased.
+        template < typename InItr >
+        void assign_range( InItr first_, InItr last_, std::true_type ) {
+            const_iterator first{ first_ }, last{ last_ };
+            if ( first.m_list != this )
+                return assign_range( first, last, std::false_type{} );
+            erase( cbegin(), first );
+            erase( last, cend() );
+        }
+        template < typename InItr >
+        void assign_range( InItr first_, InItr last_, std::false_type ) {
+            assign_range( first_, last_, typename std::iterator_traits< InItr >::iterator_category{} );
+        }
+        /// The range is counted once, so a range that does not fit is rejected before anything goes.
+        template < typename InItr >
+        void assign_range( InItr first_, InItr last_, std::forward_iterator_tag ) {
+            reserve_for( static_cast< size_t >( std::distance( first_, last_ ) ) );
+            clear();
+            insert_range( none, first_, last_ );
+        }
+        template < typename InItr >
+        void assign_range( InItr first_, InItr last_, std::input_iterator_tag ) {
+            clear();
+            insert_range( none, first_, last_ );
+        }
+        /// Finds the first node holding value_, or the sentinel if there is none.
+        index_t find_node( const T & value_ ) const {
+            return detail::find_node( links< const static_list >{ this }, m_nodes[ none ].next, none, value_ );
+        }
+        /// How the node algorithms of list_algo.h walk this list, whose chains end at `none`.
+        /// Through a `const static_list` the links can only be read.
+        template < typename List >
+        struct links {
+            using ref = index_t;
+            List * owner;
+            index_t nil( void ) const { return none; }
+            index_t next( index_t i ) const { return owner->m_nodes[ i ].next; }
+            void set_next( index_t i, index_t j ) const { owner->m_nodes[ i ].next = j; }
+            const T & value( index_t i ) const { return owner->value( i ); }
+            void step( void ) const {}
+        };
+        /// Trivially copyable elements: the nodes in use are copied as they are, links included.
+        /// The list must be empty.
+        void copy_from( const static_list & other, std::true_type ) {
+            std::memcpy( static_cast< void * >( m_nodes ), other.m_nodes, other.m_bump * sizeof( Node ) );
+            m_nodes[ none ] = other.m_nodes[ none ];
+            m_len = other.m_len;
+            m_bump = other.m_bump;
+            m_free = other.m_free;
+        }
+        /// Any other element is copied one at a time. The list must be empty.
+        void copy_from( const static_list & other, std::false_type ) {
+            insert_range( none, other.cbegin(), other.cend() );
+        }
+        /// Trivially destructible elements need nothing done.
+        void destroy_values( std::true_type ) {}
+        void destroy_values( std::false_type ) {
+            for ( index_t p = m_nodes[ none ].next; p != none; p = m_nodes[ p ].next )
+                value( p ).~T();
+        }
+    };
+
+    template < typename T, size_t N >
+    constexpr typename static_list< T, N >::index_t static_list< T, N >::none;
+
+    //=== [VI] OPERATORS.
+    /**
+     * @brief Checks if the contents of l1_ and l2_ are equal, that is, they have the same number of
+     *        elements and each element in l1_ compares equal with the element in l2_ at the same position.
+     */
+    template < typename T, size_t N >
+    inline bool operator==( const static_list< T, N > & l1_, const static_list< T, N > & l2_ ) {
+        if ( l1_.size() != l2_.size() )
+            return false;
+        auto it2 = l2_.cbegin();
+        for ( auto it1 = l1_.cbegin(); it1 != l1_.cend(); ++it1, ++it2 )
+            if ( not ( *it1 == *it2 ) )
+                return false;
+        return true;
+    }
+    /**
+     * @brief Checks if the contents of l1_ and l2_ are not equal.
+     */
+    template < typename T, size_t N >
+    inline bool operator!=( const static_list< T, N > & l1_, const static_list< T, N > & l2_ ) {
+        return not ( l1_ == l2_ );
+    }
+}
+#endif
@@ -0,0 +1,379 @@
+/*!
+ * @file main.cpp
+ * @brief Soak test: long mixed workloads on large `sc::list`s, sampling memory and latency over time.
+ *
+ * Three workloads run one after the other, each for a fixed time:
+ *
+ * - `churn`: a list of `--nodes` elements is loaded, then kept at about that size by
+ *   random pushes, pops, inserts and erases around a cursor that wanders through it.
+ * - `bulk`: a list is loaded with `--nodes` elements and drained, over and over.
+ * - `small`: `--nodes` / 8 lists of about 8 elements each get random pushes and pops.
+ *
+ * Every `--sample-ms` a line is written with the resident set size, the heap in use, free
+ * and mapped as reported by the allocator, the share of the heap that sits free
+ * (fragmentation), and the p50, p99 and p99.9 latency of the operations done since the
+ * last sample. Latencies include the cost of reading the clock twice, some 20 to 40 ns.
+ *
+ * Usage: list_soak [--workload=churn,bulk,small] [--nodes=N] [--seconds=S]
+ *                  [--sample-ms=N] [--seed=N] [--format=csv|json] [--out=file]
+ */
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#if defined(__linux__)
+#   include <unistd.h>  // sysconf
+#endif
+#if defined(__GLIBC__) && ( __GLIBC__ > 2 || ( __GLIBC__ == 2 && __GLIBC_MINOR__ >= 33 ) )
+#   define SOAK_HAS_MALLINFO2
+#   include <malloc.h>
+#endif
+
+#include "../include/list.h"
+
+namespace {
+
+    using clock = std::chrono::steady_clock;
+
+    //=== Latency.
+
+    /// Latency histogram with 16 buckets per power of two, so percentiles are within 6%.
+    class histogram {
+        public:
+            void add( std::uint64_t ns ) {
+                ++m_counts[ bucket( ns ) ];
+                ++m_total;
+                m_max = std::max( m_max, ns );
+            }
+            void add( const histogram & other ) {
+                for ( size_t b{0}; b < n_buckets; ++b )
+                    m_counts[b] += other.m_counts[b];
+                m_total += other.m_total;
+                m_max = std::max( m_max, other.m_max );
+            }
+            void clear( void ) { *this = histogram{}; }
+            std::uint64_t total( void ) const { return m_total; }
+            std::uint64_t max( void ) const { return m_max; }
+            /// The latency below which a share `q` (0 to 1) of the samples fall, in nanoseconds.
+            double percentile( double q ) const {
+                if ( m_total == 0 )
+                    return 0;
+                auto rank = static_cast< std::uint64_t >( q * static_cast< double >( m_total - 1 ) );
+                std::uint64_t seen{0};
+                for ( size_t b{0}; b < n_buckets; ++b ) {
+                    seen += m_counts[b];
+                    if ( seen > rank )
+                        return std::min( midpoint( b ), static_cast< double >( m_max ) );
+                }
+                return static_cast< double >( m_max );
+            }
+
+        private:
+            static constexpr int sub_bits = 4;
+            static constexpr std::uint64_t sub = 1u << sub_bits;
+            static constexpr size_t n_buckets = 64 * sub;
+            std::array< std::uint64_t, n_buckets > m_counts{};
+            std::uint64_t m_total{0};
+            std::uint64_t m_max{0};
+
+            /// Values below 16 get a bucket each; above, a bucket spans 1/16 of its power of two.
+            static size_t bucket( std::uint64_t ns ) {
+                if ( ns < sub )
+                    return static_cast< size_t >( ns );
+                int msb = 63 - __builtin_clzll( ns );
+                int shift = msb - sub_bits;
+                return static_cast< size_t >( ( shift + 1 ) * sub + ( ( ns >> shift ) - sub ) );
+            }
+            static double midpoint( size_t b ) {
+                if ( b < sub )
+                    return static_cast< double >( b );
+                int shift = static_cast< int >( b / sub ) - 1;
+                double low = static_cast< double >( ( sub + b % sub ) << shift );
+                return low + static_cast< double >( std::uint64_t{1} << shift ) / 2;
+            }
+    };
+
+    //=== Memory.
+
+    /// Resident set size of this process, in bytes; 0 if unknown.
+    size_t rss_bytes( void ) {
+#if defined(__linux__)
+        std::ifstream statm{ "/proc/self/statm" };
+        size_t total{0}, resident{0};
+        if ( statm >> total >> resident )
+            return resident * static_cast< size_t >( sysconf( _SC_PAGESIZE ) );
+#endif
+        return 0;
+    }
+
+    /// What the allocator holds, in bytes; all zero if it cannot tell.
+    struct heap_info {
+        size_t in_use{0};  //!< Bytes handed out by malloc and not freed.
+        size_t free{0};    //!< Bytes of the heap that are free, but still held by the allocator.
+        size_t mapped{0};  //!< Bytes of large blocks mapped on their own.
+        /// Share of the heap that is free: holes left between the blocks in use.
+        double fragmentation( void ) const {
+            return in_use + free == 0 ? 0 : static_cast< double >( free ) / static_cast< double >( in_use + free );
+        }
+    };
+
+    heap_info heap( void ) {
+        heap_info h;
+#ifdef SOAK_HAS_MALLINFO2
+        struct mallinfo2 mi = mallinfo2();
+        h.in_use = mi.uordblks;
+        h.free = mi.fordblks;
+        h.mapped = mi.hblkhd;
+#endif
+        return h;
+    }
+
+    //=== Sampling.
+
+    struct options {
+        std::vector< std::string > workloads{ "churn", "bulk", "small" };
+        size_t nodes{ 1000000 };
+        double seconds{ 60 };      //!< How long each workload runs.
+        double sample_ms{ 1000 };
+        std::uint64_t seed{ 1 };
+        std::string format{ "csv" };
+        std::string out;
+    };
+
+    /// Writes a line per sample and keeps the totals of the current workload.
+    class sampler {
+        public:
+            sampler( std::ostream & os, const options & opt ) : m_os{ os }, m_opt{ opt } {
+                if ( m_opt.format == "csv" )
+                    m_os << "workload,elapsed_s,nodes,ops,ops_per_s,rss_mb,heap_in_use_mb,heap_free_mb,"
+                            "heap_mapped_mb,fragmentation,p50_ns,p99_ns,p999_ns,max_ns\n";
+            }
+
+            /// Starts a workload.
+            void begin( const std::string & workload ) {
+                m_workload = workload;
+                m_start = m_last = clock::now();
+                m_next = m_start + period();
+                m_end = m_start + std::chrono::duration_cast< clock::duration >( std::chrono::duration< double >( m_opt.seconds ) );
+                m_interval.clear();
+                m_overall.clear();
+                m_peak_rss = 0;
+            }
+            /// Records the latency of one operation, from `t0` to `t1`; samples if it is time to.
+            /// @return false once the workload has run for long enough.
+            bool record( clock::time_point t0, clock::time_point t1, size_t nodes ) {
+                m_interval.add( static_cast< std::uint64_t >( std::chrono::duration_cast< std::chrono::nanoseconds >( t1 - t0 ).count() ) );
+                if ( t1 < m_next )
+                    return true;
+                sample( t1, nodes );
+                return t1 < m_end;
+            }
+            /// Prints the totals of the workload, to stderr.
+            void end( void ) {
+                std::cerr << "list_soak: " << m_workload << ": " << m_overall.total() << " operations, p50 "
+                          << m_overall.percentile( 0.5 ) << " ns, p99 " << m_overall.percentile( 0.99 )
+                          << " ns, p99.9 " << m_overall.percentile( 0.999 ) << " ns, max " << m_overall.max()
+                          << " ns, peak RSS " << m_peak_rss / 1048576.0 << " MB\n";
+            }
+
+        private:
+            std::ostream & m_os;
+            const options & m_opt;
+            std::string m_workload;
+            clock::time_point m_start, m_last, m_next, m_end;
+            histogram m_interval, m_overall;
+            size_t m_peak_rss{0};
+
+            clock::duration period( void ) const {
+                return std::chrono::duration_cast< clock::duration >( std::chrono::duration< double, std::milli >( m_opt.sample_ms ) );
+            }
+            void sample( clock::time_point now, size_t nodes ) {
+                double elapsed = std::chrono::duration< double >( now - m_start ).count();
+                double interval = std::chrono::duration< double >( now - m_last ).count();
+                size_t rss = rss_bytes();
+                heap_info h = heap();
+                const double mb = 1048576.0;
+                double ops_per_s = interval > 0 ? static_cast< double >( m_interval.total() ) / interval : 0;
+                m_peak_rss = std::max( m_peak_rss, rss );
+                if ( m_opt.format == "csv" )
+                    m_os << m_workload << ',' << elapsed << ',' << nodes << ',' << m_interval.total() << ',' << ops_per_s
+                         << ',' << rss / mb << ',' << h.in_use / mb << ',' << h.free / mb << ',' << h.mapped / mb
+                         << ',' << h.fragmentation() << ',' << m_interval.percentile( 0.5 ) << ','
+                         << m_interval.percentile( 0.99 ) << ',' << m_interval.percentile( 0.999 ) << ','
+                         << m_interval.max() << '\n';
+                else
+                    m_os << "{\"workload\":\"" << m_workload << "\",\"elapsed_s\":" << elapsed << ",\"nodes\":" << nodes
+                         << ",\"ops\":" << m_interval.total() << ",\"ops_per_s\":" << ops_per_s
+                         << ",\"rss_mb\":" << rss / mb << ",\"heap_in_use_mb\":" << h.in_use / mb
+                         << ",\"heap_free_mb\":" << h.free / mb << ",\"heap_mapped_mb\":" << h.mapped / mb
+                         << ",\"fragmentation\":" << h.fragmentation() << ",\"p50_ns\":" << m_interval.percentile( 0.5 )
+                         << ",\"p99_ns\":" << m_interval.percentile( 0.99 ) << ",\"p999_ns\":" << m_interval.percentile( 0.999 )
+                         << ",\"max_ns\":" << m_interval.max() << "}\n";
+                m_os.flush();
+                m_overall.add( m_interval );
+                m_interval.clear();
+                m_last = clock::now();
+                m_next = m_last + period();
+            }
+    };
+
+    //=== Workloads.
+
+    using list_t = sc::list< int >;
+
+    /// Loads a list, then keeps its size around `--nodes` with random edits around a wandering cursor.
+    void churn( const options & opt, sampler & s, std::mt19937_64 & rng )
+    {
+        list_t l;
+        const size_t low = opt.nodes - opt.nodes / 100, high = opt.nodes + opt.nodes / 100;
+        for ( size_t i{0}; i < opt.nodes; ++i ) {
+            auto t0 = clock::now();
+            l.push_back( static_cast< int >( rng() ) );
+            if ( not s.record( t0, clock::now(), l.size() ) )
+                return;
+        }
+        auto cur = l.begin();
+        for ( ;; ) {
+            std::uint64_t r = rng();
+            // Wander: the cursor moves a few nodes, so edits hit memory all over the list.
+            for ( std::uint64_t steps = ( r >> 8 ) % 8; steps > 0 and cur != l.end(); --steps )
+                ++cur;
+            if ( cur == l.end() )
+                cur = l.begin();
+            unsigned what = r % 4;
+            if ( l.size() < low ) what = what % 2;        // Grow only.
+            else if ( l.size() > high ) what = 2 + what % 2; // Shrink only.
+            auto t0 = clock::now();
+            switch ( what ) {
+                case 0: l.push_back( static_cast< int >( r ) ); break;
+                case 1: cur = l.insert( cur, static_cast< int >( r ) ); break;
+                case 2:
+                    if ( cur == l.begin() ) { l.pop_front(); cur = l.begin(); }
+                    else l.pop_front();
+                    break;
+                default: cur = l.erase( cur ); break;
+            }
+            if ( not s.record( t0, clock::now(), l.size() ) )
+                return;
+        }
+    }
+
+    /// Loads a list with `--nodes` elements and drains it from the front, over and over.
+    void bulk( const options & opt, sampler & s, std::mt19937_64 & rng )
+    {
+        list_t l;
+        for ( ;; ) {
+            for ( size_t i{0}; i < opt.nodes; ++i ) {
+                auto t0 = clock::now();
+                l.push_back( static_cast< int >( rng() ) );
+                if ( not s.record( t0, clock::now(), l.size() ) )
+                    return;
+            }
+            while ( not l.empty() ) {
+                auto t0 = clock::now();
+                l.pop_front();
+                if ( not s.record( t0, clock::now(), l.size() ) )
+                    return;
+            }
+        }
+    }
+
+    /// Random pushes and pops on many lists of about 8 elements, `--nodes` elements in all.
+    void small( const options & opt, sampler & s, std::mt19937_64 & rng )
+    {
+        std::vector< list_t > lists( std::max< size_t >( opt.nodes / 8, 1 ) );
+        size_t nodes{0};
+        for ( auto & l : lists )
+            for ( int i{0}; i < 8; ++i, ++nodes )
+                l.push_back( static_cast< int >( rng() ) );
+        for ( ;; ) {
+            std::uint64_t r = rng();
+            list_t & l = lists[ ( r >> 1 ) % lists.size() ];
+            auto t0 = clock::now();
+            if ( r % 2 == 0 or l.empty() ) {
+                l.push_back( static_cast< int >( r ) );
+                ++nodes;
+            }
+            else {
+                l.pop_front();
+                --nodes;
+            }
+            if ( not s.record( t0, clock::now(), nodes ) )
+                return;
+        }
+    }
+
+    //=== Command line.
+
+    std::vector< std::string > split( const std::string & s ) {
+        std::vector< std::string > parts;
+        std::istringstream iss{ s };
+        for ( std::string part; std::getline( iss, part, ',' ); )
+            if ( not part.empty() )
+                parts.push_back( part );
+        return parts;
+    }
+
+    bool parse( int argc, char * argv[], options & opt )
+    {
+        for ( int i{1}; i < argc; ++i )
+        {
+            std::string arg{ argv[i] };
+            auto value = [&]( const char * name ) -> const char * {
+                size_t len = std::strlen( name );
+                return arg.compare( 0, len, name ) == 0 ? arg.c_str() + len : nullptr;
+            };
+            if ( auto v = value( "--workload=" ) )       opt.workloads = split( v );
+            else if ( auto v = value( "--nodes=" ) )     opt.nodes = std::max< size_t >( std::strtoull( v, nullptr, 10 ), 1 );
+            else if ( auto v = value( "--seconds=" ) )   opt.seconds = std::atof( v );
+            else if ( auto v = value( "--sample-ms=" ) ) opt.sample_ms = std::max( std::atof( v ), 1.0 );
+            else if ( auto v = value( "--seed=" ) )      opt.seed = std::strtoull( v, nullptr, 10 );
+            else if ( auto v = value( "--format=" ) )    opt.format = v;
+            else if ( auto v = value( "--out=" ) )       opt.out = v;
+            else return false;
+        }
+        if ( opt.format != "csv" and opt.format != "json" )
+            return false;
+        for ( const auto & w : opt.workloads )
+            if ( w != "churn" and w != "bulk" and w != "small" )
+                return false;
+        return true;
+    }
+}
+
+int main( int argc, char * argv[] )
+{
+    options opt;
+    if ( not parse( argc, argv, opt ) )
+    {
+        std::cerr << "Usage: " << argv[0] << " [--workload=churn,bulk,small] [--nodes=N] [--seconds=S]"
+                  << " [--sample-ms=N] [--seed=N] [--format=csv|json] [--out=file]\n";
+        return EXIT_FAILURE;
+    }
+
+    std::ofstream ofs;
+    if ( not opt.out.empty() )
+        ofs.open( opt.out );
+    std::ostream & os = opt.out.empty() ? std::cout : ofs;
+    sampler s{ os, opt };
+    std::mt19937_64 rng{ opt.seed };
+    for ( const auto & w : opt.workloads )
+    {
+        s.begin( w );
+        if ( w == "churn" ) churn( opt, s, rng );
+        else if ( w == "bulk" ) bulk( opt, s, rng );
+        else small( opt, s, rng );
+        s.end();
+    }
+    return EXIT_SUCCESS;
+}
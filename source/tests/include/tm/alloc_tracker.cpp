@@ -0,0 +1,66 @@
+/*!
+ * @file alloc_tracker.cpp
+ * @brief Replacement global allocation functions that count the heap activity of every test.
+ * @date October 18th, 2026
+ *
+ * Linking this file into a test driver turns allocation tracking on (see `TM_TRACK_ALLOCS` in
+ * tests/CMakeLists.txt): the summary then shows the allocations, frees, peak and leaked bytes
+ * of each test, and `EXPECT_ALLOCS_LE` and `EXPECT_NO_LEAK` check them. Every block carries a
+ * small header with its size, so frees are counted in bytes too. Each thread counts on its own,
+ * except while a serial test runs: every thread then counts into one shared record, so blocks
+ * freed on another thread than the one that allocated them still match. The over-aligned forms of
+ * `operator new` are left alone, so their blocks are not counted.
+ */
+
+#include "test_manager.h"
+
+#include <cstddef>  // max_align_t
+#include <cstdlib>  // malloc, free
+#include <new>
+
+namespace {
+    /// Room for the size of a block, keeping the block itself aligned for any type.
+    constexpr size_t header = alignof( std::max_align_t );
+
+    /// Tells the test manager, before `main()`, that allocations are counted.
+    struct registrar {
+        registrar() { TestManager::enable_alloc_tracking(); }
+    } const registered;
+}
+
+void * operator new( size_t size )
+{
+    void * raw = std::malloc( size + header );
+    if ( raw == nullptr )
+        throw std::bad_alloc{};
+    *static_cast< size_t * >( raw ) = size;
+    TestManager::count_alloc( size );
+    return static_cast< char * >( raw ) + header;
+}
+
+void operator delete( void * p ) noexcept
+{
+    if ( p == nullptr )
+        return;
+    void * raw = static_cast< char * >( p ) - header;
+    TestManager::count_free( *static_cast< size_t * >( raw ) );
+    std::free( raw );
+}
+
+void * operator new[]( size_t size ) { return ::operator new( size ); }
+void operator delete[]( void * p ) noexcept { ::operator delete( p ); }
+void operator delete( void * p, size_t ) noexcept { ::operator delete( p ); }
+void operator delete[]( void * p, size_t ) noexcept { ::operator delete( p ); }
+
+void * operator new( size_t size, const std::nothrow_t & ) noexcept
+{
+    try { return ::operator new( size ); }
+    catch ( ... ) { return nullptr; }
+}
+void * operator new[]( size_t size, const std::nothrow_t & ) noexcept
+{
+    try { return ::operator new( size ); }
+    catch ( ... ) { return nullptr; }
+}
+void operator delete( void * p, const std::nothrow_t & ) noexcept { ::operator delete( p ); }
+void operator delete[]( void * p, const std::nothrow_t & ) noexcept { ::operator delete( p ); }
@@ -0,0 +1,180 @@
+/*!
+ * @file reporter.cpp
+ * @brief Implementation of the JUnit XML and JSON Lines reporters.
+ * @date October 18th, 2026
+ */
+
+#include "reporter.h"
+
+#include <cstdio>     // snprintf
+#include <iomanip>    // setprecision
+#include <stdexcept>
+
+namespace {
+    /// Escapes the characters XML does not allow in attribute values and text.
+    std::string xml_escape( const std::string & s )
+    {
+        std::string out;
+        out.reserve( s.size() );
+        for ( char c : s )
+        {
+            switch ( c )
+            {
+                case '&':  out += "&amp;";  break;
+                case '<':  out += "&lt;";   break;
+                case '>':  out += "&gt;";   break;
+                case '"':  out += "&quot;"; break;
+                case '\'': out += "&apos;"; break;
+                default:   out += c;
+            }
+        }
+        return out;
+    }
+
+    /// Quotes a string as a JSON string literal.
+    std::string json_quote( const std::string & s )
+    {
+        std::string out{ "\"" };
+        for ( char c : s )
+        {
+            switch ( c )
+            {
+                case '"':  out += "\\\""; break;
+                case '\\': out += "\\\\"; break;
+                case '\n': out += "\\n";  break;
+                case '\t': out += "\\t";  break;
+                case '\r': out += "\\r";  break;
+                default:
+                    if ( static_cast< unsigned char >( c ) < 0x20 )
+                    {
+                        char buf[8];
+                        std::snprintf( buf, sizeof( buf ), "\\u%04x", c );
+                        out += buf;
+                    }
+                    else out += c;
+            }
+        }
+        return out + "\"";
+    }
+
+    void open( std::ofstream & out, const std::string & filename )
+    {
+        out.open( filename, std::ios::trunc );
+        if ( not out )
+            throw std::runtime_error( "TestManager: cannot open report file " + filename );
+    }
+}
+
+const char * to_string( TestReport::status_t status )
+{
+    static const char * const names[] = { "passed", "failed", "disabled", "undefined", "crashed", "timeout" };
+    return names[ static_cast< int >( status ) ];
+}
+
+//=== Reporter
+
+void Reporter::suite_begin( const std::string & suite, size_t n_tests )
+{
+    std::lock_guard< std::mutex > lock{ m_mutex };
+    on_suite_begin( suite, n_tests );
+}
+
+void Reporter::test_end( const TestReport & report )
+{
+    std::lock_guard< std::mutex > lock{ m_mutex };
+    on_test_end( report );
+}
+
+void Reporter::suite_end( const std::string & suite, size_t n_passed, size_t n_failed, size_t n_disabled, double wall_ms )
+{
+    std::lock_guard< std::mutex > lock{ m_mutex };
+    on_suite_end( suite, n_passed, n_failed, n_disabled, wall_ms );
+}
+
+//=== JUnitReporter
+
+JUnitReporter::JUnitReporter( const std::string & filename )
+{
+    open( m_out, filename );
+    m_out << std::fixed << std::setprecision( 6 ); // JUnit times are plain decimals, in seconds.
+    m_out << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<testsuites>\n" << std::flush;
+}
+
+JUnitReporter::~JUnitReporter()
+{
+    if ( m_in_suite )
+        m_out << "  </testsuite>\n";
+    m_out << "</testsuites>\n";
+}
+
+void JUnitReporter::on_suite_begin( const std::string & suite, size_t n_tests )
+{
+    if ( m_in_suite )
+        m_out << "  </testsuite>\n";
+    m_out << "  <testsuite name=\"" << xml_escape( suite ) << "\" tests=\"" << n_tests << "\">\n" << std::flush;
+    m_in_suite = true;
+}
+
+void JUnitReporter::on_test_end( const TestReport & r )
+{
+    m_out << "    <testcase name=\"" << xml_escape( r.name ) << "\" classname=\"" << xml_escape( r.suite )
+          << "\" time=\"" << r.wall_ms / 1e3 << "\">\n"
+          << "      <properties>\n"
+          << "        <property name=\"description\" value=\"" << xml_escape( r.desc ) << "\"/>\n"
+          << "        <property name=\"cpu_time\" value=\"" << r.cpu_ms / 1e3 << "\"/>\n"
+          << "        <property name=\"enabled\" value=\"" << ( r.enabled ? "true" : "false" ) << "\"/>\n";
+    if ( r.heap_tracked )
+        m_out << "        <property name=\"allocs\" value=\"" << r.allocs << "\"/>\n"
+              << "        <property name=\"frees\" value=\"" << r.frees << "\"/>\n"
+              << "        <property name=\"peak_bytes\" value=\"" << r.peak_bytes << "\"/>\n"
+              << "        <property name=\"leaked_bytes\" value=\"" << r.leaked_bytes << "\"/>\n";
+    m_out << "      </properties>\n";
+    if ( r.status == TestReport::status_t::FAILED )
+        m_out << "      <failure message=\"" << xml_escape( r.message ) << "\" type=\"assertion\">line "
+              << r.line << "</failure>\n";
+    else if ( r.status == TestReport::status_t::CRASHED or r.status == TestReport::status_t::TIMEOUT )
+        m_out << "      <error message=\"" << xml_escape( r.message ) << "\" type=\"" << to_string( r.status ) << "\"/>\n";
+    else if ( r.status == TestReport::status_t::DISABLED )
+        m_out << "      <skipped message=\"disabled\"/>\n";
+    else if ( r.status == TestReport::status_t::UNDEFINED )
+        m_out << "      <skipped message=\"no assertion was checked\"/>\n";
+    m_out << "    </testcase>\n" << std::flush;
+}
+
+void JUnitReporter::on_suite_end( const std::string &, size_t, size_t, size_t, double )
+{
+    if ( m_in_suite )
+        m_out << "  </testsuite>\n" << std::flush;
+    m_in_suite = false;
+}
+
+//=== JsonReporter
+
+JsonReporter::JsonReporter( const std::string & filename )
+{
+    open( m_out, filename );
+}
+
+void JsonReporter::on_suite_begin( const std::string & suite, size_t n_tests )
+{
+    m_out << "{\"event\":\"suite_begin\",\"suite\":" << json_quote( suite ) << ",\"tests\":" << n_tests << "}\n" << std::flush;
+}
+
+void JsonReporter::on_test_end( const TestReport & r )
+{
+    m_out << "{\"event\":\"test\",\"suite\":" << json_quote( r.suite ) << ",\"name\":" << json_quote( r.name )
+          << ",\"description\":" << json_quote( r.desc ) << ",\"seq\":" << r.seq
+          << ",\"status\":\"" << to_string( r.status ) << "\",\"enabled\":" << ( r.enabled ? "true" : "false" )
+          << ",\"line\":" << r.line << ",\"message\":" << json_quote( r.message )
+          << ",\"wall_ms\":" << r.wall_ms << ",\"cpu_ms\":" << r.cpu_ms;
+    if ( r.heap_tracked )
+        m_out << ",\"allocs\":" << r.allocs << ",\"frees\":" << r.frees << ",\"peak_bytes\":" << r.peak_bytes
+              << ",\"leaked_bytes\":" << r.leaked_bytes;
+    m_out << "}\n" << std::flush;
+}
+
+void JsonReporter::on_suite_end( const std::string & suite, size_t n_passed, size_t n_failed, size_t n_disabled, double wall_ms )
+{
+    m_out << "{\"event\":\"suite_end\",\"suite\":" << json_quote( suite ) << ",\"passed\":" << n_passed
+          << ",\"failed\":" << n_failed << ",\"disabled\":" << n_disabled << ",\"wall_ms\":" << wall_ms << "}\n" << std::flush;
+}
@@ -0,0 +1,95 @@
+#ifndef _TM_REPORTER_
+#define _TM_REPORTER_
+
+/*!
+ * @file reporter.h
+ * @brief Reporters that receive each test result as soon as the test finishes.
+ * @date October 18th, 2026
+ *
+ * A `TestManager` calls its reporters while tests run, not only in `summary()`, so a report
+ * file holds every result produced up to the moment the process stops, even if it crashes.
+ */
+
+#include <fstream>
+#include <mutex>
+#include <ostream>
+#include <string>
+
+/// What a reporter is told about a finished test.
+struct TestReport {
+    /// Outcome of a test.
+    enum class status_t : int { PASSED, FAILED, DISABLED, UNDEFINED, CRASHED, TIMEOUT };
+    std::string suite;  //!< The test suite name.
+    std::string name;   //!< The test name.
+    std::string desc;   //!< The test description.
+    size_t seq;         //!< Registration order of the test within its suite.
+    status_t status;    //!< The test result.
+    int line;           //!< Line of the last assertion, or of the first failed one.
+    std::string message;//!< Why the test failed, if it did.
+    bool enabled;       //!< Whether the test was enabled.
+    double wall_ms;     //!< Wall clock time, in milliseconds.
+    double cpu_ms;      //!< CPU time on the test thread, in milliseconds.
+    bool heap_tracked;  //!< Whether the heap fields below were counted.
+    size_t allocs;      //!< Blocks the test allocated.
+    size_t frees;       //!< Blocks the test freed.
+    size_t peak_bytes;  //!< Most bytes the test held at once.
+    size_t leaked_bytes;//!< Bytes the test allocated and did not free.
+};
+
+/// Receives test results as they complete. Calls are serialized by the reporter itself.
+class Reporter {
+    public:
+        virtual ~Reporter() = default;
+
+        /// Called once per suite, before its first result.
+        void suite_begin( const std::string & suite, size_t n_tests );
+        /// Called for every test, as soon as it finishes.
+        void test_end( const TestReport & report );
+        /// Called once per suite, by `TestManager::summary()`.
+        void suite_end( const std::string & suite, size_t n_passed, size_t n_failed, size_t n_disabled, double wall_ms );
+
+    protected:
+        virtual void on_suite_begin( const std::string & /* suite */, size_t /* n_tests */ ) {}
+        virtual void on_test_end( const TestReport & report ) = 0;
+        virtual void on_suite_end( const std::string & /* suite */, size_t /* n_passed */, size_t /* n_failed */,
+                                   size_t /* n_disabled */, double /* wall_ms */ ) {}
+
+    private:
+        std::mutex m_mutex;
+};
+
+/// Writes a JUnit XML report, flushing every test case as soon as it is written.
+class JUnitReporter : public Reporter {
+    public:
+        explicit JUnitReporter( const std::string & filename );
+        ~JUnitReporter() override;
+
+    protected:
+        void on_suite_begin( const std::string & suite, size_t n_tests ) override;
+        void on_test_end( const TestReport & report ) override;
+        void on_suite_end( const std::string & suite, size_t n_passed, size_t n_failed,
+                           size_t n_disabled, double wall_ms ) override;
+
+    private:
+        std::ofstream m_out;
+        bool m_in_suite{ false };
+};
+
+/// Writes one JSON object per line (JSON Lines), so a partial report is still readable.
+class JsonReporter : public Reporter {
+    public:
+        explicit JsonReporter( const std::string & filename );
+
+    protected:
+        void on_suite_begin( const std::string & suite, size_t n_tests ) override;
+        void on_test_end( const TestReport & report ) override;
+        void on_suite_end( const std::string & suite, size_t n_passed, size_t n_failed,
+                           size_t n_disabled, double wall_ms ) override;
+
+    private:
+        std::ofstream m_out;
+};
+
+/// Name of a test status, as written in the reports.
+const char * to_string( TestReport::status_t status );
+#endif
@@ -7,56 +7,1042 @@
 
 #include "test_manager.h"
 
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>     // fflush
+#include <ctime>
+#include <exception>
+#include <limits>
+#include <random>     // mt19937
+#include <sstream>
+#include <thread>
+#include <time.h>   // clock_gettime
+
+#if defined(__unix__) || defined(__APPLE__)
+#   define TM_HAS_FORK
+#   include <cstring>     // strsignal
+#   include <poll.h>
+#   include <signal.h>
+#   include <sys/wait.h>
+#   include <unistd.h>
+#   include <cerrno>
+#   include <cstdint>
+#   include <stdexcept>
+#endif
+
+namespace {
+    /// Wall clock time, in milliseconds from an arbitrary origin.
+    double wall_ms( void )
+    {
+        using namespace std::chrono;
+        return duration< double, std::milli >( steady_clock::now().time_since_epoch() ).count();
+    }
+
+    /// CPU time consumed by the calling thread, in milliseconds. Falls back to process time.
+    double thread_cpu_ms( void )
+    {
+#if defined(CLOCK_THREAD_CPUTIME_ID)
+        timespec ts;
+        if ( clock_gettime( CLOCK_THREAD_CPUTIME_ID, &ts ) == 0 )
+            return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+#endif
+        return 1e3 * static_cast< double >( std::clock() ) / CLOCKS_PER_SEC;
+    }
+
+    /// Allocation counting is on once alloc_tracker.cpp registers itself.
+    std::atomic< bool > g_tracking_allocs{ false };
+    /// Heap activity of each thread; plain data, so it is usable from `operator new` at any time.
+    thread_local alloc_counts t_allocs;
+
+    /// While a serial test runs alone, every thread counts into this record instead, so a block
+    /// freed on another thread than the one that allocated it still cancels out. A spin lock,
+    /// rather than a mutex, since it is taken inside `operator new`.
+    alloc_counts g_shared_allocs;
+    std::atomic< bool > g_sharing{ false };
+    std::atomic_flag g_shared_lock = ATOMIC_FLAG_INIT;
+    /// Whether this thread runs the body of the serial test the counts are shared for.
+    thread_local bool t_runs_test{ false };
+    /// How many suites are running tests on a pool of threads, where the counts cannot be shared.
+    std::atomic< int > g_pools_running{ 0 };
+
+    struct shared_lock {
+        shared_lock() { while ( g_shared_lock.test_and_set( std::memory_order_acquire ) ) {} }
+        ~shared_lock() { g_shared_lock.clear( std::memory_order_release ); }
+    };
+
+    /// Adds the heap activity of a test to the counts it ran within.
+    void add_counts( alloc_counts & outer, const alloc_counts & body )
+    {
+        outer.allocs += body.allocs;
+        outer.frees += body.frees;
+        outer.peak_bytes = std::max( outer.peak_bytes, outer.live_bytes + body.peak_bytes );
+        outer.live_bytes += body.live_bytes;
+        outer.other_threads = outer.other_threads or body.other_threads;
+    }
+
+    /// Stops counting allocations on this thread for as long as it lives, so the bookkeeping
+    /// of the test manager does not show up in the counts of the test.
+    struct alloc_pause {
+        alloc_pause() { ++t_allocs.paused; }
+        ~alloc_pause() { --t_allocs.paused; }
+    };
+
+#ifdef TM_HAS_FORK
+    //=== Records sent from an isolated child to its parent: raw values, in this machine's layout.
+    template < typename V >
+    void put( std::string & buf, const V & v )
+    {
+        buf.append( reinterpret_cast< const char * >( &v ), sizeof( v ) );
+    }
+    void put_string( std::string & buf, const std::string & s )
+    {
+        put( buf, static_cast< std::uint32_t >( s.size() ) );
+        buf += s;
+    }
+    template < typename V >
+    bool get( const std::string & buf, size_t & pos, V & v )
+    {
+        if ( buf.size() - pos < sizeof( v ) ) return false;
+        std::memcpy( &v, buf.data() + pos, sizeof( v ) );
+        pos += sizeof( v );
+        return true;
+    }
+    bool get_string( const std::string & buf, size_t & pos, std::string & s )
+    {
+        std::uint32_t n;
+        if ( not get( buf, pos, n ) or buf.size() - pos < n ) return false;
+        s.assign( buf.data() + pos, n );
+        pos += n;
+        return true;
+    }
+    void write_all( int fd, const char * p, size_t left )
+    {
+        while ( left > 0 )
+        {
+            ssize_t n = write( fd, p, left );
+            if ( n < 0 and errno == EINTR ) continue;
+            if ( n <= 0 ) return;
+            p += n;
+            left -= static_cast< size_t >( n );
+        }
+    }
+    void write_all( int fd, const std::string & msg )
+    {
+        write_all( fd, msg.data(), msg.size() );
+    }
+#endif
+
+    /// Nanoseconds elapsed while running `op` `reps` times.
+    double elapsed_ns( const std::function< void() > &op, size_t reps )
+    {
+        using namespace std::chrono;
+        auto t0 = steady_clock::now();
+        for ( size_t i{0}; i < reps; ++i )
+            op();
+        return duration< double, std::nano >( steady_clock::now() - t0 ).count();
+    }
+}
+
+/*!
+ * Registers a test, or resets its entry if a test with the same name was registered before.
+ * Tests must be registered before `run()` is called, never while it runs.
+ * @param key_name The unique test key, which is the test's name.
+ * @param msg The test description.
+ * @return The handle assertions use to reach the test.
+ */
+TestManager::test_id TestManager::record( const std::string &key_name, const std::string& msg )
+{
+    auto it = tests_index.find( key_name );
+    if ( it != tests_index.end() )
+    {
+        *tests_record[ it->second ] = Entry{ key_name, msg, tests_record[ it->second ]->m_seq };
+        return test_id{ it->second };
+    }
+    tests_index.emplace( key_name, tests_record.size() );
+    tests_record.emplace_back( new Entry{ key_name, msg, n_tests++ } );
+    return test_id{ tests_record.size() - 1 };
+}
+
+/*!
+ * Registers a test whose body runs later, when `run()` is called.
+ * @param key_name The unique test key, which is the test's name.
+ * @param msg The test description.
+ * @param serial Whether the test must run alone, after the others: no other test runs beside it.
+ * @return The slot that must receive the test body.
+ */
+TestManager::test_body & TestManager::add( const std::string &key_name, const std::string& msg, bool serial )
+{
+    tests_body.emplace_back( record( key_name, msg ).m_index, test_body{} );
+    tests_record[ tests_body.back().first ]->m_serial = serial;
+    return tests_body.back().second;
+}
+
 /*!
- * Updates the test result database.
+ * Updates the result of a test given by name. Prefer the handle overload, which does not
+ * look the name up.
  * @param key The unique test key, which is the test's name.
  * @param value The result of the test, that might either be `true` or `false`.
  * @param line The line number in the source code, where the teste happened.
  */
 void TestManager::result( const std::string &key, bool value, int line )
 {
-    // Get previous result.
-    auto old_entry = tests_record[ key ];
+    auto it = tests_index.find( key );
+    if ( it == tests_index.end() ) return;
+    result( test_id{ it->second }, value, line );
+}
+
+/*!
+ * Updates the test result database. Takes O(1) time and allocates nothing.
+ * Only the thread running the test touches its entry, so no lock is taken.
+ * @param id The handle of the test.
+ * @param value The result of the test, that might either be `true` or `false`.
+ * @param line The line number in the source code, where the teste happened.
+ */
+void TestManager::result( test_id id, bool value, int line )
+{
+    Entry & entry = *tests_record[ id.m_index ];
     // We only update if the previous result is TRUE or UNDEFINED.
     // Otherwise, we keep the first failure.
-    if ( old_entry.m_result == Entry::result_t::SUCCESS or
-         old_entry.m_result == Entry::result_t::UNDEFINED )
+    if ( entry.m_result == Entry::result_t::SUCCESS or
+         entry.m_result == Entry::result_t::UNDEFINED )
+    {
+        entry.m_result = value ? Entry::result_t::SUCCESS : Entry::result_t::FAILED ; // Update the result.
+        entry.m_line = line;     // Update the line.
+    }
+#ifdef TM_HAS_FORK
+    // In an isolated child, tell the parent right away, so the progress survives a crash.
+    if ( m_child_fd >= 0 )
+    {
+        char msg[ 1 + 2 * sizeof( std::int32_t ) ];
+        std::int32_t fields[2] = { static_cast< std::int32_t >( entry.m_result ), static_cast< std::int32_t >( entry.m_line ) };
+        msg[0] = 'R';
+        std::memcpy( msg + 1, fields, sizeof( fields ) );
+        write_all( m_child_fd, msg, sizeof( msg ) );
+    }
+#endif
+}
+
+/*!
+ * Runs the i-th registered body, timing it and recording any exception it throws. The heap
+ * counts of the thread are reset for the body and restored afterwards, with the body's activity
+ * added, so a test that runs other tests on its own thread still sees their allocations.
+ * A serial test that runs while no other test does counts the heap activity of every thread,
+ * so the threads it starts are covered too.
+ */
+void TestManager::run_body( size_t i )
+{
+    Entry & entry = *tests_record[ tests_body[i].first ];
+    alloc_counts outer = t_allocs;
+    t_allocs = alloc_counts();
+    t_allocs.paused = outer.paused;
+    // A test run by a serial test, on its thread, shares the counts too, and hands them back.
+    bool was_sharing = g_sharing.load() and t_runs_test;
+    bool sharing = was_sharing or ( entry.m_serial and tracks_allocs() and g_pools_running.load() == 0
+                                    and not g_sharing.load() );
+    alloc_counts outer_shared = alloc_counts();
+    if ( sharing )
+    {
+        {
+            shared_lock lock;
+            outer_shared = g_shared_allocs;
+            g_shared_allocs = alloc_counts();
+        }
+        t_runs_test = true;
+        g_sharing.store( true );
+    }
+    double wall0 = wall_ms(), cpu0 = thread_cpu_ms();
+    try {
+        tests_body[i].second( *this, test_id{ tests_body[i].first } );
+    }
+    catch ( const std::exception & e ) {
+        alloc_pause pause;
+        entry.m_result = Entry::result_t::FAILED;
+        entry.m_error = e.what();
+    }
+    catch ( ... ) {
+        alloc_pause pause;
+        entry.m_result = Entry::result_t::FAILED;
+        entry.m_error = "unknown exception";
+    }
+    entry.m_wall_ms = wall_ms() - wall0;
+    entry.m_cpu_ms = thread_cpu_ms() - cpu0;
+    entry.m_heap = t_allocs;
+    t_allocs = outer;
+    if ( sharing )
+    {
+        {
+            shared_lock lock;
+            entry.m_heap = g_shared_allocs;
+            entry.m_heap.paused = outer.paused;
+            if ( was_sharing )
+            {
+                g_shared_allocs = outer_shared;
+                add_counts( g_shared_allocs, entry.m_heap );
+                return;
+            }
+        }
+        g_sharing.store( false );
+        t_runs_test = false;
+    }
+    add_counts( t_allocs, entry.m_heap );
+}
+
+/*!
+ * Tells whether `text` matches `pattern`. A '*' matches any run of characters, even an
+ * empty one, and a '?' any single character. Backtracks to the last '*' on a mismatch.
+ */
+bool TestManager::glob_match( const std::string &pattern, const std::string &text )
+{
+    size_t p{0}, t{0}, star{ std::string::npos }, resume{0};
+    while ( t < text.size() )
+    {
+        if ( p < pattern.size() and ( pattern[p] == '?' or pattern[p] == text[t] ) )
+        {
+            ++p;
+            ++t;
+        }
+        else if ( p < pattern.size() and pattern[p] == '*' )
+        {
+            star = p++;
+            resume = t;
+        }
+        else if ( star != std::string::npos )
+        {
+            p = star + 1;
+            t = ++resume;
+        }
+        else return false;
+    }
+    while ( p < pattern.size() and pattern[p] == '*' )
+        ++p;
+    return p == pattern.size();
+}
+
+/*!
+ * Applies the filter and the shard of the options to the bodies registered with `add()`.
+ * Shards take the tests that pass the filter round-robin, in registration order, so every
+ * process of a sharded run selects the same tests given the same filter.
+ * @return Positions in `tests_body` of the selected tests.
+ */
+std::vector< size_t > TestManager::select( void )
+{
+    // A '-' starts the negative globs only at the front of the filter or right after a ':',
+    // so names such as "operator--()" can still be matched.
+    std::vector< std::string > positive, negative;
+    std::istringstream iss{ m_options.filter };
+    bool in_negative{ false };
+    for ( std::string g; std::getline( iss, g, ':' ); )
+    {
+        if ( not in_negative and not g.empty() and g[0] == '-' )
+        {
+            in_negative = true;
+            g.erase( 0, 1 );
+        }
+        if ( not g.empty() ) ( in_negative ? negative : positive ).push_back( g );
+    }
+    if ( positive.empty() )
+        positive.push_back( "*" );
+    auto matches = [this]( const std::vector< std::string > &globs, const std::string &name )
+    {
+        for ( const auto & g : globs )
+            if ( glob_match( g, name ) or glob_match( g, test_suite_name + "." + name ) )
+                return true;
+        return false;
+    };
+
+    std::vector< size_t > selected;
+    size_t n_passed{0};
+    for ( size_t i{0}; i < tests_body.size(); ++i )
+    {
+        Entry & entry = *tests_record[ tests_body[i].first ];
+        entry.m_selected = matches( positive, entry.m_name ) and not matches( negative, entry.m_name )
+                           and n_passed++ % m_options.shard_count == m_options.shard_index;
+        if ( entry.m_selected )
+            selected.push_back( i );
+    }
+    return selected;
+}
+
+/*!
+ * Runs the selected tests `repeat` times, shuffled if asked. Before every repetition each
+ * entry is reset; after it, a failure from an earlier repetition is kept over a later pass,
+ * so the first failure is the one reported. The summary then shows how many runs failed and
+ * the spread of their times. With `list_only`, prints the selected tests and runs nothing.
+ * Serial tests run after the others, one at a time.
+ * @param pass Runs the bodies whose positions it is given; alone when its second argument is `true`.
+ */
+void TestManager::run_repeated( const std::function< void( const std::vector< size_t > &, bool ) > &pass )
+{
+    std::vector< size_t > order = select();
+    if ( m_options.list_only )
+    {
+        if ( not order.empty() )
+            std::cout << test_suite_name << ".\n";
+        for ( auto i : order )
+            std::cout << "  " << tests_record[ tests_body[i].first ]->m_name << "\n";
+        tests_body.clear();
+        return;
+    }
+
+    std::mt19937 rng{ m_options.seed };
+    for ( size_t r{0}; r < std::max< size_t >( m_options.repeat, 1 ); ++r )
     {
-        tests_record[key].m_result = value ? Entry::result_t::SUCCESS : Entry::result_t::FAILED ; // Update the result.
-        tests_record[key].m_line = line;     // Update the line.
+        if ( m_options.shuffle )
+            std::shuffle( order.begin(), order.end(), rng );
+        auto first_serial = std::stable_partition( order.begin(), order.end(),
+                [this]( size_t i ) { return not tests_record[ tests_body[i].first ]->m_serial; } );
+        std::vector< Entry > before;
+        for ( auto i : order )
+        {
+            Entry & entry = *tests_record[ tests_body[i].first ];
+            before.push_back( entry );
+            entry.m_result = Entry::result_t::UNDEFINED;
+            entry.m_line = 0;
+            entry.m_error.clear();
+            entry.m_note.clear();
+        }
+        std::vector< size_t > parallel( order.begin(), first_serial ), serial( first_serial, order.end() );
+        if ( not parallel.empty() )
+            pass( parallel, false );
+        if ( not serial.empty() )
+            pass( serial, true );
+        for ( size_t k{0}; k < order.size(); ++k )
+        {
+            Entry & entry = *tests_record[ tests_body[ order[k] ].first ];
+            ++entry.m_runs;
+            entry.m_wall_samples.push_back( entry.m_wall_ms );
+            if ( entry.failed() )
+                ++entry.m_failures;
+            if ( before[k].failed() )
+            {
+                entry.m_result = before[k].m_result;
+                entry.m_line = before[k].m_line;
+                entry.m_error = before[k].m_error;
+                entry.m_note = before[k].m_note;
+            }
+        }
     }
+    tests_body.clear();
+}
+
+/*!
+ * Runs the selected test bodies registered with `add()` and not run yet, as set by `set_options()`.
+ * A test that throws is recorded as failed.
+ * @param n_workers How many threads run tests; 0 means one per hardware thread.
+ */
+void TestManager::run( size_t n_workers )
+{
+    run_repeated( [this, n_workers]( const std::vector< size_t > &order, bool alone )
+                  { run_threads( order, alone ? 1 : n_workers ); } );
+}
+
+/*!
+ * Runs the given bodies. Workers take the next pending test from a shared counter,
+ * so a slow test does not hold up the others.
+ */
+void TestManager::run_threads( const std::vector< size_t > &order, size_t n_workers )
+{
+    if ( n_workers == 0 )
+        n_workers = std::max( 1u, std::thread::hardware_concurrency() );
+    n_workers = std::min( n_workers, order.size() );
+
+    std::atomic< size_t > next{ 0 };
+    auto worker = [this, &next, &order]()
+    {
+        for ( size_t i = next++; i < order.size(); i = next++ )
+        {
+            run_body( order[i] );
+            report( *tests_record[ tests_body[ order[i] ].first ] );
+        }
+    };
+
+    if ( n_workers <= 1 )
+        worker();
+    else
+    {
+        ++g_pools_running;
+        std::vector< std::thread > pool;
+        for ( size_t w{0}; w < n_workers; ++w )
+            pool.emplace_back( worker );
+        for ( auto & t : pool )
+            t.join();
+        --g_pools_running;
+    }
+}
+
+/*!
+ * Runs the selected test bodies registered with `add()` and not run yet, as set by `set_options()`,
+ * each in a forked child process, so a test that crashes or hangs cannot take the others down.
+ * On platforms without fork() the tests run in this process, with no timeout.
+ * @param max_children How many children may run at once; 0 means one per hardware thread.
+ * @param timeout_ms How long a single test may run, in milliseconds.
+ */
+void TestManager::run_isolated( size_t max_children, double timeout_ms )
+{
+    run_repeated( [=]( const std::vector< size_t > &order, bool alone )
+                  { run_forked( order, alone ? 1 : max_children, timeout_ms ); } );
+}
+
+#ifdef TM_HAS_FORK
+/*!
+ * Runs the given bodies, each in a forked child process. The child streams its results
+ * back over a pipe: a record per assertion, and a final one with the whole entry. A child that
+ * dies before the final record is reported as CRASHED; one that outlives `timeout_ms` is killed
+ * and reported as TIMEOUT. Must not be called while other threads of this process are running.
+ */
+void TestManager::run_forked( const std::vector< size_t > &order, size_t max_children, double timeout_ms )
+{
+    if ( max_children == 0 )
+        max_children = std::max( 1u, std::thread::hardware_concurrency() );
+
+    struct child {
+        pid_t pid;
+        int fd;
+        size_t body;        // Index in tests_body.
+        double started;     // Wall clock, in milliseconds.
+        std::string data;   // Records received so far.
+    };
+    std::vector< child > running;
+    size_t next{0};
+    while ( next < order.size() or not running.empty() )
+    {
+        // Start children up to the limit.
+        while ( next < order.size() and running.size() < max_children )
+        {
+            int fds[2];
+            if ( pipe( fds ) != 0 )
+                throw std::runtime_error( "TestManager: pipe() failed" );
+            // Otherwise the child would inherit, and print again, whatever is still buffered.
+            std::cout.flush();
+            std::cerr.flush();
+            std::fflush( nullptr );
+            pid_t pid = fork();
+            if ( pid < 0 )
+            {
+                close( fds[0] );
+                close( fds[1] );
+                throw std::runtime_error( "TestManager: fork() failed" );
+            }
+            if ( pid == 0 )
+            {
+                close( fds[0] );
+                run_child( order[next], fds[1] );
+            }
+            close( fds[1] );
+            running.push_back( child{ pid, fds[0], order[next], wall_ms(), std::string{} } );
+            ++next;
+        }
+
+        // Wait for a record, an exit or the nearest deadline.
+        std::vector< pollfd > pfds;
+        double now = wall_ms(), wait = timeout_ms;
+        for ( const auto & c : running )
+        {
+            pfds.push_back( pollfd{ c.fd, POLLIN, 0 } );
+            wait = std::min( wait, c.started + timeout_ms - now );
+        }
+        if ( poll( pfds.data(), pfds.size(), static_cast< int >( std::max( 0.0, std::ceil( wait ) ) ) ) < 0 and errno != EINTR )
+            throw std::runtime_error( "TestManager: poll() failed" );
+
+        now = wall_ms();
+        for ( size_t i = running.size(); i-- > 0; )
+        {
+            child & c = running[i];
+            bool done{ false };
+            if ( pfds[i].revents != 0 )
+            {
+                char buf[ 4096 ];
+                ssize_t n = read( c.fd, buf, sizeof( buf ) );
+                if ( n > 0 )
+                    c.data.append( buf, static_cast< size_t >( n ) );
+                else if ( n == 0 or ( errno != EINTR and errno != EAGAIN ) )
+                    done = true;
+            }
+            bool timed_out = not done and now - c.started >= timeout_ms;
+            if ( not done and not timed_out )
+                continue;
+
+            if ( timed_out )
+                kill( c.pid, SIGKILL );
+            close( c.fd );
+            int status{0};
+            while ( waitpid( c.pid, &status, 0 ) < 0 and errno == EINTR ) { /* retry */ }
+
+            Entry & entry = *tests_record[ tests_body[ c.body ].first ];
+            entry.m_wall_ms = now - c.started;
+            bool finished{ false };
+            size_t pos{0};
+            char tag;
+            while ( get( c.data, pos, tag ) )
+            {
+                std::int32_t result, line;
+                if ( tag == 'R' and get( c.data, pos, result ) and get( c.data, pos, line ) )
+                {
+                    entry.m_result = static_cast< Entry::result_t >( result );
+                    entry.m_line = line;
+                }
+                else if ( tag == 'E' and get( c.data, pos, result ) and get( c.data, pos, line )
+                          and get( c.data, pos, entry.m_enabled ) and get( c.data, pos, entry.m_wall_ms )
+                          and get( c.data, pos, entry.m_cpu_ms ) and get( c.data, pos, entry.m_heap )
+                          and get_string( c.data, pos, entry.m_error )
+                          and get_string( c.data, pos, entry.m_note ) )
+                {
+                    entry.m_result = static_cast< Entry::result_t >( result );
+                    entry.m_line = line;
+                    finished = true;
+                }
+                else break;
+            }
+            if ( timed_out )
+            {
+                entry.m_result = Entry::result_t::TIMEOUT;
+                entry.m_note = "exceeded the " + std::to_string( static_cast< long >( timeout_ms ) ) + " ms timeout";
+            }
+            else if ( not finished and WIFSIGNALED( status ) )
+            {
+                entry.m_result = Entry::result_t::CRASHED;
+                entry.m_note = "killed by signal " + std::to_string( WTERMSIG( status ) )
+                               + " (" + strsignal( WTERMSIG( status ) ) + ")";
+            }
+            else if ( not finished )
+            {
+                entry.m_result = Entry::result_t::CRASHED;
+                entry.m_note = "exited with status " + std::to_string( WEXITSTATUS( status ) ) + " before finishing";
+            }
+            report( entry );
+            running.erase( running.begin() + static_cast< std::ptrdiff_t >( i ) );
+        }
+    }
+}
+
+void TestManager::run_child( size_t i, int fd )
+{
+    m_child_fd = fd;
+    run_body( i );
+    const Entry & entry = *tests_record[ tests_body[i].first ];
+    std::string msg;
+    put( msg, 'E' );
+    put( msg, static_cast< std::int32_t >( entry.m_result ) );
+    put( msg, static_cast< std::int32_t >( entry.m_line ) );
+    put( msg, entry.m_enabled );
+    put( msg, entry.m_wall_ms );
+    put( msg, entry.m_cpu_ms );
+    put( msg, entry.m_heap );
+    put_string( msg, entry.m_error );
+    put_string( msg, entry.m_note );
+    write_all( fd, msg );
+    std::cout.flush();
+    std::cerr.flush();
+    // Skip the destructors and atexit handlers the child inherited from the parent.
+    _exit( 0 );
+}
+#else
+/// No fork() on this platform: the tests run in this process, with no timeout.
+void TestManager::run_forked( const std::vector< size_t > &order, size_t max_children, double /* timeout_ms */ )
+{
+    run_threads( order, max_children );
+}
+
+void TestManager::run_child( size_t, int )
+{
+    std::terminate();
+}
+#endif
+
+TestManager::timer::timer( TestManager & tm, test_id id )
+    : m_tm{ tm }, m_id{ id }, m_wall0{ wall_ms() }, m_cpu0{ thread_cpu_ms() }
+{ /* empty */ }
+
+TestManager::timer::~timer()
+{
+    m_tm.record_time( m_id, wall_ms() - m_wall0, thread_cpu_ms() - m_cpu0 );
+    m_tm.report( *m_tm.tests_record[ m_id.m_index ] );
+}
+
+void TestManager::add_reporter( std::shared_ptr< Reporter > reporter )
+{
+    m_reporters.push_back( reporter );
+}
+
+/*!
+ * Sends a finished test to the reporters. The first call also tells them the suite began.
+ * May be called from several worker threads at once; each reporter serializes its calls.
+ * @param entry The test that finished.
+ */
+void TestManager::report( const Entry &entry )
+{
+    if ( m_reporters.empty() ) return;
+    std::call_once( m_begun, [this]()
+    {
+        size_t n_selected{0};
+        for ( const auto & t : tests_record )
+            n_selected += t->m_selected;
+        for ( auto & r : m_reporters )
+            r->suite_begin( test_suite_name, n_selected );
+    } );
+
+    TestReport rep;
+    rep.suite = test_suite_name;
+    rep.name = entry.m_name;
+    rep.desc = entry.m_desc;
+    rep.seq = entry.m_seq;
+    rep.enabled = entry.m_enabled;
+    rep.line = entry.m_line;
+    rep.wall_ms = entry.m_wall_ms;
+    rep.cpu_ms = entry.m_cpu_ms;
+    rep.heap_tracked = tracks_allocs();
+    rep.allocs = entry.m_heap.allocs;
+    rep.frees = entry.m_heap.frees;
+    rep.peak_bytes = static_cast< size_t >( std::max( entry.m_heap.peak_bytes, 0LL ) );
+    rep.leaked_bytes = static_cast< size_t >( std::max( leaked_bytes( entry.m_heap ), 0LL ) );
+    if ( not entry.m_enabled )
+        rep.status = TestReport::status_t::DISABLED;
+    else if ( entry.m_result == Entry::result_t::SUCCESS )
+        rep.status = TestReport::status_t::PASSED;
+    else if ( entry.m_result == Entry::result_t::FAILED )
+        rep.status = TestReport::status_t::FAILED;
+    else if ( entry.m_result == Entry::result_t::CRASHED )
+        rep.status = TestReport::status_t::CRASHED;
+    else if ( entry.m_result == Entry::result_t::TIMEOUT )
+        rep.status = TestReport::status_t::TIMEOUT;
+    else
+        rep.status = TestReport::status_t::UNDEFINED;
+    if ( rep.status == TestReport::status_t::CRASHED or rep.status == TestReport::status_t::TIMEOUT )
+        rep.message = entry.m_note;
+    else if ( rep.status == TestReport::status_t::FAILED )
+    {
+        if ( not entry.m_error.empty() )
+            rep.message = "threw: " + entry.m_error;
+        else if ( not entry.m_note.empty() )
+            rep.message = entry.m_note;
+        else
+            rep.message = "assertion failed at line " + std::to_string( entry.m_line );
+    }
+    for ( auto & r : m_reporters )
+        r->test_end( rep );
+}
+
+void TestManager::record_time( test_id id, double wall_ms, double cpu_ms )
+{
+    tests_record[ id.m_index ]->m_wall_ms = wall_ms;
+    tests_record[ id.m_index ]->m_cpu_ms = cpu_ms;
+}
+
+/*!
+ * Runs `op` in batches large enough to be timed reliably, and returns the median time of a
+ * single run over a few batches. `op` runs many times, so it must be repeatable.
+ * @param op The operation to time.
+ * @return The typical time of a single run, in nanoseconds.
+ */
+double TestManager::time_ns( const std::function< void() > &op )
+{
+    const double min_batch_ns = 1e5; // Long enough to dwarf the clock resolution.
+    op(); // Warm up caches and branch predictors.
+    size_t batch{1};
+    while ( batch < ( size_t{1} << 20 ) and elapsed_ns( op, batch ) < min_batch_ns )
+        batch *= 2;
+    std::vector< double > samples;
+    for ( int i{0}; i < 5; ++i )
+        samples.push_back( elapsed_ns( op, batch ) / batch );
+    std::sort( samples.begin(), samples.end() );
+    return samples[ samples.size() / 2 ];
+}
+
+/*!
+ * Times `op(n)` for every size, then picks the growth rate `f` in `complexity_t` for which
+ * `t(n) / f(n)` is the most constant across sizes, i.e. the variance of `log( t(n) / f(n) )`
+ * is the smallest. Each size is run a few times and its fastest run is kept, which filters
+ * out preemptions. Use at least four sizes, spread over a couple of orders of magnitude.
+ * @param op The operation to time, called as `op(n)`.
+ * @param sizes The input sizes.
+ * @return The growth rate that fits the measurements best.
+ */
+TestManager::complexity_t TestManager::fit_complexity( const std::function< void( size_t ) > &op,
+                                                       const std::vector< size_t > &sizes )
+{
+    std::vector< double > times;
+    for ( auto n : sizes )
+    {
+        double best = std::numeric_limits< double >::max();
+        double total{0};
+        for ( int r{0}; r < 1000 and ( r < 3 or total < 2e6 ); ++r )
+        {
+            double ns = elapsed_ns( [&]{ op( n ); }, 1 );
+            best = std::min( best, ns );
+            total += ns;
+        }
+        times.push_back( std::max( best, 1.0 ) );
+    }
+    auto growth = []( complexity_t c, double n )->double
+    {
+        n = std::max( n, 2.0 );
+        switch ( c )
+        {
+            case complexity_t::O_1:         return 1.0;
+            case complexity_t::O_LOG_N:     return std::log2( n );
+            case complexity_t::O_N:         return n;
+            case complexity_t::O_N_LOG_N:   return n * std::log2( n );
+            case complexity_t::O_N_SQUARED: return n * n;
+            case complexity_t::O_N_CUBED:   return n * n * n;
+        }
+        return 1.0;
+    };
+    complexity_t best_fit{ complexity_t::O_1 };
+    double best_error = std::numeric_limits< double >::max();
+    for ( int c{0}; c <= static_cast< int >( complexity_t::O_N_CUBED ); ++c )
+    {
+        auto cx = static_cast< complexity_t >( c );
+        std::vector< double > ratio;
+        double mean{0};
+        for ( size_t i{0}; i < sizes.size(); ++i )
+        {
+            ratio.push_back( std::log( times[i] / growth( cx, static_cast< double >( sizes[i] ) ) ) );
+            mean += ratio.back();
+        }
+        mean /= std::max< size_t >( ratio.size(), 1 );
+        double error{0};
+        for ( auto r : ratio )
+            error += ( r - mean ) * ( r - mean );
+        if ( error < best_error )
+        {
+            best_error = error;
+            best_fit = cx;
+        }
+    }
+    return best_fit;
+}
+
+const char * TestManager::to_string( complexity_t c )
+{
+    static const char * const names[] = { "O(1)", "O(log n)", "O(n)", "O(n log n)", "O(n^2)", "O(n^3)" };
+    return names[ static_cast< int >( c ) ];
+}
+
+void TestManager::expect_faster_than( test_id id, const std::function< void() > &op, double max_ns, int line )
+{
+    alloc_pause pause; // Timing runs `op` many times; its allocations would swamp those of the test.
+    double ns = time_ns( op );
+    Entry & entry = *tests_record[ id.m_index ];
+    bool first_failure = entry.m_result != Entry::result_t::FAILED;
+    result( id, ns <= max_ns, line );
+    if ( ns > max_ns and first_failure )
+    {
+        std::ostringstream oss;
+        oss << "took " << ns << " ns, budget is " << max_ns << " ns";
+        entry.m_note = oss.str();
+    }
+}
+
+void TestManager::expect_complexity( test_id id, const std::function< void( size_t ) > &op,
+                                     const std::vector< size_t > &sizes, complexity_t expected, int line )
+{
+    alloc_pause pause;
+    complexity_t fitted = fit_complexity( op, sizes );
+    Entry & entry = *tests_record[ id.m_index ];
+    bool first_failure = entry.m_result != Entry::result_t::FAILED;
+    result( id, fitted <= expected, line );
+    if ( fitted > expected and first_failure )
+        entry.m_note = std::string{ "grows like " } + to_string( fitted )
+                                                        + ", expected " + to_string( expected );
+}
+
+namespace {
+    void note_alloc( alloc_counts & heap, size_t bytes )
+    {
+        ++heap.allocs;
+        heap.live_bytes += static_cast< long long >( bytes );
+        if ( heap.live_bytes > heap.peak_bytes )
+            heap.peak_bytes = heap.live_bytes;
+    }
+    void note_free( alloc_counts & heap, size_t bytes )
+    {
+        ++heap.frees;
+        heap.live_bytes -= static_cast< long long >( bytes );
+    }
+}
+
+void TestManager::count_alloc( size_t bytes )
+{
+    if ( t_allocs.paused != 0 )
+        return;
+    if ( not g_sharing.load( std::memory_order_acquire ) )
+        return note_alloc( t_allocs, bytes );
+    shared_lock lock;
+    if ( not t_runs_test )
+        g_shared_allocs.other_threads = true;
+    note_alloc( g_shared_allocs, bytes );
+}
+
+void TestManager::count_free( size_t bytes )
+{
+    if ( t_allocs.paused != 0 )
+        return;
+    if ( not g_sharing.load( std::memory_order_acquire ) )
+        return note_free( t_allocs, bytes );
+    shared_lock lock;
+    if ( not t_runs_test )
+        g_shared_allocs.other_threads = true;
+    note_free( g_shared_allocs, bytes );
+}
+
+alloc_counts TestManager::heap_counts( void )
+{
+    if ( not g_sharing.load( std::memory_order_acquire ) )
+        return t_allocs;
+    shared_lock lock;
+    return g_shared_allocs;
+}
+
+/*!
+ * Bytes a test left allocated. Threads a test starts may keep memory on purpose, such as node
+ * pools and epoch records that later threads reuse, so no leak is reported for such a test.
+ */
+long long TestManager::leaked_bytes( const alloc_counts &heap )
+{
+    return heap.other_threads ? 0 : heap.live_bytes;
+}
+
+bool TestManager::tracks_allocs( void )
+{
+    return g_tracking_allocs.load( std::memory_order_relaxed );
+}
+
+void TestManager::enable_alloc_tracking( void )
+{
+    g_tracking_allocs.store( true, std::memory_order_relaxed );
+}
+
+/*!
+ * Runs `op` and fails the test if it allocated more than `max_allocs` blocks.
+ * Only the calling thread is watched, so allocations made by other threads are not counted,
+ * unless the test is serial.
+ * Without allocation tracking, `op` still runs but nothing is checked.
+ */
+void TestManager::expect_allocs_le( test_id id, const std::function< void() > &op, size_t max_allocs, int line )
+{
+    size_t before = heap_counts().allocs;
+    op();
+    size_t n = heap_counts().allocs - before;
+    alloc_pause pause;
+    if ( not tracks_allocs() or t_allocs.paused > 1 )
+        return;
+    Entry & entry = *tests_record[ id.m_index ];
+    bool first_failure = entry.m_result != Entry::result_t::FAILED;
+    result( id, n <= max_allocs, line );
+    if ( n > max_allocs and first_failure )
+        entry.m_note = "allocated " + std::to_string( n ) + " blocks, at most "
+                                                        + std::to_string( max_allocs ) + " expected";
+}
+
+/*!
+ * Runs `op` and fails the test if the bytes it allocated and did not free are more than
+ * those it freed and had not allocated. Without allocation tracking, nothing is checked.
+ */
+void TestManager::expect_no_leak( test_id id, const std::function< void() > &op, int line )
+{
+    long long before = heap_counts().live_bytes;
+    op();
+    long long leaked = heap_counts().live_bytes - before;
+    alloc_pause pause;
+    if ( not tracks_allocs() or t_allocs.paused > 1 )
+        return;
+    Entry & entry = *tests_record[ id.m_index ];
+    bool first_failure = entry.m_result != Entry::result_t::FAILED;
+    result( id, leaked <= 0, line );
+    if ( leaked > 0 and first_failure )
+        entry.m_note = "leaked " + std::to_string( leaked ) + " bytes";
+}
+
+void TestManager::print_heap( const Entry &entry )
+{
+    if ( not tracks_allocs() )
+        return;
+    std::cout << " [" << entry.m_heap.allocs << " allocs, " << entry.m_heap.frees << " frees, peak "
+              << entry.m_heap.peak_bytes << " B";
+    if ( leaked_bytes( entry.m_heap ) > 0 )
+        std::cout << ", \e[1;31mleaked " << entry.m_heap.live_bytes << " B\e[0m";
+    std::cout << "]";
+}
+
+void TestManager::print_time( double wall_ms, double cpu_ms )
+{
+    std::cout << " (" << std::fixed << std::setprecision( 2 ) << wall_ms << " ms, "
+              << cpu_ms << " ms cpu)\n" << std::defaultfloat;
+}
+
+/*!
+ * Prints the outcome of a test that ran several times: how many runs failed, and the
+ * median, fastest and slowest wall clock times, so flaky and noisy tests stand out.
+ */
+void TestManager::print_runs( const Entry &entry )
+{
+    std::vector< double > wall = entry.m_wall_samples;
+    std::sort( wall.begin(), wall.end() );
+    if ( entry.m_failures == 0 and entry.m_result == Entry::result_t::SUCCESS )
+        std::cout << "[        " << "\e[1;32mOK\e[0m" << " ]";
+    else if ( entry.m_failures == 0 )
+        std::cout << "[ "  << "\e[1;35mUNDEFINED\e[0m" << " ]";
+    else
+    {
+        std::cout << "[      "  << "\e[1;31mFAIL\e[0m" << " ] " << entry.m_failures << " of " << entry.m_runs
+                  << " runs, first at line " << entry.m_line;
+        if ( not entry.m_error.empty() ) std::cout << ", threw: " << entry.m_error;
+        else if ( not entry.m_note.empty() ) std::cout << ": " << entry.m_note;
+        std::cout << ".";
+    }
+    std::cout << " (" << std::fixed << std::setprecision( 2 ) << "median " << wall[ wall.size() / 2 ]
+              << " ms, " << wall.front() << " to " << wall.back() << " ms over " << entry.m_runs << " runs)\n"
+              << std::defaultfloat;
+}
+
+bool TestManager::all_passed( void ) const
+{
+    for ( const auto & t : tests_record )
+        if ( t->m_enabled and t->failed() )
+            return false;
+    return true;
 }
 
 void TestManager::summary(void) const
 {
-    size_t n_successful{0}, n_failed{0}, n_disabled{0}, n_undefined{0};
+    size_t n_successful{0}, n_failed{0}, n_disabled{0}, n_undefined{0}, n_crashed{0}, n_timeout{0};
 
-    // This list helps us to print all the test results in the same order
-    // the user specified in his/get client code.
-    using hash_item = std::pair< std::string, Entry >;
-    std::vector< hash_item > sorted_list;
-    // Copy the hash table to a vector, so we can sort the item by sequence.
-    std::copy ( tests_record.begin(), tests_record.end(), std::back_inserter( sorted_list ) );
-    // Sort the vector
-    std::sort( sorted_list.begin(), sorted_list.end(),
-            [](const hash_item& h1, const hash_item& h2 )->bool
-            { return h1.second.m_seq < h2.second.m_seq; } );
+    // Tests left out by the filter or the shard are not shown; a suite with none left is not either.
+    size_t n_selected{0};
+    for ( const auto & t : tests_record )
+        n_selected += t->m_selected;
+    if ( m_options.list_only or ( n_selected == 0 and n_tests != 0 ) )
+        return;
 
-    // Print out the tests result from the sorted list.
-    std::cout << "[===========] Running " << n_tests << " from the \""  << test_suite_name << "\" test suite.\n";
-    for ( const auto & t : sorted_list )
+    // The record is kept in the order the user registered the tests in
+    // his/her client code, which is the order we print them in.
+    std::cout << "[===========] Running " << n_selected << " from the \""  << test_suite_name << "\" test suite.\n";
+    double total_wall{0}, total_cpu{0};
+    for ( const auto & t : tests_record )
     {
-        print_test_result( t.first, t.second );
-        if ( not t.second.m_enabled ) n_disabled++;
-        else if ( t.second.m_result == TestManager::Entry::result_t::SUCCESS ) n_successful++;
-        else if ( t.second.m_result == TestManager::Entry::result_t::FAILED ) n_failed++;
-        else if ( t.second.m_result == TestManager::Entry::result_t::UNDEFINED ) n_undefined++;
+        if ( not t->m_selected ) continue;
+        print_test_result( t->m_name, *t );
+        total_wall += t->m_wall_ms;
+        total_cpu += t->m_cpu_ms;
+        if ( not t->m_enabled ) n_disabled++;
+        else if ( t->m_result == TestManager::Entry::result_t::SUCCESS ) n_successful++;
+        else if ( t->m_result == TestManager::Entry::result_t::FAILED ) n_failed++;
+        else if ( t->m_result == TestManager::Entry::result_t::UNDEFINED ) n_undefined++;
+        else if ( t->m_result == TestManager::Entry::result_t::CRASHED ) n_crashed++;
+        else if ( t->m_result == TestManager::Entry::result_t::TIMEOUT ) n_timeout++;
     }
-    std::cout << "[===========] " << n_tests << " tests from the \"" << test_suite_name << "\" test suite ran.\n";
+    std::cout << "[===========] " << n_selected << " tests from the \"" << test_suite_name << "\" test suite ran.";
+    print_time( total_wall, total_cpu );
+
+    for ( auto & r : m_reporters )
+        r->suite_end( test_suite_name, n_successful, n_failed + n_crashed + n_timeout, n_disabled, total_wall );
 
     // Final summary
     if ( n_successful != 0 ) std::cout << "[ "<< "\e[1;32mPASSED\e[0m"    << "    ] " << n_successful << " tests.\n";
     if ( n_failed != 0 )     std::cout << "[ "<< "\e[1;31mFAILED\e[0m"    << "    ] " << n_failed     << " tests.\n";
     if ( n_disabled != 0 )   std::cout << "[ "<< "\e[1;36mDISABLED\e[0m"  << "  ] "   << n_disabled   << " tests.\n";
     if ( n_undefined != 0 )  std::cout << "[ "<< "\e[1;35mUNDEFINED\e[0m" << " ] "    << n_undefined  << " tests.\n";
+    if ( n_crashed != 0 )    std::cout << "[ "<< "\e[1;31mCRASHED\e[0m"   << "   ] "  << n_crashed    << " tests.\n";
+    if ( n_timeout != 0 )    std::cout << "[ "<< "\e[1;31mTIMEOUT\e[0m"   << "   ] "  << n_timeout    << " tests.\n";
 }
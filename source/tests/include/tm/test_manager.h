@@ -8,6 +8,13 @@
  * @author Selan R. dos Santos
  * 
  * Updated on January 27th, 2021: improved macro definition and unified divergent versions.
+ * Updated on October 18th, 2026: tests may be registered as callables and run on a pool of threads.
+ * Updated on October 18th, 2026: tests are timed, and may assert time budgets and growth rates.
+ * Updated on October 18th, 2026: results are streamed to reporters as tests finish.
+ * Updated on October 18th, 2026: tests may run isolated in child processes, with a timeout.
+ * Updated on October 18th, 2026: tests may be filtered, sharded, repeated and shuffled.
+ * Updated on October 18th, 2026: heap allocations may be counted per test, and asserted on.
+ * Updated on October 18th, 2026: assertions reach their test through a handle, not its name.
  */
 
 #include <iostream>   // cout, endl
@@ -15,7 +22,7 @@ using std::cout;
 using std::endl;
 #include <iomanip>    // setw
 using std::setw;
-#include <algorithm>  // shuffle, copy
+#include <algorithm>  // shuffle, copy, stable_partition
 using std::shuffle;
 using std::copy;
 #include <string>
@@ -25,7 +32,23 @@ using std::string;
 using std::unordered_map;
 #include <vector>
 using std::vector;
+#include <functional> // function
+#include <memory>     // unique_ptr, shared_ptr
+#include <mutex>      // once_flag
 
+#include "reporter.h"
+
+/// Heap activity of one thread, or of every thread while a serial test runs, counted by the
+/// replacement `operator new` and `operator delete` of alloc_tracker.cpp. Nothing is counted
+/// unless the program links that file.
+struct alloc_counts {
+    size_t allocs;          //!< Blocks allocated.
+    size_t frees;           //!< Blocks freed.
+    long long live_bytes;   //!< Bytes allocated minus bytes freed.
+    long long peak_bytes;   //!< Highest `live_bytes` reached.
+    int paused;             //!< While positive, nothing is counted.
+    bool other_threads;     //!< Whether threads started by the test used the heap too.
+};
 
 /// Implements a simple test manager.
 class TestManager {
@@ -33,23 +56,92 @@ class TestManager {
         /// Defines a single entry in our database.
         struct Entry {
             /// List of possible test results.
-            enum class result_t : int { SUCCESS, FAILED, UNDEFINED };
+            enum class result_t : int { SUCCESS, FAILED, UNDEFINED, CRASHED, TIMEOUT };
+            string m_name;     //!< The test name, which is its key.
             string m_desc;     //!< The test text description.
             size_t m_seq;      //!< The test sequence number, to help us print the test in the order the client registered them.
             result_t m_result; //!< The test result.
             int m_line;        //!< The test line number.
             bool m_enabled;    //!< Indicates wheter the test is enabled (default) or not.
+            string m_error;    //!< Message of the exception that escaped the test body, if any.
+            string m_note;     //!< Details of the first failed performance assertion, or of a crash or timeout.
+            double m_wall_ms;  //!< Wall clock time the test took, in milliseconds.
+            double m_cpu_ms;   //!< CPU time the test took on its thread, in milliseconds.
+            bool m_selected;   //!< Whether the test passed the filter and belongs to this shard.
+            size_t m_runs;     //!< How many times the test ran, when repeated.
+            size_t m_failures; //!< How many of those runs failed, crashed or timed out.
+            std::vector< double > m_wall_samples; //!< Wall clock time of every run, when repeated.
+            alloc_counts m_heap;  //!< Heap activity of the test body, when allocations are tracked.
+            bool m_serial;     //!< Whether the test must run alone, after the tests that run in parallel.
             /// Default Ctro
-            Entry( string d="no_name", size_t s = 0, result_t r=result_t::UNDEFINED, int l=0, bool e=true )
-                : m_desc{ d }, m_seq{ s }, m_result{ r }, m_line{ l }, m_enabled{ e }
+            Entry( string n="no_name", string d="no_name", size_t s = 0, result_t r=result_t::UNDEFINED, int l=0, bool e=true )
+                : m_name{ n }, m_desc{ d }, m_seq{ s }, m_result{ r }, m_line{ l }, m_enabled{ e },
+                  m_wall_ms{ 0 }, m_cpu_ms{ 0 }, m_selected{ true }, m_runs{ 0 }, m_failures{ 0 }, m_heap(), m_serial{ false }
             { /* empty */ }
+            /// Tells whether the test failed, crashed or timed out.
+            bool failed( void ) const
+            { return m_result == result_t::FAILED or m_result == result_t::CRASHED or m_result == result_t::TIMEOUT; }
+        };
+    public:
+        /// Handle to a registered test, returned by `record()`. Assertions use it to reach the
+        /// test's entry directly, so they neither hash its name nor allocate.
+        class test_id {
+            public:
+                /// Position of the test in registration order.
+                size_t index( void ) const { return m_index; }
+            private:
+                friend class TestManager;
+                explicit test_id( size_t index ) : m_index{ index } {}
+                size_t m_index;
+        };
+        /// The body of a test registered to be run later, by `run()`.
+        using test_body = std::function< void( TestManager &, test_id ) >;
+        /// Which registered tests `run()` and `run_isolated()` run, and how many times.
+        struct options {
+            /// Globs on the test name, or on `suite.name`, separated by ':'. A glob that starts with
+            /// '-', and every glob after it, leaves tests out, as in "Sort*:Merge*:-Merge 6".
+            std::string filter{ "*" };
+            size_t shard_index{ 0 };  //!< This process runs the tests whose position modulo `shard_count` is `shard_index`.
+            size_t shard_count{ 1 };  //!< How many processes the selected tests are split across.
+            size_t repeat{ 1 };       //!< How many times every selected test runs.
+            bool shuffle{ false };    //!< Whether the tests run in a new random order on every repetition.
+            unsigned seed{ 0 };       //!< Seed of the random order.
+            bool list_only{ false };  //!< Whether to print the selected tests instead of running them.
         };
-        /// Records the tests results. The key is the test name, and the data is an `Entry`.
-        std::unordered_map< std::string, Entry > tests_record;
+        /// Growth rates `EXPECT_COMPLEXITY` can tell apart, from the slowest growing to the fastest.
+        enum class complexity_t : int { O_1, O_LOG_N, O_N, O_N_LOG_N, O_N_SQUARED, O_N_CUBED };
+
+        /// Measures the time of a `BEGIN_TEST` block, from its declaration to the end of the block.
+        class timer {
+            public:
+                timer( TestManager & tm, test_id id );
+                ~timer();
+            private:
+                TestManager & m_tm;
+                test_id m_id;
+                double m_wall0, m_cpu0;
+        };
+
+    private:
+        /// Records the tests, in registration order. Entries never move, so a test running on a
+        /// worker thread may update its own entry while other tests update theirs.
+        std::vector< std::unique_ptr< Entry > > tests_record;
+        /// Maps a test name to its position in `tests_record`.
+        std::unordered_map< std::string, size_t > tests_index;
+        /// Bodies of the tests registered with `add()`, with the position of their entries.
+        std::vector< std::pair< size_t, test_body > > tests_body;
         /// The test suite name.
         std::string test_suite_name;
         /// Number of tests registred.
         size_t n_tests;
+        /// Reporters that receive every result as soon as its test finishes.
+        std::vector< std::shared_ptr< Reporter > > m_reporters;
+        /// Makes sure reporters are told the suite began exactly once.
+        std::once_flag m_begun;
+        /// In a child process of `run_isolated()`, the pipe its results go to; -1 otherwise.
+        int m_child_fd;
+        /// Which tests run, and how many times.
+        options m_options;
 
     private:
         /// Prints out the overall result of a single test.
@@ -61,48 +153,158 @@ class TestManager {
                 std::cout << "[  " << "\e[1;36mDISABLED\e[0m" << " ]\n";
                 return;
             }
+            if ( entry.m_runs > 1 )
+            {
+                print_runs( entry );
+                return;
+            }
             if ( entry.m_result == Entry::result_t::SUCCESS )
-                std::cout << "[        " << "\e[1;32mOK\e[0m" << " ]\n";
+                std::cout << "[        " << "\e[1;32mOK\e[0m" << " ]";
+            else if ( entry.m_result == Entry::result_t::FAILED and not entry.m_error.empty() )
+                std::cout << "[      "  << "\e[1;31mFAIL\e[0m" << " ] threw: " << entry.m_error << ".";
+            else if ( entry.m_result == Entry::result_t::FAILED and not entry.m_note.empty() )
+                std::cout << "[      "  << "\e[1;31mFAIL\e[0m" << " ] at line " << entry.m_line << ": " << entry.m_note << ".";
             else if ( entry.m_result == Entry::result_t::FAILED )
-                std::cout << "[      "  << "\e[1;31mFAIL\e[0m" << " ] at line " << entry.m_line << ".\n";
+                std::cout << "[      "  << "\e[1;31mFAIL\e[0m" << " ] at line " << entry.m_line << ".";
             else if ( entry.m_result == Entry::result_t::UNDEFINED )
-                std::cout << "[ "  << "\e[1;35mUNDEFINED\e[0m" << " ] at line " << entry.m_line << ".\n";
+                std::cout << "[ "  << "\e[1;35mUNDEFINED\e[0m" << " ] at line " << entry.m_line << ".";
+            else if ( entry.m_result == Entry::result_t::CRASHED )
+                std::cout << "[   "  << "\e[1;31mCRASHED\e[0m" << " ] " << entry.m_note << ", last assertion at line " << entry.m_line << ".";
+            else if ( entry.m_result == Entry::result_t::TIMEOUT )
+                std::cout << "[   "  << "\e[1;31mTIMEOUT\e[0m" << " ] " << entry.m_note << ", last assertion at line " << entry.m_line << ".";
+            print_heap( entry );
+            print_time( entry.m_wall_ms, entry.m_cpu_ms );
         }
+        /// Prints out how long something took, in milliseconds.
+        static void print_time( double wall_ms, double cpu_ms );
+        /// Prints out the heap activity of a test, if allocations are tracked.
+        static void print_heap( const Entry &entry );
+        /// Bytes the test left allocated, as reported; 0 when threads it started used the heap.
+        static long long leaked_bytes( const alloc_counts &heap );
+        /// Prints out the results of a test that ran several times.
+        static void print_runs( const Entry &entry );
+        /// Marks which tests pass the filter and belong to this shard, and returns their bodies' positions.
+        std::vector< size_t > select( void );
+        /// Runs the selected bodies as many times as asked, each time through `pass`, and folds the results.
+        void run_repeated( const std::function< void( const std::vector< size_t > &, bool ) > &pass );
+        /// Runs the given bodies on `n_workers` threads.
+        void run_threads( const std::vector< size_t > &order, size_t n_workers );
+        /// Runs the given bodies in child processes.
+        void run_forked( const std::vector< size_t > &order, size_t max_children, double timeout_ms );
+        /// Sends the result of a finished test to every reporter.
+        void report( const Entry &entry );
+        /// Runs the i-th registered body, timing it and recording any exception it throws.
+        void run_body( size_t i );
+        /// Runs the i-th registered body in a child process, sends its results to `fd`, and exits.
+        [[noreturn]] void run_child( size_t i, int fd );
 
         //=== Public interface.
     public:
         /// Default constructor that may take the test suite name.
         explicit TestManager( const std::string suite_name="Default" )
-            : test_suite_name{ suite_name }, n_tests{0}
+            : test_suite_name{ suite_name }, n_tests{0}, m_child_fd{-1}
         { /* empty */ }
 
-        /// Registers a test with this suite
-        inline void record ( const std::string &key_name, const std::string& msg )
-        {
-            // Store the entry in the data base.
-            tests_record[key_name] = Entry{ msg, n_tests++ };
-        }
+        /// Registers a test with this suite, and returns its handle.
+        test_id record ( const std::string &key_name, const std::string& msg );
+
+        /// Adds a reporter, which receives the results of the tests that finish from now on.
+        void add_reporter( std::shared_ptr< Reporter > reporter );
+
+        /// Sets which tests the next `run()` or `run_isolated()` runs, and how many times.
+        void set_options( const options &opt ) { m_options = opt; }
+
+        /// Tells whether `text` matches the glob `pattern`, where '*' matches any run of characters and '?' any one.
+        static bool glob_match( const std::string &pattern, const std::string &text );
+
+        /// Registers a test with this suite, and returns the slot where its body goes.
+        test_body & add ( const std::string &key_name, const std::string& msg, bool serial=false );
 
         inline void enable ( const std::string &key_name, bool value=true )
         {
             // First, let us see if the key is recorded (test has been registered)
-            if ( tests_record.count( key_name ) == 0 ) return;
+            auto it = tests_index.find( key_name );
+            if ( it == tests_index.end() ) return;
 
             // Ok, test present. Just set the disabled status accordingly.
-            tests_record[ key_name ].m_enabled = value;
+            enable( test_id{ it->second }, value );
         }
 
-        /// Updates the test result.
+        inline void enable ( test_id id, bool value=true )
+        {
+            tests_record[ id.m_index ]->m_enabled = value;
+        }
+
+        /// Updates the result of the test named `key`.
         void result( const std::string &key, bool value, int line );
 
+        /// Updates the test result.
+        void result( test_id id, bool value, int line );
+
+        /// Records how long a test took.
+        void record_time( test_id id, double wall_ms, double cpu_ms );
+
+        /// Fails the test unless a single run of `op` takes at most `max_ns` nanoseconds.
+        void expect_faster_than( test_id id, const std::function< void() > &op, double max_ns, int line );
+
+        /// Fails the test unless `op(n)` grows no faster than `expected` over the given sizes.
+        void expect_complexity( test_id id, const std::function< void( size_t ) > &op,
+                                const std::vector< size_t > &sizes, complexity_t expected, int line );
+
+        /// Fails the test if running `op` allocates more than `max_allocs` blocks.
+        void expect_allocs_le( test_id id, const std::function< void() > &op, size_t max_allocs, int line );
+
+        /// Fails the test if running `op` leaves more bytes allocated than before.
+        void expect_no_leak( test_id id, const std::function< void() > &op, int line );
+
+        /// Counts a block of `bytes` allocated by the calling thread; called by alloc_tracker.cpp.
+        static void count_alloc( size_t bytes );
+
+        /// Counts a block of `bytes` freed by the calling thread; called by alloc_tracker.cpp.
+        static void count_free( size_t bytes );
+
+        /// The allocation counts the calling thread adds to: its own, or those shared by every
+        /// thread while a serial test runs.
+        static alloc_counts heap_counts( void );
+
+        /// Tells whether allocations are counted, that is, whether the program links alloc_tracker.cpp.
+        static bool tracks_allocs( void );
+
+        /// Turns allocation counting on; called by alloc_tracker.cpp before `main()`.
+        static void enable_alloc_tracking( void );
+
+        /// Typical time of a single run of `op`, in nanoseconds.
+        static double time_ns( const std::function< void() > &op );
+
+        /// The growth rate that best fits the times of `op(n)` over the given sizes.
+        static complexity_t fit_complexity( const std::function< void( size_t ) > &op, const std::vector< size_t > &sizes );
+
+        /// Big-O notation of a growth rate.
+        static const char * to_string( complexity_t c );
+
+        /// Runs the bodies registered with `add()` on `n_workers` threads (0 means one per core).
+        void run( size_t n_workers = 0 );
+
+        /// Runs the bodies registered with `add()` each in its own child process, at most
+        /// `max_children` at a time (0 means one per core), killing those that take over `timeout_ms`.
+        void run_isolated( size_t max_children = 0, double timeout_ms = 10000 );
+
         /// Shows the test suite results.
         void summary(void) const;
+
+        /// Tells whether no enabled test has failed.
+        bool all_passed(void) const;
 };
 
 //=== MACRO definitions.
-#define BEGIN_TEST(tm, key, msg) std::string _test_id{key}; \
-    TestManager &_tm = tm; \
-    _tm.record( key, msg )
+#define BEGIN_TEST(tm, key, msg) TestManager &_tm = tm; \
+    const TestManager::test_id _test_id{ _tm.record( key, msg ) }; \
+    TestManager::timer _timer{ _tm, _test_id }
+/// Registers the block that follows, which must end with `};`, as a test to be run by `tm.run()`.
+#define TEST_CASE(tm, key, msg) (tm).add( key, msg ) = [&]( TestManager &_tm, const TestManager::test_id _test_id )
+/// Like `TEST_CASE`, but the test runs alone, once the other tests are done. For tests that time
+/// themselves or touch process-wide state.
+#define SERIAL_TEST_CASE(tm, key, msg) (tm).add( key, msg, true ) = [&]( TestManager &_tm, const TestManager::test_id _test_id )
 #endif
 //#define RESULT(tm, key, res) tm.result( key, res, __LINE__ )
 #define RESULT(key, res) _tm.result( key, res, __LINE__ )
@@ -117,4 +319,12 @@ class TestManager {
 #define EXPECT_LT( value1, value2 ) _tm.result( _test_id, value1<value2, __LINE__ )
 #define EXPECT_LE( value1, value2 ) _tm.result( _test_id, value1<=value2, __LINE__ )
 #define DISABLE() _tm.enable( _test_id, false );
+/// Fails unless evaluating `expr` takes at most `ns` nanoseconds.
+#define EXPECT_FASTER_THAN( expr, ns ) _tm.expect_faster_than( _test_id, [&]{ expr; }, ns, __LINE__ )
+/// Fails unless `op`, callable as `op(n)`, grows like `big_o` or slower; `sizes` is a `std::vector<size_t>`.
+#define EXPECT_COMPLEXITY( op, sizes, big_o ) _tm.expect_complexity( _test_id, op, sizes, TestManager::complexity_t::big_o, __LINE__ )
+/// Fails if evaluating `expr` allocates more than `n` blocks. Checks nothing unless allocations are tracked.
+#define EXPECT_ALLOCS_LE( expr, n ) _tm.expect_allocs_le( _test_id, [&]{ expr; }, n, __LINE__ )
+/// Fails if the statements given leave memory allocated. Checks nothing unless allocations are tracked.
+#define EXPECT_NO_LEAK( ... ) _tm.expect_no_leak( _test_id, [&]{ __VA_ARGS__; }, __LINE__ )
 
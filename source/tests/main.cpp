@@ -5,6 +5,26 @@
 
 #include "include/tm/test_manager.h"
 #include "../include/list.h"
+#include "../include/list_binary.h"
+#include "../include/mapped_list.h"
+#include "../include/list_text.h"
+#include "../include/static_list.h"
+#include "../include/small_list.h"
+#include "../include/list_queue.h"
+#include "../include/list_epoch.h"
+#include "../include/persistent_list.h"
+#include "../include/list_views.h"
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <random>
+#include <set>
+#include <sstream>
+#include <thread>
+#include <vector>
 
 #define which_lib sc 
 // #define which_lib std
@@ -23,31 +43,89 @@ std::ostream & operator<<( std::ostream &os, const which_lib::list<T> & L )
     return os;
 }
 
-int main( void )
+int main( int argc, char * argv[] )
 {
+    // --junit=FILE and --json=FILE stream the results into report files as the tests finish.
+    // --isolate runs every test in its own process, killed after --timeout=MS milliseconds.
+    // --filter=GLOBS, --shard=I/N, --repeat=N, --shuffle [--seed=S] and --list choose what runs.
+    std::vector< std::shared_ptr< Reporter > > reporters;
+    bool isolate{ false };
+    double timeout_ms{ 10000 };
+    TestManager::options options;
+    bool seeded{ false };
+    for ( int i{1}; i < argc; ++i )
+    {
+        std::string arg{ argv[i] };
+        size_t shard_index{0}, shard_count{0};
+        if ( arg.rfind( "--filter=", 0 ) == 0 )
+            options.filter = arg.substr( 9 );
+        else if ( std::sscanf( arg.c_str(), "--shard=%zu/%zu", &shard_index, &shard_count ) == 2
+                  and shard_index < shard_count )
+        {
+            options.shard_index = shard_index;
+            options.shard_count = shard_count;
+        }
+        else if ( arg.rfind( "--repeat=", 0 ) == 0 and std::atoi( arg.c_str() + 9 ) > 0 )
+            options.repeat = std::strtoul( arg.c_str() + 9, nullptr, 10 );
+        else if ( arg == "--shuffle" )
+            options.shuffle = true;
+        else if ( arg.rfind( "--seed=", 0 ) == 0 )
+        {
+            options.seed = static_cast< unsigned >( std::strtoul( arg.c_str() + 7, nullptr, 10 ) );
+            seeded = true;
+        }
+        else if ( arg == "--list" )
+            options.list_only = true;
+        else if ( arg.rfind( "--junit=", 0 ) == 0 )
+            reporters.push_back( std::make_shared< JUnitReporter >( arg.substr( 8 ) ) );
+        else if ( arg.rfind( "--json=", 0 ) == 0 )
+            reporters.push_back( std::make_shared< JsonReporter >( arg.substr( 7 ) ) );
+        else if ( arg == "--isolate" )
+            isolate = true;
+        else if ( arg.rfind( "--timeout=", 0 ) == 0 )
+            timeout_ms = std::atof( arg.c_str() + 10 );
+        else
+        {
+            std::cerr << "Usage: " << argv[0] << " [--junit=FILE] [--json=FILE] [--isolate [--timeout=MS]]\n"
+                      << "       [--filter=GLOB[:GLOB...][:-GLOB[:GLOB...]]] [--shard=I/N] [--repeat=N]\n"
+                      << "       [--shuffle [--seed=S]] [--list]\n";
+            return EXIT_FAILURE;
+        }
+    }
+    if ( options.shuffle and not seeded )
+        options.seed = std::random_device{}();
+    if ( options.shuffle and not options.list_only )
+        std::cout << "Shuffling with --seed=" << options.seed << "\n";
+    auto run = [&]( TestManager & suite ) {
+        if ( isolate ) suite.run_isolated( 0, timeout_ms );
+        else suite.run();
+    };
+
     //=== TESTING BASIC OPERATIONS METHODS
     TestManager tm{ "Basic Operations Test Suite"};
+    for ( auto & r : reporters ) tm.add_reporter( r );
+    tm.set_options( options );
+    TEST_CASE(tm,"DefaultConstructor", "default constructor")
     {
-        BEGIN_TEST(tm,"DefaultConstructor", "default constructor");
 
         which_lib::list<int> list;
 
         EXPECT_EQ( list.size(), 0);
         EXPECT_TRUE( list.empty() );
-    }
+    };
 
+    TEST_CASE(tm, "ConstructorSize", "Constructor size")
     {
-        BEGIN_TEST(tm, "ConstructorSize", "Constructor size");
 
         which_lib::list<int> list(10);
 
         EXPECT_EQ(list.size(), 10);
         EXPECT_FALSE(list.empty());
-    }
+    };
 
 
+    TEST_CASE(tm,"ListContructor", "initializer list constructor.")
     {
-        BEGIN_TEST(tm,"ListContructor", "initializer list constructor.");
 
         which_lib::list<int> list{ 1, 2, 3, 4, 5 };
         EXPECT_EQ( list.size(), 5 );
@@ -57,10 +135,10 @@ int main( void )
         int i { 0 };
         for( auto it = list.cbegin() ; it != list.cend() ; ++i )
             EXPECT_EQ( i+1, *it++ );
-    }   
+    };
 
+    TEST_CASE(tm,"RangeConstructor", "checking constructors with a range of values")
     {
-        BEGIN_TEST(tm,"RangeConstructor", "checking constructors with a range of values");
         // Range = the entire list.
         which_lib::list<int> list{ 1, 2, 3, 4, 5 };
         which_lib::list<int> list2( list.begin(), list.end() );
@@ -81,10 +159,10 @@ int main( void )
         auto it2 = std::next( list.begin(), 1 );
         for (auto it = list3.begin() ; it != list3.end() ; ++it, ++it2 )
             EXPECT_EQ( *it, *it2 );
-    }
+    };
 
+    TEST_CASE(tm, "CopyConstructor","constructor copy values of another list.")
     {
-        BEGIN_TEST(tm, "CopyConstructor","constructor copy values of another list.");
         // Range = the entire list.
         which_lib::list<int> list{ 1, 2, 3, 4, 5 };
         which_lib::list<int> list2( list );
@@ -105,7 +183,7 @@ int main( void )
         i = 1;
         for( auto e : list2 )
             EXPECT_EQ( e, i++ );
-    }
+    };
 #ifdef MOVE_SYNTAX_IMPLEMENTED
 
     // {
@@ -124,8 +202,8 @@ int main( void )
 #endif
 
 
+    TEST_CASE(tm, "AssignOperator", "ASSIGN OPERATOR")
     {
-        BEGIN_TEST(tm, "AssignOperator", "ASSIGN OPERATOR");
         // Range = the entire list.
         which_lib::list<int> list{ 1, 2, 3, 4, 5 };
         which_lib::list<int> list2;
@@ -138,7 +216,7 @@ int main( void )
         auto i{1};
         for( auto e : list2 )
             EXPECT_EQ ( e,i++ );;
-    }
+    };
 
 #ifdef MOVE_SYNTAX_IMPLEMENTED  
     // // {
@@ -161,8 +239,8 @@ int main( void )
 #endif
 
 
+    TEST_CASE(tm, "ListInitializerAssign","initializer list assignment")
     {
-        BEGIN_TEST(tm, "ListInitializerAssign","initializer list assignment");
         // Range = the entire list.
         which_lib::list<int> list = { 1, 2, 3, 4, 5 };
 
@@ -173,11 +251,50 @@ int main( void )
         auto i{1};
         for( auto e : list )
             EXPECT_EQ ( e, i++ );
-    }
+    };
 
 
+    TEST_CASE(tm, "AssignReusesNodes", "assignment overwrites the nodes already held")
+    {
+        which_lib::list<int> list_a{ 1, 2, 3 };
+        which_lib::list<int> list_b{ 9, 9, 9, 9, 9 };
+        auto more = { 4, 5, 6, 7 };
+
+        EXPECT_ALLOCS_LE( list_b = list_a, 0 );
+        EXPECT_EQ( list_b, list_a );
+        EXPECT_ALLOCS_LE( list_b = more, 1 );
+        EXPECT_EQ( list_b, ( which_lib::list<int>{ 4, 5, 6, 7 } ) );
+
+        // Elements that are not trivially copyable go through their own assignment.
+        which_lib::list<std::string> strings_a{ "a", "bb" };
+        which_lib::list<std::string> strings_b{ "x", "y", "z" };
+        strings_b = strings_a;
+        EXPECT_EQ( strings_b, strings_a );
+        strings_b = { "c", "dd", std::string( 100, 'e' ) };
+        EXPECT_EQ( strings_b.size(), 3 );
+        EXPECT_EQ( strings_b.back(), std::string( 100, 'e' ) );
+    };
+
+    TEST_CASE(tm, "AssignRange", "assign replaces the contents, even with a range from the list itself")
+    {
+        which_lib::list<int> list_a{ 1, 2, 3 };
+        std::vector<int> vec{ 7, 8, 9, 10 };
+
+        list_a.assign( vec.begin(), vec.end() );
+        EXPECT_EQ( list_a, ( which_lib::list<int>{ 7, 8, 9, 10 } ) );
+        list_a.assign( { 4, 5 } );
+        EXPECT_EQ( list_a, ( which_lib::list<int>{ 4, 5 } ) );
+
+        // The source range belongs to the list being assigned.
+        which_lib::list<int> list_b{ 1, 2, 3, 4, 5 };
+        list_b.assign( std::next( list_b.begin() ), std::prev( list_b.end() ) );
+        EXPECT_EQ( list_b, ( which_lib::list<int>{ 2, 3, 4 } ) );
+        list_b.assign( list_b.begin(), list_b.end() );
+        EXPECT_EQ( list_b, ( which_lib::list<int>{ 2, 3, 4 } ) );
+    };
+
+    TEST_CASE(tm, "Clear", "clear")
     {
-        BEGIN_TEST(tm, "Clear", "clear");
         // Range = the entire list.
         which_lib::list<int> list = { 1, 2, 3, 4, 5 };
 
@@ -188,10 +305,10 @@ int main( void )
 
         EXPECT_EQ( list.size(), 0 );
         EXPECT_TRUE( list.empty() );
-    }
+    };
 
+    TEST_CASE(tm, "PushFront","PushFront")
     {
-        BEGIN_TEST(tm, "PushFront","PushFront");
         // #1 From an empty list.
         which_lib::list<int> list;
 
@@ -224,11 +341,11 @@ int main( void )
             EXPECT_EQ( e , i-- );
         }
 
-    }
+    };
 
 
+    TEST_CASE(tm, "PushBack", "PushBack")
     {
-        BEGIN_TEST(tm, "PushBack", "PushBack");
         // #1 From an empty list.
         which_lib::list<int> list;
 
@@ -257,10 +374,10 @@ int main( void )
         i=0;
         for ( const auto & e: list )
             EXPECT_EQ( e , ++i );
-    }
+    };
 
+    TEST_CASE(tm, "PopBack", "PopBack")
     {
-        BEGIN_TEST(tm, "PopBack", "PopBack");
         // #1 From an empty list.
         which_lib::list<int> list{ 1, 2, 3, 4, 5 };
 
@@ -272,10 +389,10 @@ int main( void )
             for ( const auto & e: list )
                 EXPECT_EQ( e , ++i );
         }
-    }
+    };
 
+    TEST_CASE(tm, "PopFront", "PopFront")
     {
-        BEGIN_TEST(tm, "PopFront", "PopFront");
         // #1 From an empty list.
         which_lib::list<int> list{ 1, 2, 3, 4, 5 };
 
@@ -289,11 +406,31 @@ int main( void )
                 EXPECT_EQ( e, ++i );
             start++;
         }
-    }
+    };
+
+    TEST_CASE(tm, "PopKeepsEnds", "popping leaves a list that can grow at both ends again")
+    {
+        which_lib::list<int> list{ 1, 2, 3 };
+
+        list.pop_front();
+        list.pop_back();
+        EXPECT_EQ( list.size(), 1u );
+        EXPECT_EQ( list.front(), 2 );
+        EXPECT_EQ( list.back(), 2 );
+        list.pop_back();
+        EXPECT_TRUE( list.empty() );
+        EXPECT_EQ( list.begin(), list.end() );
+
+        list.push_front( 5 );
+        list.push_back( 6 );
+        list.push_front( 4 );
+        EXPECT_EQ( list, ( which_lib::list<int>{ 4, 5, 6 } ) );
+        EXPECT_EQ( *std::prev( list.end() ), 6 );
+    };
 
 
+    TEST_CASE(tm, "Front", "front")
     {
-        BEGIN_TEST(tm, "Front", "front");
         // #1 From an empty list.
         which_lib::list<int> list{ 1, 2, 3, 4, 5 };
 
@@ -305,21 +442,21 @@ int main( void )
             EXPECT_EQ( current_size, list.size() );
             list.pop_front();
         }
-    }
+    };
 
+    TEST_CASE(tm, "FrontConst","FrontConst")
     {
-        BEGIN_TEST(tm, "FrontConst","FrontConst");
         // #1 From an empty list.
         const which_lib::list<int> list{ 1, 2, 3, 4, 5 };
         EXPECT_EQ( list.front(), 1 );
 
         const which_lib::list<char> list2{ 'a', 'e', 'i', 'o', 'u' };
         EXPECT_EQ( list2.front(), 'a' );
-    }
+    };
 
 
+    TEST_CASE(tm, "Back","Back")
     {
-        BEGIN_TEST(tm, "Back","Back");
         // #1 From an empty list.
         which_lib::list<int> list{ 1, 2, 3, 4, 5 };
 
@@ -331,18 +468,18 @@ int main( void )
             EXPECT_EQ( current_size, list.size() );
             list.pop_back();
         }
-    }
+    };
 
 
+    TEST_CASE(tm, "BackConst","BackConst")
     {
-        BEGIN_TEST(tm, "BackConst","BackConst");
         // #1 From an empty list.
         const which_lib::list<int> list{ 1, 2, 3, 4, 5 };
         EXPECT_EQ( list.back(), 5 );
 
         const which_lib::list<char> list2{ 'a', 'e', 'i', 'o', 'u' };
         EXPECT_EQ( list2.back(), 'u' );
-    }
+    };
 
 
 
@@ -374,8 +511,8 @@ int main( void )
     // }
 
 
+    TEST_CASE(tm, "OperatorEqual","OperatorEqual")
     {
-        BEGIN_TEST(tm, "OperatorEqual","OperatorEqual");
         // #1 From an empty list.
         which_lib::list<int> list { 1, 2, 3, 4, 5 };
         which_lib::list<int> list2 { 1, 2, 3, 4, 5 };
@@ -385,11 +522,11 @@ int main( void )
         EXPECT_EQ( list , list2 );
         EXPECT_TRUE( not ( list == list3 ) );
         EXPECT_TRUE( not ( list == list4 ) );
-    }
+    };
 
 
+    TEST_CASE(tm, "OperatorDifferent","OperatorDifferent")
     {
-        BEGIN_TEST(tm, "OperatorDifferent","OperatorDifferent");
         // #1 From an empty list.
         which_lib::list<int> list { 1, 2, 3, 4, 5 };
         which_lib::list<int> list2 { 1, 2, 3, 4, 5 };
@@ -399,11 +536,11 @@ int main( void )
         EXPECT_TRUE( not( list != list2 ) );
         EXPECT_NE( list, list3 );
         EXPECT_NE( list,list4 );
-    }
+    };
 
 
+    TEST_CASE(tm, "InsertSingleValueAtPosition","InsertSingleValueAtPosition")
     {
-        BEGIN_TEST(tm, "InsertSingleValueAtPosition","InsertSingleValueAtPosition");
         // #1 From an empty list.
         which_lib::list<int> list { 1, 2, 4, 5, 6 };
 
@@ -419,11 +556,11 @@ int main( void )
         list.insert( list.end(), 7 );
         EXPECT_EQ( list , ( which_lib::list<int>{ 0, 1, 2, 3, 4, 5, 6, 7 } ) );
 
-    }
+    };
 
 
+    TEST_CASE(tm, "InsertRange","InsertRange")
     {
-        BEGIN_TEST(tm, "InsertRange","InsertRange");
         // Aux arrays.
         which_lib::list<int> list1 { 1, 2, 3, 4, 5 };
         which_lib::list<int> list2 { 1, 2, 3, 4, 5 };
@@ -449,11 +586,11 @@ int main( void )
         // list1.insert( std::next( list1.end(), 2 ) , source.begin(), source.end() );
         // EXPECT_EQ( list1 , ( which_lib::list<int>{ 1, 2, 3, 4, 5 } ) );
 
-    }
+    };
 
 
+    TEST_CASE(tm, "InsertInitializarList","InsertInitializarList")
     {
-        BEGIN_TEST(tm, "InsertInitializarList","InsertInitializarList");
         // Aux arrays.
         which_lib::list<int> list1 { 1, 2, 3, 4, 5 };
         which_lib::list<int> list2 { 1, 2, 3, 4, 5 };
@@ -477,7 +614,7 @@ int main( void )
         // list1 = list2;
         // list1.insert( std::next( list1.end(), 2 ) , { 6, 7, 8, 9, 10 } );
         // EXPECT_EQ( list1 , ( which_lib::list<int>{ 1, 2, 3, 4, 5 } ) );
-    }
+    };
 
 
     // // {
@@ -509,8 +646,8 @@ int main( void )
     // // }
 
 
+    TEST_CASE(tm, "EraseRange","EraseRange")
     {
-        BEGIN_TEST(tm, "EraseRange","EraseRange");
         // Initial list.
         which_lib::list<int> list { 1, 2, 3, 4, 5 };
 
@@ -539,11 +676,11 @@ int main( void )
         past_last = list.erase( list.begin(), list.end() );
         EXPECT_EQ( list.end() , past_last );
         EXPECT_TRUE( list.empty() );
-    }
+    };
 
 
+    TEST_CASE(tm, "ErasePos","ErasePos")
     {
-        BEGIN_TEST(tm, "ErasePos","ErasePos");
         // Initial list.
         which_lib::list<int> list { 1, 2, 3, 4, 5 };
 
@@ -569,10 +706,10 @@ past_last = list.erase( std::next(list.begin(),2) );
         EXPECT_EQ( list , ( which_lib::list<int>{ 1, 2, 3, 4 } ) );
         EXPECT_EQ( list.end() , past_last );
         EXPECT_EQ( list.size() , 4 );
-    }
+    };
 
+    TEST_CASE(tm, "Reverse","Checking the reverse methos")
     {
-        BEGIN_TEST(tm, "Reverse","Checking the reverse methos");
         // Regular case odd list length 
         which_lib::list<int> list { 1, 2, 3, 4, 5 };
         list.reverse();
@@ -589,16 +726,19 @@ past_last = list.erase( std::next(list.begin(),2) );
         which_lib::list<int> list4;
         list4.reverse();
         EXPECT_TRUE( list4.empty() );
-    }
+    };
 
+    run( tm );
     tm.summary();
 
 
     //=== TESTING ITERATOR METHODS
     TestManager tm2{ "Iterator Test Suite"};
+    for ( auto & r : reporters ) tm2.add_reporter( r );
+    tm2.set_options( options );
 
+    TEST_CASE(tm2, "begin","list.begin()")
     {
-        BEGIN_TEST(tm2, "begin","list.begin()");
 
         which_lib::list<int> list { 1, 2, 4, 5, 6 };
         which_lib::list<int>::iterator it = list.begin();
@@ -616,10 +756,10 @@ past_last = list.erase( std::next(list.begin(),2) );
         which_lib::list<int> list4 = { 10, 11, 12, 13, 14 };
         it = list4.begin();
         EXPECT_EQ( 10, *it );
-    }
+    };
 
+    TEST_CASE(tm2, "cbegin","list.cbegin()")
     {
-        BEGIN_TEST(tm2, "cbegin","list.cbegin()");
 
         which_lib::list<int> list { 1, 2, 4, 5, 6 };
         which_lib::list<int>::const_iterator cit = list.cbegin();
@@ -636,10 +776,10 @@ past_last = list.erase( std::next(list.begin(),2) );
         which_lib::list<int> list4 = { 10, 11, 12, 13, 14 };
         cit = list4.cbegin();
         EXPECT_EQ( 10, *cit );
-    }
+    };
 
+    TEST_CASE(tm2, "end","list.end()")
     {
-        BEGIN_TEST(tm2, "end","list.end()");
 
         which_lib::list<int> list { 1, 2, 4, 5, 6 };
         which_lib::list<int>::iterator it = std::next( list.begin(), 5 );
@@ -657,10 +797,10 @@ past_last = list.erase( std::next(list.begin(),2) );
         which_lib::list<int> list4 = { 10, 11, 12, 13, 14 };
         it = std::next( list4.begin(), 5 );
         EXPECT_EQ( it, list4.end() );
-    }
+    };
 
+    TEST_CASE(tm2, "cend","list.cend()")
     {
-        BEGIN_TEST(tm2, "cend","list.cend()");
 
         which_lib::list<int> list { 1, 2, 3, 4, 5 };
         which_lib::list<int>::const_iterator it = std::next(list.cbegin(), 5 );
@@ -677,10 +817,10 @@ past_last = list.erase( std::next(list.begin(),2) );
         which_lib::list<int> list4 = { 10, 11, 12, 13, 14 };
         it = std::next( list4.cbegin(), 5 );
         EXPECT_EQ( it, list4.cend() );
-    }
+    };
 
+    TEST_CASE(tm2, "operator++()","Preincrement, ++it")
     {
-        BEGIN_TEST(tm2, "operator++()","Preincrement, ++it");
 
         which_lib::list<int> list { 1, 2, 3, 4, 5 };
         int expected[]{1, 2, 3, 4, 5};
@@ -691,10 +831,10 @@ past_last = list.erase( std::next(list.begin(),2) );
             EXPECT_EQ( *it, e );
             ++it;
         }
-    }
+    };
     
+    TEST_CASE(tm2, "operator++(int)","Postincrement, it++")
     {
-        BEGIN_TEST(tm2, "operator++(int)","Postincrement, it++");
 
         which_lib::list<int> list { 1, 2, 3, 4, 5 };
         int expected[]{1, 2, 3, 4, 5};
@@ -705,10 +845,10 @@ past_last = list.erase( std::next(list.begin(),2) );
             EXPECT_EQ( *it, e );
             it++;
         }
-    }
+    };
 
+    TEST_CASE(tm2, "operator--()","Preincrement, --it")
     {
-        BEGIN_TEST(tm2, "operator--()","Preincrement, --it");
 
         which_lib::list<int> list { 1, 2, 3, 4, 5 };
         int expected[]{5, 4, 3, 2, 1};
@@ -719,10 +859,10 @@ past_last = list.erase( std::next(list.begin(),2) );
             --it;
             EXPECT_EQ( *it, e );
         }
-    }
+    };
     
+    TEST_CASE(tm2, "operator--(int)","Postincrement, it--")
     {
-        BEGIN_TEST(tm2, "operator--(int)","Postincrement, it--");
 
         which_lib::list<int> list { 1, 2, 3, 4, 5 };
         int expected[]{5, 4, 3, 2, 1};
@@ -733,10 +873,10 @@ past_last = list.erase( std::next(list.begin(),2) );
             it--;
             EXPECT_EQ( *it, e );
         }
-    }
+    };
 
+    TEST_CASE(tm2, "operator*()"," x = *it1")
     {
-        BEGIN_TEST(tm2, "operator*()"," x = *it1");
 
         which_lib::list<int> list { 1, 2, 3, 4, 5, 6 };
 
@@ -744,17 +884,33 @@ past_last = list.erase( std::next(list.begin(),2) );
         int i{1};
         while( it != list.end() )
             EXPECT_EQ( *it++ , i++ );
-    }
+    };
+
+    TEST_CASE(tm2, "const_iterator(iterator)", "an iterator converts to a const_iterator to the same element")
+    {
+        which_lib::list<int> list_a{ 1, 2, 3 };
+        which_lib::list<int> list_b{ 8, 9 };
+
+        which_lib::list<int>::const_iterator cit = std::next( list_a.begin() );
+        EXPECT_EQ( *cit, 2 );
+        EXPECT_EQ( cit, std::next( list_a.cbegin() ) );
+        // A mutable iterator is accepted where a const_iterator is expected.
+        list_a.splice( list_a.begin(), list_b );
+        EXPECT_EQ( list_a, ( which_lib::list<int>{ 8, 9, 1, 2, 3 } ) );
+    };
 
     std::cout << std::endl;
+    run( tm2 );
     tm2.summary();
 
     //=== TESTING UTILITY METHODS
     
     TestManager tm3{ "Utility Operations Test Suite"};
+    for ( auto & r : reporters ) tm3.add_reporter( r );
+    tm3.set_options( options );
 
+    TEST_CASE(tm3, "Merge 1","merging two interwoven regular sorted lists.")
     {
-        BEGIN_TEST(tm3, "Merge 1","merging two interwoven regular sorted lists.");
         which_lib::list<int> list_a{ 0, 1, 3, 5, 7, 9 };        // List A
         which_lib::list<int> list_b{ 2, 4, 6, 8 };              // List B
         which_lib::list<int> list_r{ 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 }; // List Result
@@ -762,9 +918,9 @@ past_last = list.erase( std::next(list.begin(),2) );
         list_a.merge( list_b ); // Merger B into A.
         EXPECT_EQ( list_r, list_a ); // List A must be equal to list Result.
         EXPECT_TRUE( list_b.empty() ); // List B must be empty (all nodes moved to A).
-    }
+    };
+    TEST_CASE(tm3, "Merge 2","merging two sequential regular sorted lists.")
     {
-        BEGIN_TEST(tm3, "Merge 2","merging two sequential regular sorted lists.");
         which_lib::list<int> list_a{ 0, 1, 2, 3, 4, 5 };        // List A
         which_lib::list<int> list_b{ 6, 7, 8, 9 };              // List B
         which_lib::list<int> list_r{ 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 }; // List Result
@@ -772,9 +928,9 @@ past_last = list.erase( std::next(list.begin(),2) );
         list_a.merge( list_b ); // Merger B into A.
         EXPECT_EQ( list_r, list_a ); // List A must be equal to list Result.
         EXPECT_TRUE( list_b.empty() ); // List B must be empty (all nodes moved to A).
-    }
+    };
+    TEST_CASE(tm3, "Merge 3","merging two sequential (inverse) regular sorted lists.")
     {
-        BEGIN_TEST(tm3, "Merge 3","merging two sequential (inverse) regular sorted lists.");
         which_lib::list<int> list_a{ 4, 5, 6, 7, 8, 9 };        // List A
         which_lib::list<int> list_b{ 0, 1, 2, 3 };              // List B
         which_lib::list<int> list_r{ 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 }; // List Result
@@ -782,9 +938,9 @@ past_last = list.erase( std::next(list.begin(),2) );
         list_a.merge( list_b ); // Merger B into A.
         EXPECT_EQ( list_r, list_a ); // List A must be equal to list Result.
         EXPECT_TRUE( list_b.empty() ); // List B must be empty (all nodes moved to A).
-    }
+    };
+    TEST_CASE(tm3, "Merge 4","merging an empty list into a sorted list.")
     {
-        BEGIN_TEST(tm3, "Merge 4","merging an empty list into a sorted list.");
         which_lib::list<int> list_a;        // List A
         which_lib::list<int> list_b{ 0, 1, 2, 3 };              // List B
         which_lib::list<int> list_r{ 0, 1, 2, 3 }; // List Result
@@ -792,9 +948,9 @@ past_last = list.erase( std::next(list.begin(),2) );
         list_a.merge( list_b ); // Merger B into A.
         EXPECT_EQ( list_r, list_a ); // List A must be equal to list Result.
         EXPECT_TRUE( list_b.empty() ); // List B must be empty (all nodes moved to A).
-    }
+    };
+    TEST_CASE(tm3, "Merge 5","merging a sorted list into an empty list.")
     {
-        BEGIN_TEST(tm3, "Merge 5","merging a sorted list into an empty list.");
         which_lib::list<int> list_a;        // List A
         which_lib::list<int> list_b{ 0, 1, 2, 3 };              // List B
         which_lib::list<int> list_r{ 0, 1, 2, 3 }; // List Result
@@ -802,9 +958,9 @@ past_last = list.erase( std::next(list.begin(),2) );
         list_a.merge( list_b ); // Merger B into A.
         EXPECT_EQ( list_r, list_a ); // List A must be equal to list Result.
         EXPECT_TRUE( list_b.empty() ); // List B must be empty (all nodes moved to A).
-    }
+    };
+    TEST_CASE(tm3, "Merge 6","merging sorted list with same value.")
     {
-        BEGIN_TEST(tm3, "Merge 6","merging sorted list with same value.");
         which_lib::list<int> list_a{ 1, 1, 1 };        // List A
         which_lib::list<int> list_b{ 1, 1, 1, 1 };              // List B
         which_lib::list<int> list_r{ 1, 1, 1, 1, 1, 1, 1 }; // List Result
@@ -812,10 +968,18 @@ past_last = list.erase( std::next(list.begin(),2) );
         list_a.merge( list_b ); // Merger B into A.
         EXPECT_EQ( list_r, list_a ); // List A must be equal to list Result.
         EXPECT_TRUE( list_b.empty() ); // List B must be empty (all nodes moved to A).
-    }
+    };
+    TEST_CASE(tm3, "Merge 7","merging a list into itself does nothing.")
+    {
+        which_lib::list<int> list_a{ 1, 3, 5 };        // List A
+        which_lib::list<int> list_r{ 1, 3, 5 }; // List Result
+
+        list_a.merge( list_a );
+        EXPECT_EQ( list_r, list_a ); // List A must be unchanged.
+    };
 
+    TEST_CASE(tm3, "Splice 1","splicing at the beginning.")
     {
-        BEGIN_TEST(tm3, "Splice 1","splicing at the beginning.");
         which_lib::list<int> list_a{ 1, 2, 3, 4, 5 };              // List B
         which_lib::list<int> list_b{ 10, 20, 30 };        // List A
         which_lib::list<int> list_r{ 10, 20, 30, 1, 2, 3, 4, 5 }; // List Result
@@ -824,9 +988,9 @@ past_last = list.erase( std::next(list.begin(),2) );
         list_a.splice( where, list_b ); // Merger B into A.
         EXPECT_EQ( list_r, list_a ); // List A must be equal to list Result.
         EXPECT_TRUE( list_b.empty() ); // List B must be empty (all nodes moved to A).
-    }
+    };
+    TEST_CASE(tm3, "Splice 2","splicing at the end.")
     {
-        BEGIN_TEST(tm3, "Splice 2","splicing at the end.");
         which_lib::list<int> list_a{ 1, 2, 3, 4, 5 };              // List B
         which_lib::list<int> list_b{ 10, 20, 30 };        // List A
         which_lib::list<int> list_r{ 1, 2, 3, 4, 5, 10, 20, 30 }; // List Result
@@ -835,9 +999,9 @@ past_last = list.erase( std::next(list.begin(),2) );
         list_a.splice( where, list_b ); // Merger B into A.
         EXPECT_EQ( list_r, list_a ); // List A must be equal to list Result.
         EXPECT_TRUE( list_b.empty() ); // List B must be empty (all nodes moved to A).
-    }
+    };
+    TEST_CASE(tm3, "Splice 3", "splicing at the middle.")
     {
-        BEGIN_TEST(tm3, "Splice 3", "splicing at the middle.");
         which_lib::list<int> list_a{ 1, 2, 3, 4, 5 };              // List B
         which_lib::list<int> list_b{ 10, 20, 30 };        // List A
         which_lib::list<int> list_r{ 1, 2, 10, 20, 30, 3, 4, 5 }; // List Result
@@ -847,9 +1011,9 @@ past_last = list.erase( std::next(list.begin(),2) );
         list_a.splice( where, list_b ); // Merger B into A.
         EXPECT_EQ( list_r, list_a ); // List A must be equal to list Result.
         EXPECT_TRUE( list_b.empty() ); // List B must be empty (all nodes moved to A).
-    }
+    };
+    TEST_CASE(tm3, "Splice 4", "splicing an empty list into another list.")
     {
-        BEGIN_TEST(tm3, "Splice 4", "splicing an empty list into another list.");
         which_lib::list<int> list_a{ 1, 2, 3, 4, 5 };              // List B
         which_lib::list<int> list_b;        // List A
         which_lib::list<int> list_r{ 1, 2, 3, 4, 5 }; // List Result
@@ -859,9 +1023,9 @@ past_last = list.erase( std::next(list.begin(),2) );
         list_a.splice( where, list_b ); // Merger B into A.
         EXPECT_EQ( list_r, list_a ); // List A must be equal to list Result.
         EXPECT_TRUE( list_b.empty() ); // List B must be empty (all nodes moved to A).
-    }
+    };
+    TEST_CASE(tm3, "Splice 5", "splicing an empty list into another list.")
     {
-        BEGIN_TEST(tm3, "Splice 5", "splicing an empty list into another list.");
         which_lib::list<int> list_a{ 1, 2, 3, 4 };              // List B
         which_lib::list<int> list_a_backup{ 1, 2, 3, 4 };              // List B
         which_lib::list<int> list_r[] {
@@ -886,10 +1050,10 @@ past_last = list.erase( std::next(list.begin(),2) );
             EXPECT_TRUE( list_b.empty() );          // List B must be empty (all nodes moved to A).
             ++i;
         }
-    }
+    };
 
+    TEST_CASE(tm3, "Reverse 1", "reverse a regular list.")
     {
-        BEGIN_TEST(tm3, "Reverse 1", "reverse a regular list.");
         which_lib::list<int> list_a{ 1, 2, 3, 4, 5 };              // List B
         which_lib::list<int> list_r{ 5, 4, 3, 2, 1 }; // List Result
 
@@ -902,27 +1066,40 @@ past_last = list.erase( std::next(list.begin(),2) );
         *add_last = 10;
         which_lib::list<int> list_r2{ 50, 4, 3, 2, 10 }; // List Result
         EXPECT_EQ( list_r2, list_a ); // List A must be equal to list Result.
-    }
+    };
+    TEST_CASE(tm3, "Reverse 2", "reversing a single element list.")
     {
-        BEGIN_TEST(tm3, "Reverse 2", "reversing a single element list.");
         which_lib::list<int> list_a{ 1 };              // List B
         which_lib::list<int> list_r{ 1 }; // List Result
 
         list_a.reverse();
         EXPECT_EQ( list_r, list_a ); // List A must be equal to list Result.
-    }
+    };
+    TEST_CASE(tm3, "Reverse 3", "reversing an empty list.")
     {
-        BEGIN_TEST(tm3, "Reverse 3", "reversing an empty list.");
         which_lib::list<int> list_a{ 1 };              // List B
         which_lib::list<int> list_r{ 1 }; // List Result
 
         list_a.reverse();
         EXPECT_EQ( list_r, list_a ); // List A must be equal to list Result.
-    }
+    };
+    TEST_CASE(tm3, "Reverse 4", "iterators follow their elements through a reverse.")
+    {
+        which_lib::list<int> list_a{ 1, 2, 3, 4 };
+        auto first{ list_a.begin() };               // Points to 1.
+        auto second{ std::next( list_a.begin() ) }; // Points to 2.
+
+        list_a.reverse();
+        EXPECT_EQ( list_a, ( which_lib::list<int>{ 4, 3, 2, 1 } ) );
+        EXPECT_EQ( *first, 1 );
+        EXPECT_EQ( std::next( first ), list_a.end() ); // 1 is now the last element.
+        EXPECT_EQ( *std::next( second ), 1 );
+        EXPECT_EQ( *std::prev( second ), 3 );
+    };
 
 
+    TEST_CASE(tm3, "Unique 1", "unique on a regular list.")
     {
-        BEGIN_TEST(tm3, "Unique 1", "unique on a regular list.");
         which_lib::list<int> list_a{ 1, 2, 2, 3, 3, 2, 1, 1, 2 };              // List B
         which_lib::list<int> list_r{ 1, 2, 3, 2, 1, 2 }; // List Result
 
@@ -935,10 +1112,10 @@ past_last = list.erase( std::next(list.begin(),2) );
         *add_last = 20;
         which_lib::list<int> list_r2{ 10, 2, 3, 2, 1, 20 }; // List Result
         EXPECT_EQ( list_r2, list_a ); // List A must be equal to list Result.
-    }
+    };
 
+    TEST_CASE(tm3, "Unique 2", "all equal to a single value.")
     {
-        BEGIN_TEST(tm3, "Unique 2", "all equal to a single value.");
         which_lib::list<int> list_a{ 1, 1, 1, 1, 1 };              // List B
         which_lib::list<int> list_r{ 1 }; // List Result
 
@@ -949,9 +1126,9 @@ past_last = list.erase( std::next(list.begin(),2) );
         *add_first = 10; // Iterators must remain valid.
         which_lib::list<int> list_r2{ 10}; // List Result
         EXPECT_EQ( list_r2, list_a ); // List A must be equal to list Result.
-    }
+    };
+    TEST_CASE(tm3, "Unique 3", "list have already only unique elements.")
     {
-        BEGIN_TEST(tm3, "Unique 3", "list have already only unique elements.");
         which_lib::list<int> list_a{ 1, 2, 3, 4, 5 };              // List B
         which_lib::list<int> list_r{ 1, 2, 3, 4, 5 }; // List Result
 
@@ -962,18 +1139,28 @@ past_last = list.erase( std::next(list.begin(),2) );
         *add_first = 10; // Iterators must remain valid.
         which_lib::list<int> list_r2{ 10, 2, 3, 4, 5}; // List Result
         EXPECT_EQ( list_r2, list_a ); // List A must be equal to list Result.
-    }
+    };
+    TEST_CASE(tm3, "Unique 4", "unique on an empty list.")
     {
-        BEGIN_TEST(tm3, "Unique 4", "unique on an empty list.");
         which_lib::list<int> list_a{ };              // List B
         which_lib::list<int> list_r{ }; // List Result
 
         list_a.unique();
         EXPECT_EQ( list_r, list_a ); // List A must be equal to list Result.
-    }
+    };
+    TEST_CASE(tm3, "Unique 5", "unique keeps the first and last elements of the list.")
+    {
+        which_lib::list<int> list_a{ 1, 1, 2, 3, 3 };
+        which_lib::list<int> list_r{ 1, 2, 3 }; // List Result
 
+        list_a.unique();
+        EXPECT_EQ( list_r, list_a ); // List A must be equal to list Result.
+        EXPECT_EQ( list_a.size(), 3u );
+        EXPECT_EQ( list_a.back(), 3 );
+    };
+
+    TEST_CASE(tm3, "Sort 1", "sorting a regular list.")
     {
-        BEGIN_TEST(tm3, "Sort 1", "sorting a regular list.");
         which_lib::list<int> list_a{ 4, 2, 1, 5, 3 };              // List B
         which_lib::list<int> list_r{ 1, 2, 3, 4, 5 }; // List Result
 
@@ -986,9 +1173,9 @@ past_last = list.erase( std::next(list.begin(),2) );
         *add_last = 50;
         which_lib::list<int> list_r2{ 10, 2, 3, 4, 50 }; // List Result
         EXPECT_EQ( list_r2, list_a ); // List A must be equal to list Result.
-    }
+    };
+    TEST_CASE(tm3, "Sort 2", "sorting an already sorted list.")
     {
-        BEGIN_TEST(tm3, "Sort 2", "sorting an already sorted list.");
         which_lib::list<int> list_a{ 1, 2, 3, 4, 5 };              // List B
         which_lib::list<int> list_r{ 1, 2, 3, 4, 5 }; // List Result
 
@@ -1001,17 +1188,17 @@ past_last = list.erase( std::next(list.begin(),2) );
         *add_last = 50;
         which_lib::list<int> list_r2{ 10, 2, 3, 4, 50 }; // List Result
         EXPECT_EQ( list_r2, list_a ); // List A must be equal to list Result.
-    }
+    };
+    TEST_CASE(tm3, "Sort 3", "sorting an empty list.")
     {
-        BEGIN_TEST(tm3, "Sort 3", "sorting an empty list.");
         which_lib::list<int> list_a{  };              // List B
         which_lib::list<int> list_r{  }; // List Result
 
         list_a.sort();
         EXPECT_EQ( list_r, list_a ); // List A must be equal to list Result.
-    }
+    };
+    TEST_CASE(tm3, "Sort 4", "testing stability of the sorting algorithm.")
     {
-        BEGIN_TEST(tm3, "Sort 4", "testing stability of the sorting algorithm.");
         struct Card{
             int value; std::string face;
             // Default comparator for Card type.
@@ -1056,11 +1243,933 @@ past_last = list.erase( std::next(list.begin(),2) );
             { 10, "spades" },
         };
         EXPECT_EQ( list_r2, list_a ); // List A must be equal to list Result.
-    }
+    };
+    // Timed, so it runs alone: tests running beside it would skew the clock.
+    SERIAL_TEST_CASE(tm3, "Sort 5", "sorting takes O(n log n) time.")
+    {
+        std::vector< size_t > sizes{ 1000, 2000, 4000, 8000, 16000, 32000 };
+        auto sort_n = []( size_t n ) {
+            which_lib::list<int> list_a;
+            unsigned x{ 12345 };
+            for ( size_t i{0}; i < n; ++i ) {
+                x = x * 1103515245u + 12345u;
+                list_a.push_back( static_cast<int>( x >> 8 ) );
+            }
+            list_a.sort();
+        };
+        EXPECT_COMPLEXITY( sort_n, sizes, O_N_LOG_N );
+
+        // 100000 elements sort in under 100 ms unoptimized; a quadratic sort would take minutes.
+        sc::list<int> list_b;
+        unsigned x{ 54321 };
+        for ( size_t i{0}; i < 100000; ++i ) {
+            x = x * 1103515245u + 12345u;
+            list_b.push_back( static_cast<int>( x >> 8 ) );
+        }
+        EXPECT_FASTER_THAN( list_b.sort(), 1e9 );
+        EXPECT_TRUE( std::is_sorted( list_b.begin(), list_b.end() ) );
+    };
+
+    TEST_CASE(tm3, "Find", "find, contains and count on a regular list.")
+    {
+        sc::list<int> list_a{ 4, 2, 7, 2, 9, 2 };
+
+        auto it = list_a.find( 7 );
+        EXPECT_EQ( it, std::next( list_a.begin(), 2 ) );
+        EXPECT_EQ( list_a.find( 5 ), list_a.end() );
+        EXPECT_TRUE( list_a.contains( 9 ) );
+        EXPECT_FALSE( list_a.contains( 1 ) );
+        EXPECT_EQ( list_a.count( 2 ), 3 );
+        EXPECT_EQ( list_a.count( 8 ), 0 );
+
+        sc::list<int> list_b;
+        EXPECT_EQ( list_b.find( 1 ), list_b.end() );
+        EXPECT_EQ( list_b.count( 1 ), 0 );
+    };
+    TEST_CASE(tm3, "MinMax", "min and max return the first extreme element.")
+    {
+        sc::list<int> list_a{ 4, 1, 7, 1, 9, 9, 3 };
+
+        EXPECT_EQ( list_a.min(), std::next( list_a.cbegin(), 1 ) );
+        EXPECT_EQ( list_a.max(), std::next( list_a.cbegin(), 4 ) );
+
+        const sc::list<int> list_b;
+        EXPECT_EQ( list_b.min(), list_b.cend() );
+        EXPECT_EQ( list_b.max(), list_b.cend() );
+    };
+    TEST_CASE(tm3, "Accumulate", "summing up the elements of a list.")
+    {
+        sc::list<int> list_a{ 1, 2, 3, 4, 5 };
+
+        EXPECT_EQ( list_a.accumulate( 0 ), 15 );
+        EXPECT_EQ( list_a.accumulate( 10L ), 25L );
+        EXPECT_EQ( sc::list<int>{}.accumulate( 7 ), 7 );
+    };
+    TEST_CASE(tm3, "Allocations", "splice, merge and sort move nodes without allocating.")
+    {
+        which_lib::list<int> list_a{ 1, 3, 5 };
+        which_lib::list<int> list_b{ 2, 4, 6 };
+        which_lib::list<int> list_c{ 7, 8 };
+        EXPECT_ALLOCS_LE( list_a.splice( list_a.cend(), list_c ), 0 );
+        EXPECT_ALLOCS_LE( list_a.merge( list_b ), 0 );
+        EXPECT_ALLOCS_LE( list_a.reverse(), 0 );
+        EXPECT_ALLOCS_LE( list_a.sort(), 0 );
+        EXPECT_ALLOCS_LE( list_a.push_back( 9 ), 1 );
+        EXPECT_EQ( list_a, ( which_lib::list<int>{ 1, 2, 3, 4, 5, 6, 7, 8, 9 } ) );
+        EXPECT_TRUE( list_b.empty() );
+        EXPECT_TRUE( list_c.empty() );
+        EXPECT_NO_LEAK( which_lib::list<int> list_d{ 1, 2, 3 }; list_d.clear(); list_d.push_back( 4 ) );
+    };
+
+    // Resets the global registry, which the other counting_stats tests also write to.
+    SERIAL_TEST_CASE(tm3, "Stats", "counting nodes, copies and calls of an instrumented list.")
+    {
+        sc::stats_registry::global().reset();
+        {
+            sc::list<int, sc::counting_stats> list_a{ 1, 2, 3 };
+            list_a.push_back( 4 );
+            list_a.push_front( 0 );
+            list_a.pop_back();
+            list_a.erase( list_a.begin() );
+            EXPECT_TRUE( list_a.contains( 3 ) );
+
+            sc::list_stats s = list_a.stats();
+            EXPECT_EQ( s.node_allocs, 7 );   // Two sentinels and five elements.
+            EXPECT_EQ( s.node_frees, 2 );
+            EXPECT_EQ( s.element_copies, 5 );
+            EXPECT_EQ( s[ sc::list_op::CONSTRUCT ], 1 );
+            EXPECT_EQ( s[ sc::list_op::PUSH_BACK ], 1 );
+            EXPECT_EQ( s[ sc::list_op::PUSH_FRONT ], 1 );
+            EXPECT_EQ( s[ sc::list_op::POP_BACK ], 1 );
+            EXPECT_EQ( s[ sc::list_op::ERASE ], 1 );
+            EXPECT_EQ( s[ sc::list_op::FIND ], 1 );
+            EXPECT_EQ( s.bytes_live % ( s.node_allocs - s.node_frees ), 0 );
+            EXPECT_GT( s.bytes_live, 0 );
+        }
+        sc::list_stats g = sc::stats_registry::global().snapshot();
+        EXPECT_EQ( g.node_allocs, g.node_frees );
+        EXPECT_EQ( g.bytes_live, 0 );
+
+        std::ostringstream oss;
+        sc::stats_registry::global().write_prometheus( oss );
+        EXPECT_NE( oss.str().find( "sc_list_calls_total{op=\"push_back\"} 1" ), std::string::npos );
+        EXPECT_EQ( sizeof( which_lib::list<int> ), sizeof( sc::list<int, sc::no_stats> ) );
+    };
 
     std::cout << std::endl;
+    run( tm3 );
     tm3.summary();
 
-    return 0;
+    //=== TESTING SERIALIZATION
+
+    TestManager tm4{ "Serialization Test Suite"};
+    for ( auto & r : reporters ) tm4.add_reporter( r );
+    tm4.set_options( options );
+
+    TEST_CASE(tm4, "BinaryRaw", "saving and loading a list of integers.")
+    {
+        sc::list<int> list_a;
+        for ( int i{0}; i < 300000; ++i ) // Spans several staging blocks.
+            list_a.push_back( i * 7 - 5 );
+
+        std::stringstream ss;
+        sc::save( list_a, ss );
+        sc::list<int> list_b;
+        sc::load( list_b, ss );
+        EXPECT_EQ( list_a, list_b );
+
+        // An empty list round trips as well.
+        std::stringstream ss2;
+        sc::save( sc::list<int>{}, ss2 );
+        sc::list<int> list_c{ 1, 2 };
+        sc::load( list_c, ss2 ); // Loading appends.
+        EXPECT_EQ( list_c, ( sc::list<int>{ 1, 2 } ) );
+    };
+    TEST_CASE(tm4, "BinaryLarge", "saving and loading elements larger than the staging buffer.")
+    {
+        struct big { int first; char fill[ 3 << 19 ]; int last; }; // 1.5 MiB.
+        std::vector<big> items( 3 ); // On the heap; too big for the stack.
+        for ( int i{0}; i < 3; ++i ) {
+            items[i].first = i;
+            items[i].last = -i;
+        }
+        sc::list<big> list_a( items.begin(), items.end() );
+
+        std::stringstream ss;
+        sc::save( list_a, ss );
+        sc::list<big> list_b;
+        sc::load( list_b, ss );
+        EXPECT_EQ( list_b.size(), 3u );
+        int i{0};
+        for ( const big & b : list_b ) {
+            EXPECT_EQ( b.first, i );
+            EXPECT_EQ( b.last, -i );
+            ++i;
+        }
+    };
+    TEST_CASE(tm4, "BinaryCodec", "saving and loading a list of strings.")
+    {
+        sc::list<std::string> list_a{ "alpha", "", "gamma", std::string( 5000, 'x' ) };
+
+        std::stringstream ss;
+        sc::save( list_a, ss );
+        sc::list<std::string> list_b;
+        sc::load( list_b, ss );
+        EXPECT_EQ( list_a, list_b );
+    };
+    TEST_CASE(tm4, "BinaryCorrupt", "rejecting corrupted or mismatched snapshots.")
+    {
+        sc::list<int> list_a{ 1, 2, 3, 4, 5 };
+        std::stringstream ss;
+        sc::save( list_a, ss );
+        std::string bytes = ss.str();
+
+        // Flip one payload bit.
+        std::string corrupt{ bytes };
+        corrupt[ corrupt.size() - 12 ] ^= 0x10;
+        std::stringstream ss2{ corrupt };
+        sc::list<int> list_b{ 9 };
+        bool thrown{ false };
+        try { sc::load( list_b, ss2 ); } catch ( const sc::list_io_error & ) { thrown = true; }
+        EXPECT_TRUE( thrown );
+        EXPECT_EQ( list_b, ( sc::list<int>{ 9 } ) ); // A failed load leaves the list as it was.
+
+        // Wrong element type.
+        std::stringstream ss3{ bytes };
+        sc::list<long long> list_c;
+        thrown = false;
+        try { sc::load( list_c, ss3 ); } catch ( const sc::list_io_error & ) { thrown = true; }
+        EXPECT_TRUE( thrown );
+
+        // Truncated file.
+        std::stringstream ss4{ bytes.substr( 0, bytes.size() - 3 ) };
+        sc::list<int> list_d;
+        thrown = false;
+        try { sc::load( list_d, ss4 ); } catch ( const sc::list_io_error & ) { thrown = true; }
+        EXPECT_TRUE( thrown );
+        EXPECT_TRUE( list_d.empty() );
+
+        // A string length far beyond the end of the snapshot, right after the 27 byte header.
+        std::stringstream ss5;
+        sc::save( sc::list<std::string>{ "abc" }, ss5 );
+        std::string huge{ ss5.str() };
+        const std::uint64_t bogus{ std::uint64_t{1} << 62 };
+        std::memcpy( &huge[27], &bogus, sizeof( bogus ) );
+        std::stringstream ss6{ huge };
+        sc::list<std::string> list_e;
+        thrown = false;
+        try { sc::load( list_e, ss6 ); } catch ( const sc::list_io_error & ) { thrown = true; }
+        EXPECT_TRUE( thrown );
+        EXPECT_TRUE( list_e.empty() );
+    };
+
+    TEST_CASE(tm4, "MappedList", "a mapped list keeps its contents across reopening.")
+    {
+        const std::string path{ "sc_mapped_list_test.bin" };
+        std::remove( path.c_str() );
+        size_t grown_size{0};
+        {
+            sc::mapped_list<int> list_a{ path };
+            EXPECT_TRUE( list_a.empty() );
+            for ( int i{0}; i < 20000; ++i ) // Forces the file to grow several times.
+                list_a.push_back( i );
+            list_a.push_front( -1 );
+            list_a.erase( std::next( list_a.begin(), 2 ) );  // Removes 1.
+            list_a.insert( std::next( list_a.begin(), 2 ), { 100, 101 } );
+            EXPECT_EQ( list_a.size(), 20002 );
+            list_a.sync();
+            grown_size = list_a.file_size();
+        }
+        {
+            sc::mapped_list<int> list_b{ path };
+            EXPECT_EQ( list_b.size(), 20002 );
+            EXPECT_EQ( list_b.front(), -1 );
+            EXPECT_EQ( list_b.back(), 19999 );
+            int expected[]{ -1, 0, 100, 101, 2, 3 };
+            auto it = list_b.cbegin();
+            for ( const auto & e : expected )
+                EXPECT_EQ( *it++, e );
+
+            // Erased nodes are recycled before the file grows again.
+            list_b.clear();
+            EXPECT_TRUE( list_b.empty() );
+            for ( int i{0}; i < 20000; ++i )
+                list_b.push_front( i );
+            EXPECT_EQ( list_b.file_size(), grown_size );
+            EXPECT_EQ( list_b.front(), 19999 );
+            list_b.pop_front();
+            list_b.pop_back();
+            EXPECT_EQ( list_b.size(), 19998 );
+            EXPECT_EQ( list_b.back(), 1 );
+        }
+        // A file created for another element type is rejected.
+        bool thrown{ false };
+        try { sc::mapped_list<double> list_c{ path }; } catch ( const std::runtime_error & ) { thrown = true; }
+        EXPECT_TRUE( thrown );
+        std::remove( path.c_str() );
+    };
+
+    TEST_CASE(tm4, "MappedListLarge", "a mapped list grows to fit elements larger than its file.")
+    {
+        struct big { char bytes[ 200 * 1024 ]; };
+        const std::string path{ "sc_mapped_list_large.bin" };
+        std::remove( path.c_str() );
+        {
+            sc::mapped_list<big> list_a{ path };
+            big b;
+            for ( int i{0}; i < 3; ++i ) {
+                std::memset( b.bytes, 'a' + i, sizeof( b.bytes ) );
+                list_a.push_back( b );
+            }
+            EXPECT_GE( list_a.file_size(), 3 * sizeof( big ) );
+            EXPECT_EQ( list_a.back().bytes[ sizeof( b.bytes ) - 1 ], 'c' );
+        }
+        {
+            sc::mapped_list<big> list_b{ path };
+            EXPECT_EQ( list_b.size(), 3 );
+            EXPECT_EQ( list_b.front().bytes[ 0 ], 'a' );
+            EXPECT_EQ( list_b.back().bytes[ sizeof( big ) - 1 ], 'c' );
+        }
+        std::remove( path.c_str() );
+    };
+
+    TEST_CASE(tm4, "MappedListUtility", "sort, merge, splice, reverse and unique on mapped lists, and their locks.")
+    {
+        const std::string path_a{ "sc_mapped_list_a.bin" }, path_b{ "sc_mapped_list_b.bin" };
+        std::remove( path_a.c_str() );
+        std::remove( path_b.c_str() );
+        {
+            sc::mapped_list<int> list_a{ path_a };
+            sc::mapped_list<int> list_b{ path_b };
+            list_a.assign( { 5, 1, 4, 1, 3 } );
+            auto four = std::next( list_a.cbegin(), 2 );
+            list_a.sort();
+            EXPECT_EQ( *four, 4 ); // Nodes are relinked, so iterators follow their elements.
+            list_b.assign( { 2, 4, 6 } );
+            list_a.merge( list_b );
+            EXPECT_TRUE( list_b.empty() );
+            list_a.unique();
+            list_b.assign( { 9, 8 } );
+            list_a.splice( list_a.cend(), list_b );
+            list_a.reverse();
+            auto it = list_a.cbegin();
+            it += 3;
+            EXPECT_EQ( *it, 5 );
+            it -= 1;
+            EXPECT_EQ( *it, 6 );
+            list_b.assign( { 8, 9, 6, 5, 4, 3, 2, 1 } );
+            EXPECT_EQ( list_a, list_b );
+            list_b.pop_front();
+            EXPECT_NE( list_a, list_b );
+
+            // One list per file, in this process or any other.
+            bool thrown{ false };
+            try { sc::mapped_list<int> again{ path_a }; } catch ( const std::system_error & ) { thrown = true; }
+            EXPECT_TRUE( thrown );
+        }
+        // A file left larger than its header says, as by a crash while growing, still opens.
+        {
+            std::ofstream extend{ path_a, std::ios::binary | std::ios::app };
+            extend << std::string( 4096, '\0' );
+        }
+        {
+            sc::mapped_list<int> list_a{ path_a };
+            EXPECT_EQ( list_a.size(), 8 );
+            EXPECT_EQ( list_a.front(), 8 );
+        }
+        std::remove( path_a.c_str() );
+        std::remove( path_b.c_str() );
+    };
+
+    TEST_CASE(tm4, "ParseList", "parsing whitespace separated numbers.")
+    {
+        EXPECT_EQ( sc::parse_list<int>( " 1 -2\t+3\n\n40  " ), ( sc::list<int>{ 1, -2, 3, 40 } ) );
+        EXPECT_TRUE( sc::parse_list<int>( "  \n " ).empty() );
+        EXPECT_EQ( sc::parse_list<double>( "0.5 -1e3" ), ( sc::list<double>{ 0.5, -1000.0 } ) );
+
+        bool thrown{ false };
+        try { sc::parse_list<int>( "1 2 x3 4" ); }
+        catch ( const sc::list_parse_error & e ) { thrown = ( e.offset() == 4 ); }
+        EXPECT_TRUE( thrown );
+        thrown = false;
+        try { sc::parse_list<signed char>( "1 300" ); } catch ( const sc::list_parse_error & ) { thrown = true; }
+        EXPECT_TRUE( thrown );
+        // A single sign only: "+-5" and "++5" are not numbers.
+        for ( const char * text : { "1 +-5", "1 ++5", "1 +-1e400" } ) {
+            thrown = false;
+            try { sc::parse_list<double>( text ); }
+            catch ( const sc::list_parse_error & e ) { thrown = ( e.offset() == 2 and std::string{ e.what() }.find( "invalid" ) != std::string::npos ); }
+            EXPECT_TRUE( thrown );
+        }
+        thrown = false;
+        try { sc::parse_list<int>( "+-5" ); } catch ( const sc::list_parse_error & ) { thrown = true; }
+        EXPECT_TRUE( thrown );
+    };
+    TEST_CASE(tm4, "FormatList", "formatting a list and parsing it back.")
+    {
+        sc::list<int> list_a{ 1, -2, 30 };
+        std::string out{ "> " };
+        sc::format_list( list_a, out );
+        EXPECT_EQ( out, std::string{ "> 1 -2 30" } );
+
+        // Large enough to cross the stream buffer boundaries in both directions.
+        sc::list<long> list_b;
+        for ( long i{0}; i < 300000; ++i )
+            list_b.push_back( i * 1000003 - 77 );
+        std::stringstream ss;
+        sc::format_list( list_b, ss, '\n' );
+        EXPECT_EQ( sc::parse_list<long>( ss ), list_b );
+        std::string text;
+        sc::format_list( list_b, text );
+        EXPECT_EQ( sc::parse_list<long>( text ), list_b );
+    };
+
+    std::cout << std::endl;
+    run( tm4 );
+    tm4.summary();
+
+    //=== TESTING THE TEST MANAGER ITSELF
+
+    TestManager tm5{ "Test Manager Test Suite"};
+    for ( auto & r : reporters ) tm5.add_reporter( r );
+    tm5.set_options( options );
+
+    TEST_CASE(tm5, "Isolation", "crashes and hangs are isolated in child processes.")
+    {
+        // Keeps the status of every result it receives.
+        struct StatusReporter : Reporter {
+            std::vector< TestReport::status_t > statuses;
+            void on_test_end( const TestReport & r ) override { statuses.push_back( r.status ); }
+        };
+        auto reporter = std::make_shared< StatusReporter >();
+        TestManager inner{ "Isolated" };
+        inner.add_reporter( reporter );
+        TEST_CASE(inner, "Passes", "passes.") { EXPECT_TRUE( true ); };
+        TEST_CASE(inner, "Crashes", "crashes.") { EXPECT_TRUE( true ); std::abort(); };
+        TEST_CASE(inner, "Hangs", "hangs.") { EXPECT_TRUE( true ); for ( volatile bool forever{true}; forever; ) {} };
+        inner.run_isolated( 3, 500 );
+
+        std::sort( reporter->statuses.begin(), reporter->statuses.end() );
+        EXPECT_EQ( reporter->statuses.size(), 3 );
+        EXPECT_EQ( reporter->statuses, ( std::vector< TestReport::status_t >{ TestReport::status_t::PASSED,
+                     TestReport::status_t::CRASHED, TestReport::status_t::TIMEOUT } ) );
+        EXPECT_FALSE( inner.all_passed() );
+    };
+
+    TEST_CASE(tm5, "Heap", "allocations, frees and leaks are counted per test.")
+    {
+        if ( not TestManager::tracks_allocs() )
+        {
+            DISABLE();
+            return;
+        }
+        // Keeps every result it receives, by name.
+        struct HeapReporter : Reporter {
+            std::map< std::string, TestReport > reports;
+            void on_test_end( const TestReport & r ) override { reports[ r.name ] = r; }
+        };
+        auto reporter = std::make_shared< HeapReporter >();
+        int * leaked{ nullptr };
+        TestManager inner{ "Heap" };
+        inner.add_reporter( reporter );
+        TEST_CASE(inner, "Leaks", "leaks an int.") { leaked = new int{ 42 }; EXPECT_TRUE( true ); };
+        TEST_CASE(inner, "Allocates", "allocates more than it may.") { EXPECT_ALLOCS_LE( std::vector<int>( 8 ), 0 ); };
+        TEST_CASE(inner, "Frees", "frees what it allocates.") { EXPECT_NO_LEAK( std::vector<int> v( 8 ) ); };
+        inner.run( 1 );
+        delete leaked;
+
+        const TestReport & leaks = reporter->reports[ "Leaks" ];
+        EXPECT_TRUE( leaks.heap_tracked );
+        EXPECT_EQ( leaks.allocs, 1 );
+        EXPECT_EQ( leaks.frees, 0 );
+        EXPECT_EQ( leaks.leaked_bytes, sizeof( int ) );
+        EXPECT_EQ( reporter->reports[ "Allocates" ].status, TestReport::status_t::FAILED );
+        EXPECT_EQ( reporter->reports[ "Frees" ].status, TestReport::status_t::PASSED );
+        EXPECT_EQ( reporter->reports[ "Frees" ].leaked_bytes, 0 );
+        EXPECT_GE( reporter->reports[ "Frees" ].peak_bytes, 8 * sizeof( int ) );
+    };
+
+    SERIAL_TEST_CASE(tm5, "HeapThreads", "a serial test counts the heap activity of the threads it starts.")
+    {
+        if ( not TestManager::tracks_allocs() )
+        {
+            DISABLE();
+            return;
+        }
+        struct HeapReporter : Reporter {
+            std::map< std::string, TestReport > reports;
+            void on_test_end( const TestReport & r ) override { reports[ r.name ] = r; }
+        };
+        auto reporter = std::make_shared< HeapReporter >();
+        int * kept{ nullptr };
+        int * leaked{ nullptr };
+        TestManager inner{ "HeapThreads" };
+        inner.add_reporter( reporter );
+        SERIAL_TEST_CASE(inner, "FreedElsewhere", "frees on another thread.") {
+            int * p = new int{ 1 };
+            std::thread{ [p] { delete p; } }.join();
+            EXPECT_TRUE( true );
+        };
+        SERIAL_TEST_CASE(inner, "KeptByThread", "a thread keeps a block.") {
+            std::thread{ [&kept] { kept = new int{ 2 }; } }.join();
+            EXPECT_TRUE( true );
+        };
+        SERIAL_TEST_CASE(inner, "Leaks", "leaks an int on its own thread.") { leaked = new int{ 3 }; EXPECT_TRUE( true ); };
+        inner.run( 1 );
+        delete kept;
+        delete leaked;
+
+        const TestReport & freed = reporter->reports[ "FreedElsewhere" ];
+        EXPECT_EQ( freed.allocs, freed.frees );
+        EXPECT_EQ( freed.leaked_bytes, 0 );
+        EXPECT_EQ( reporter->reports[ "KeptByThread" ].leaked_bytes, 0 );
+        EXPECT_EQ( reporter->reports[ "Leaks" ].leaked_bytes, sizeof( int ) );
+    };
+
+    TEST_CASE(tm5, "Handles", "assertions reach their test through a handle, without allocating.")
+    {
+        EXPECT_ALLOCS_LE( for ( int i{0}; i < 10000; ++i ) EXPECT_EQ( i, i ), 0 );
+
+        TestManager inner{ "Handles" };
+        TestManager::test_id a = inner.record( "A", "first." );
+        TestManager::test_id b = inner.record( "B", "second." );
+        EXPECT_EQ( a.index(), 0 );
+        EXPECT_EQ( b.index(), 1 );
+        EXPECT_EQ( inner.record( "A", "registered again." ).index(), 0 );
+        inner.result( a, true, __LINE__ );
+        EXPECT_TRUE( inner.all_passed() );
+        inner.result( "B", false, __LINE__ );
+        EXPECT_FALSE( inner.all_passed() );
+    };
+
+    TEST_CASE(tm5, "Selection", "filters, shards and repeats select what runs, and how many times.")
+    {
+        EXPECT_TRUE( TestManager::glob_match( "Sort*", "Sort 5" ) );
+        EXPECT_TRUE( TestManager::glob_match( "*.S?rt*", "Utility.Sort 5" ) );
+        EXPECT_TRUE( TestManager::glob_match( "*", "" ) );
+        EXPECT_FALSE( TestManager::glob_match( "Sort?", "Sort 5" ) );
+        EXPECT_FALSE( TestManager::glob_match( "*Merge", "Merge 1" ) );
+
+        // Counts the results of every test it receives, by name.
+        struct NameReporter : Reporter {
+            std::map< std::string, int > runs;
+            std::map< std::string, int > failures;
+            void on_test_end( const TestReport & r ) override {
+                ++runs[ r.name ];
+                failures[ r.name ] += r.status == TestReport::status_t::FAILED;
+            }
+        };
+        auto reporter = std::make_shared< NameReporter >();
+        TestManager inner{ "Inner" };
+        inner.add_reporter( reporter );
+        int flaky{0};
+        TEST_CASE(inner, "Sort 1", "passes.") { EXPECT_TRUE( true ); };
+        TEST_CASE(inner, "Sort 2", "passes.") { EXPECT_TRUE( true ); };
+        TEST_CASE(inner, "Merge 1", "passes.") { EXPECT_TRUE( true ); };
+        TEST_CASE(inner, "Flaky", "fails every other run.") { EXPECT_EQ( ++flaky % 2, 0 ); };
+        TestManager::options opt;
+        opt.filter = "Inner.Sort*:Flaky:-Sort 2";
+        opt.repeat = 4;
+        opt.shuffle = true;
+        inner.set_options( opt );
+        inner.run( 1 );
+        EXPECT_EQ( reporter->runs, ( std::map< std::string, int >{ { "Sort 1", 4 }, { "Flaky", 4 } } ) );
+        EXPECT_EQ( reporter->failures[ "Flaky" ], 2 );
+        EXPECT_FALSE( inner.all_passed() );
+
+        // A '-' inside a glob is part of the name; only one that starts a glob begins the negatives.
+        auto select = []( const std::string & filter )
+        {
+            auto names = std::make_shared< NameReporter >();
+            TestManager ops{ "Ops" };
+            ops.add_reporter( names );
+            for ( auto name : { "operator--()", "operator--(int)", "pop-back" } )
+                TEST_CASE(ops, name, "passes.") { EXPECT_TRUE( true ); };
+            TestManager::options o;
+            o.filter = filter;
+            ops.set_options( o );
+            ops.run( 1 );
+            std::set< std::string > ran;
+            for ( const auto & n : names->runs )
+                ran.insert( n.first );
+            return ran;
+        };
+        EXPECT_EQ( select( "operator--()" ), ( std::set< std::string >{ "operator--()" } ) );
+        EXPECT_EQ( select( "pop-*:operator--(int)" ), ( std::set< std::string >{ "pop-back", "operator--(int)" } ) );
+        EXPECT_EQ( select( "-operator--*" ), ( std::set< std::string >{ "pop-back" } ) );
+        EXPECT_EQ( select( "operator*:-*(int)" ), ( std::set< std::string >{ "operator--()" } ) );
+
+        // Every test lands in exactly one shard.
+        std::multiset< std::string > ran;
+        for ( size_t shard{0}; shard < 3; ++shard )
+        {
+            auto names = std::make_shared< NameReporter >();
+            TestManager part{ "Part" };
+            part.add_reporter( names );
+            for ( auto name : { "A", "B", "C", "D", "E" } )
+                TEST_CASE(part, name, "passes.") { EXPECT_TRUE( true ); };
+            opt = TestManager::options{};
+            opt.shard_index = shard;
+            opt.shard_count = 3;
+            part.set_options( opt );
+            part.run( 1 );
+            EXPECT_LE( names->runs.size(), 2 );
+            for ( const auto & n : names->runs )
+                ran.insert( n.first );
+        }
+        EXPECT_EQ( ran, ( std::multiset< std::string >{ "A", "B", "C", "D", "E" } ) );
+    };
+
+    // Forks, so no other test may run on another thread at the same time.
+    tm5.run( 1 );
+    std::cout << std::endl;
+    tm5.summary();
+
+    //=== TESTING THE OTHER LIST CONTAINERS
+
+    TestManager tm6{ "Container Variants Test Suite"};
+    for ( auto & r : reporters ) tm6.add_reporter( r );
+    tm6.set_options( options );
+
+    TEST_CASE(tm6, "StaticList", "a static list keeps its nodes inline and never allocates.")
+    {
+        sc::static_list<int, 4> list_a;
+        EXPECT_ALLOCS_LE( list_a.push_back( 2 ); list_a.push_front( 1 ); list_a.push_back( 4 ), 0 );
+        auto it = list_a.insert( std::next( list_a.begin(), 2 ), 3 );
+        EXPECT_EQ( *it, 3 );
+        EXPECT_TRUE( list_a.full() );
+        EXPECT_EQ( list_a, ( sc::static_list<int, 4>{ 1, 2, 3, 4 } ) );
+
+        // A full list rejects more elements and is left as it was.
+        bool thrown{ false };
+        try { list_a.push_back( 5 ); } catch ( const std::length_error & ) { thrown = true; }
+        EXPECT_TRUE( thrown );
+        thrown = false;
+        try { list_a = { 1, 2, 3, 4, 5 }; } catch ( const std::length_error & ) { thrown = true; }
+        EXPECT_TRUE( thrown );
+        EXPECT_EQ( list_a, ( sc::static_list<int, 4>{ 1, 2, 3, 4 } ) );
+
+        // Erased nodes are recycled.
+        list_a.pop_front();
+        list_a.erase( list_a.find( 3 ) );
+        list_a.push_front( 0 );
+        list_a.push_back( 5 );
+        EXPECT_EQ( list_a, ( sc::static_list<int, 4>{ 0, 2, 4, 5 } ) );
+        EXPECT_EQ( list_a.back(), 5 );
+        auto pos = list_a.begin();
+        pos += 3;
+        EXPECT_EQ( *pos, 5 );
+        pos -= 2;
+        EXPECT_EQ( *pos, 2 );
+
+        // Assigning a range counts it first, so one that does not fit changes nothing.
+        std::vector<int> too_many{ 1, 2, 3, 4, 5 };
+        thrown = false;
+        try { list_a.assign( too_many.begin(), too_many.end() ); } catch ( const std::length_error & ) { thrown = true; }
+        EXPECT_TRUE( thrown );
+        EXPECT_EQ( list_a, ( sc::static_list<int, 4>{ 0, 2, 4, 5 } ) );
+        list_a.assign( std::next( list_a.cbegin() ), std::prev( list_a.cend() ) );
+        EXPECT_EQ( list_a, ( sc::static_list<int, 4>{ 2, 4 } ) );
+        list_a.assign( too_many.begin(), too_many.begin() + 3 );
+        EXPECT_EQ( list_a, ( sc::static_list<int, 4>{ 1, 2, 3 } ) );
+        std::istringstream numbers{ "7 8" };
+        list_a.assign( std::istream_iterator<int>{ numbers }, std::istream_iterator<int>{} );
+        EXPECT_EQ( list_a, ( sc::static_list<int, 4>{ 7, 8 } ) );
+        list_a.clear();
+        EXPECT_TRUE( list_a.empty() );
+
+        // Elements with a destructor are constructed and destroyed with their nodes.
+        sc::static_list<std::string, 3> list_b{ "a", std::string( 100, 'b' ) };
+        sc::static_list<std::string, 3> list_c{ list_b };
+        list_c.push_back( "c" );
+        list_b = list_c;
+        EXPECT_EQ( list_b.size(), 3 );
+        EXPECT_EQ( list_b.back(), std::string{ "c" } );
+        list_b.erase( list_b.begin(), std::prev( list_b.end() ) );
+        EXPECT_EQ( list_b.front(), std::string{ "c" } );
+    };
+
+    TEST_CASE(tm6, "StaticListUtility", "sort, merge, splice, reverse and unique on static lists.")
+    {
+        sc::static_list<int, 16> list_a{ 5, 3, 9, 1, 3, 7 };
+        auto three = list_a.find( 3 );
+        list_a.sort();
+        EXPECT_EQ( list_a, ( sc::static_list<int, 16>{ 1, 3, 3, 5, 7, 9 } ) );
+        EXPECT_EQ( std::next( list_a.begin() ), three ); // Stable, and the nodes did not move.
+        list_a.unique();
+        list_a.reverse();
+        EXPECT_EQ( list_a, ( sc::static_list<int, 16>{ 9, 7, 5, 3, 1 } ) );
+        EXPECT_EQ( *list_a.min(), 1 );
+        EXPECT_EQ( *list_a.max(), 9 );
+        EXPECT_EQ( list_a.accumulate( 0 ), 25 );
+        EXPECT_EQ( list_a.count( 7 ), 1 );
+
+        list_a.reverse();
+        sc::static_list<int, 16> list_b{ 0, 4, 8 };
+        list_a.merge( list_b );
+        EXPECT_EQ( list_a, ( sc::static_list<int, 16>{ 0, 1, 3, 4, 5, 7, 8, 9 } ) );
+        EXPECT_TRUE( list_b.empty() );
+        sc::static_list<int, 16> list_c{ -2, -1 };
+        list_a.splice( list_a.cbegin(), list_c );
+        EXPECT_EQ( list_a.size(), 10 );
+        EXPECT_EQ( list_a.front(), -2 );
+        EXPECT_TRUE( list_c.empty() );
+
+        // Neither list changes when the result would not fit.
+        sc::static_list<int, 16> list_d{ 1, 2, 3, 4, 5, 6, 7 };
+        bool thrown{ false };
+        try { list_a.splice( list_a.cend(), list_d ); } catch ( const std::length_error & ) { thrown = true; }
+        EXPECT_TRUE( thrown );
+        EXPECT_EQ( list_a.size(), 10 );
+        EXPECT_EQ( list_d.size(), 7 );
+    };
+
+    TEST_CASE(tm6, "SmallList", "a small list allocates only past its inline nodes, and its iterators survive that.")
+    {
+        using small4 = sc::small_list<int, 4>;
+        small4 list_a;
+        EXPECT_ALLOCS_LE( for ( int i{0}; i < 4; ++i ) list_a.push_back( i ), 0 );
+        EXPECT_ALLOCS_LE( small4 list_b( list_a ); list_b.reverse(); list_b.sort(), 0 );
+        auto first = list_a.begin();
+        auto last = std::prev( list_a.end() );
+        EXPECT_ALLOCS_LE( list_a.push_back( 4 ); list_a.push_front( -1 ), 2 );
+        EXPECT_EQ( list_a.spilled(), 2 );
+        EXPECT_EQ( *first, 0 );
+        EXPECT_EQ( *last, 3 );
+        EXPECT_EQ( list_a, ( small4{ -1, 0, 1, 2, 3, 4 } ) );
+
+        // Freed slots are used again before the heap.
+        list_a.erase( first );
+        list_a.erase( last );
+        EXPECT_ALLOCS_LE( list_a.push_back( 5 ); list_a.push_back( 6 ), 0 );
+        EXPECT_EQ( list_a, ( small4{ -1, 1, 2, 4, 5, 6 } ) );
+
+        // Heap nodes are relinked and inline ones moved, so both lists may go their own way afterwards.
+        sc::small_list<std::string, 2> list_c{ "a", "c", "e", "g" };
+        {
+            sc::small_list<std::string, 2> list_d{ "b", "d", "f" };
+            list_c.merge( list_d );
+            EXPECT_TRUE( list_d.empty() );
+            EXPECT_EQ( list_d.spilled(), 0 );
+        }
+        EXPECT_EQ( list_c, ( sc::small_list<std::string, 2>{ "a", "b", "c", "d", "e", "f", "g" } ) );
+        sc::small_list<std::string, 2> list_e{ "x", "y", "z" };
+        list_c.splice( list_c.cbegin(), list_e );
+        EXPECT_EQ( list_c.size(), 10 );
+        EXPECT_EQ( list_c.front(), std::string{ "x" } );
+        list_c = list_e;
+        EXPECT_TRUE( list_c.empty() );
+    };
+
+    SERIAL_TEST_CASE(tm6, "NodeCache", "lists on per-thread node pools may be built on one thread and destroyed on another.")
+    {
+        using cached = sc::list<int, sc::no_stats, sc::node_cache>;
+        cached list_a;
+        std::thread producer{ [&list_a] {
+            cached local;
+            for ( int i{0}; i < 1000; ++i )
+                local.push_back( i );
+            list_a.splice( list_a.cend(), local );
+        } };
+        producer.join();
+        EXPECT_EQ( list_a.size(), 1000 );
+        EXPECT_EQ( list_a.back(), 999 );
+
+        // The producer is gone; its nodes go back to its pool, for whichever thread adopts it.
+        cached list_b{ 1, 2, 3 };
+        list_b.splice( list_b.cend(), list_a );
+        EXPECT_EQ( list_b.size(), 1003 );
+        std::thread consumer{ [&list_b] {
+            cached gone;
+            gone.splice( gone.cend(), list_b );
+        } };
+        consumer.join();
+        EXPECT_TRUE( list_b.empty() );
+
+        // Nodes freed on this thread are reused without asking the global allocator.
+        { cached warm( 100 ); }
+        EXPECT_ALLOCS_LE( cached list_c( 100 ); list_c.sort(), 0 );
+        cached list_d{ 3, 1, 2 };
+        list_d.sort();
+        EXPECT_EQ( list_d, ( cached{ 1, 2, 3 } ) );
+    };
+
+    SERIAL_TEST_CASE(tm6, "ListQueue", "the consumer of a list queue takes everything pending as a list, without copies.")
+    {
+        sc::spsc_list_queue<std::string> spsc;
+        EXPECT_TRUE( spsc.empty() );
+        EXPECT_TRUE( spsc.pop_all().empty() );
+        spsc.push( "a" );
+        std::string b{ "b" };
+        spsc.push( std::move( b ) );
+        sc::list<std::string> batch{ "z" };
+        EXPECT_ALLOCS_LE( spsc.pop_all( batch ), 0 );
+        EXPECT_EQ( batch, ( sc::list<std::string>{ "z", "a", "b" } ) );
+        EXPECT_EQ( *std::prev( batch.end() ), std::string{ "b" } );
+        spsc.push( "c" );
+        EXPECT_EQ( spsc.pop_all(), ( sc::list<std::string>{ "c" } ) );
+        EXPECT_TRUE( spsc.empty() );
+
+        // Each producer's elements come out in the order it pushed them.
+        sc::mpsc_list_queue<int> mpsc;
+        const int per_thread{ 10000 };
+        std::vector<std::thread> producers;
+        for ( int p{0}; p < 3; ++p )
+            producers.emplace_back( [&mpsc, p, per_thread] {
+                for ( int i{0}; i < per_thread; ++i )
+                    mpsc.push( p * per_thread + i );
+            } );
+        std::vector<int> next{ 0, per_thread, 2 * per_thread };
+        bool in_order{ true };
+        size_t got{0};
+        sc::list<int> items;
+        while ( got < 3 * per_thread ) {
+            got += mpsc.pop_all( items );
+            for ( int v : items ) {
+                in_order = in_order and v == next[ v / per_thread ];
+                ++next[ v / per_thread ];
+            }
+            items.clear();
+            std::this_thread::yield();
+        }
+        for ( auto & t : producers )
+            t.join();
+        EXPECT_TRUE( in_order );
+        EXPECT_EQ( got, 3 * per_thread );
+        EXPECT_TRUE( mpsc.empty() );
+    };
+
+    SERIAL_TEST_CASE(tm6, "EpochReclaim", "erased nodes outlive the readers that may still hold them.")
+    {
+        using shared = sc::list<std::string, sc::no_stats, sc::epoch_nodes<>>;
+        shared list_a{ "a", "b", "c" };
+        {
+            sc::epoch::guard reading;
+            auto it = std::next( list_a.cbegin() );
+            list_a.erase( std::next( list_a.begin() ) );
+            for ( int i{0}; i < 4; ++i )
+                sc::epoch::collect();
+            EXPECT_GT( sc::epoch::pending(), 0u );
+            EXPECT_EQ( *it, std::string{ "b" } );
+            EXPECT_EQ( *++it, std::string{ "c" } );
+        }
+        for ( int i{0}; i < 4 and sc::epoch::pending() > 0; ++i )
+            sc::epoch::collect();
+        EXPECT_EQ( sc::epoch::pending(), 0 );
+        EXPECT_EQ( list_a, ( shared{ "a", "c" } ) );
+
+        // Readers walk the list while this thread edits it.
+        std::atomic<bool> stop{ false };
+        std::atomic<bool> consistent{ true };
+        std::vector<std::thread> readers;
+        for ( int r{0}; r < 2; ++r )
+            readers.emplace_back( [&] {
+                while ( not stop.load() ) {
+                    sc::epoch::guard g;
+                    for ( auto it = list_a.cbegin(); it != list_a.cend(); ++it )
+                        if ( it->size() != 1 )
+                            consistent = false;
+                }
+            } );
+        for ( int i{0}; i < 20000; ++i ) {
+            list_a.push_back( std::string( 1, char( 'a' + i % 26 ) ) );
+            list_a.insert( std::next( list_a.begin() ), "x" );
+            list_a.pop_front();
+            list_a.erase( std::next( list_a.begin() ) );
+        }
+        stop = true;
+        for ( auto & t : readers )
+            t.join();
+        EXPECT_TRUE( consistent );
+        EXPECT_EQ( list_a.size(), 2 );
+        for ( int i{0}; i < 4 and sc::epoch::pending() > 0; ++i )
+            sc::epoch::collect();
+        EXPECT_EQ( sc::epoch::pending(), 0 );
+    };
+
+    SERIAL_TEST_CASE(tm6, "PersistentList", "persistent list snapshots are O(1) and never see later changes.")
+    {
+        using plist = sc::persistent_list<std::string>;
+        plist v1{ "a", "b", "c", "d" };
+        plist v2;
+        EXPECT_ALLOCS_LE( v2 = v1, 0 );
+        EXPECT_TRUE( v2.shares_with( v1 ) );
+        EXPECT_EQ( v1, v2 );
+
+        // Path copying: the nodes before the change are copied, the ones after it shared.
+        EXPECT_ALLOCS_LE( v2.replace( std::next( v2.cbegin() ), "x" ), 2 );
+        EXPECT_EQ( &*std::next( v2.cbegin(), 2 ), &*std::next( v1.cbegin(), 2 ) );
+        auto it = v2.insert( v2.cend(), "e" );
+        EXPECT_EQ( *it, std::string{ "e" } );
+        v2.erase( v2.cbegin() );
+        v2.push_front( "z" );
+        v2.push_back( "f" );
+        EXPECT_EQ( v2, ( plist{ "z", "x", "c", "d", "e", "f" } ) );
+        EXPECT_EQ( v1, ( plist{ "a", "b", "c", "d" } ) );
+
+        // A snapshot outlives the version it was taken from, and is read on another thread.
+        plist snapshot = v1;
+        v1.clear();
+        v1.push_front( "new" );
+        std::string joined;
+        std::thread reader{ [snapshot, &joined] {
+            for ( const auto & s : snapshot )
+                joined += s;
+        } };
+        reader.join();
+        EXPECT_EQ( joined, std::string{ "abcd" } );
+        EXPECT_NO_LEAK( plist v3{ "p", "q" }; plist v4 = v3; v3.pop_front(); v4.pop_front(); v4.pop_front() );
+    };
+
+    TEST_CASE(tm6, "ListViews", "views over a list are lazy, compose with |, and never allocate.")
+    {
+        namespace views = sc::views;
+        sc::list<int> list_a{ 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 };
+        int calls{0};
+        auto pipeline = list_a | views::filter( []( int x ) { return x % 2 == 0; } )
+                               | views::transform( [&calls]( int x ) { ++calls; return x * x; } )
+                               | views::take( 3 );
+        EXPECT_EQ( calls, 0 );
+        std::vector<int> out;
+        out.reserve( 10 );
+        EXPECT_ALLOCS_LE( for ( int v : pipeline ) out.push_back( v ), 0 );
+        EXPECT_EQ( out, ( std::vector<int>{ 4, 16, 36 } ) );
+        EXPECT_EQ( calls, 3 ); // Only the elements taken were transformed.
+
+        // Views see the list as it is when they are iterated.
+        list_a.push_front( 0 );
+        EXPECT_EQ( *pipeline.begin(), 0 );
+
+        out.clear();
+        for ( int & v : list_a | views::drop( 8 ) )
+            out.push_back( v++ );
+        EXPECT_EQ( out, ( std::vector<int>{ 8, 9, 10 } ) );
+        EXPECT_EQ( list_a.back(), 11 );
+
+        // Chunks are sub-ranges of the list; the last one may be shorter.
+        std::vector<size_t> sizes;
+        for ( auto c : list_a | views::chunk( 4 ) )
+            sizes.push_back( std::distance( c.begin(), c.end() ) );
+        EXPECT_EQ( sizes, ( std::vector<size_t>{ 4, 4, 3 } ) );
+
+        // Zip stops at the shorter range, and refers to the elements of both.
+        const sc::list<std::string> names{ "a", "b", "c" };
+        std::string joined;
+        for ( auto p : list_a | views::zip( names ) )
+            joined += p.second + std::to_string( p.first );
+        EXPECT_EQ( joined, std::string{ "a0b1c2" } );
+        for ( auto p : views::zip( list_a, names | views::take( 1 ) ) )
+            p.first = -1;
+        EXPECT_EQ( list_a.front(), -1 );
+        auto none = names | views::filter( []( const std::string & s ) { return s == "z"; } );
+        EXPECT_EQ( none.begin(), none.end() );
+    };
+
+    std::cout << std::endl;
+    run( tm6 );
+    tm6.summary();
+
+    return ( tm.all_passed() and tm2.all_passed() and tm3.all_passed() and tm4.all_passed() and tm5.all_passed()
+             and tm6.all_passed() ) ? EXIT_SUCCESS : EXIT_FAILURE;
 }
     